@@ -12,7 +12,9 @@
 #include <string>
 
 #include "knowhere/archive/KnowhereConfig.h"
+#include "knowhere/common/Exception.h"
 #include "knowhere/common/Log.h"
+#include "knowhere/common/ThreadPool.h"
 
 #ifdef __linux__
 #include "knowhere/index/vector_index/Statistics.h"
@@ -20,6 +22,7 @@
 #include "faiss/Clustering.h"
 #include "faiss/FaissHook.h"
 #include "faiss/common.h"
+#include "faiss/utils/PayloadMemory.h"
 #include "faiss/utils/distances.h"
 #include "faiss/utils/utils.h"
 #endif
@@ -122,6 +125,39 @@ KnowhereConfig::SetStatisticsLevel(const int64_t stat_level) {
 #endif
 }
 
+void
+KnowhereConfig::SetPayloadMemory(const HugePageType huge_page_type, const int64_t numa_node) {
+#ifdef __APPLE__
+    // do nothing
+#elif __linux__
+    auto policy = faiss::get_payload_memory_policy();
+    switch (huge_page_type) {
+        case HugePageType::NONE:
+        default:
+            policy.huge_pages = faiss::HugePageMode::NONE;
+            break;
+        case HugePageType::TRANSPARENT:
+            policy.huge_pages = faiss::HugePageMode::TRANSPARENT;
+            break;
+        case HugePageType::EXPLICIT:
+            policy.huge_pages = faiss::HugePageMode::EXPLICIT;
+            break;
+    }
+    policy.numa_node = static_cast<int>(numa_node);
+    faiss::set_payload_memory_policy(policy);
+#else
+    KNOWHERE_THROW_MSG("Unsupported SetPayloadMemory on current platform!");
+#endif
+}
+
+void
+KnowhereConfig::SetQueryThreadPoolSize(const int64_t thread_num) {
+    if (thread_num <= 0) {
+        KNOWHERE_THROW_MSG("query thread pool size must be positive");
+    }
+    knowhere::ThreadPool::InitGlobalThreadPool(static_cast<size_t>(thread_num));
+}
+
 void
 KnowhereConfig::SetLogHandler() {
 #ifdef __APPLE__
@@ -68,6 +68,34 @@ class KnowhereConfig {
     static void
     SetStatisticsLevel(const int64_t stat_level);
 
+    /**
+     * set huge page type of the index payloads
+     */
+    enum HugePageType {
+        NONE,         // plain pages (default)
+        TRANSPARENT,  // advise transparent huge pages
+        EXPLICIT,     // reserved huge pages (hugetlbfs pool), transparent ones as fallback
+    };
+
+    /**
+     * Set memory placement of the index payloads (HNSW level0, IDMAP vectors, IVF codes, IVF_NM/NSG_NM/HNSW_NM
+     * raw vectors)
+     *   huge_page_type: page size requested for payloads of at least 2MB
+     *   numa_node: bind the payloads to this NUMA node, -1 means no binding
+     *   Applies to payloads allocated afterwards, VecIndex::GetPayloadPlacement reports the result. An IVF list
+     *   smaller than 2MB stays on the heap and is placed by first touch.
+     */
+    static void
+    SetPayloadMemory(const HugePageType huge_page_type, const int64_t numa_node = -1);
+
+    /**
+     * Set the number of threads running VecIndex::QueryAsync, hardware concurrency by default
+     *   Each query runs on one of these threads with OpenMP limited to that thread, so the pool size
+     *   bounds the cores used by asynchronous queries. Not to be called from a QueryAsync callback
+     */
+    static void
+    SetQueryThreadPoolSize(const int64_t thread_num);
+
     // todo: add log level?
     /**
      * set Log handler
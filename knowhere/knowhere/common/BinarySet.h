@@ -12,6 +12,7 @@
 #pragma once
 
 #include <string.h>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -24,9 +25,14 @@ namespace knowhere {
 struct Binary {
     std::shared_ptr<uint8_t[]> data;
     int64_t size = 0;
+    // data points into a read-only file mapping, Load() may reference it in place instead of copying
+    bool mapped = false;
 };
 using BinaryPtr = std::shared_ptr<Binary>;
 
+// receives the binaries of a serialized index one at a time, see Index::SerializeTo()
+using BinarySink = std::function<void(const std::string& name, const BinaryPtr& binary)>;
+
 inline uint8_t*
 CopyBinary(const BinaryPtr& bin) {
     uint8_t* newdata = new uint8_t[bin->size];
@@ -54,6 +60,12 @@ class BinarySet {
         binary_map_[name] = std::move(binary);
     }
 
+    // sink appending every binary it receives to this set
+    BinarySink
+    AppendSink() {
+        return [this](const std::string& name, const BinaryPtr& binary) { Append(name, binary); };
+    }
+
     // void
     // Append(const std::string &name, void *data, int64_t size, ID id) {
     //    Binary binary;
@@ -71,5 +71,26 @@ class Dataset {
 };
 using DatasetPtr = std::shared_ptr<Dataset>;
 
+// Typed view of the data of one request for the hot path. It is immutable once constructed, takes
+// no lock, owns nothing and erases no type, so it can be built on the stack for every call.
+// ids, distances and lims are optional, a query result is described by ids and distances.
+struct DatasetView {
+    DatasetView(int64_t rows,
+                int64_t dim,
+                const void* tensor,
+                int64_t* ids = nullptr,
+                float* distances = nullptr,
+                const size_t* lims = nullptr)
+        : rows(rows), dim(dim), tensor(tensor), ids(ids), distances(distances), lims(lims) {
+    }
+
+    const int64_t rows;
+    const int64_t dim;
+    const void* const tensor;
+    int64_t* const ids;
+    float* const distances;
+    const size_t* const lims;
+};
+
 }  // namespace knowhere
 }  // namespace milvus
@@ -0,0 +1,149 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "knowhere/common/ThreadPool.h"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <exception>
+
+#include "knowhere/common/Exception.h"
+#include "knowhere/common/Log.h"
+
+namespace milvus {
+namespace knowhere {
+
+namespace {
+
+// pool and queue of the calling worker thread
+thread_local const ThreadPool* tls_pool = nullptr;
+thread_local size_t tls_queue = 0;
+
+std::mutex global_pool_mutex;
+std::shared_ptr<ThreadPool> global_pool;
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    num_threads = std::max(num_threads, static_cast<size_t>(1));
+    for (size_t i = 0; i < num_threads; ++i) {
+        queues_.emplace_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.emplace_back([this, i]() { Work(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void
+ThreadPool::Enqueue(Task task) {
+    size_t index = (tls_pool == this) ? tls_queue : next_queue_++ % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        ++pending_;
+    }
+    wake_.notify_one();
+}
+
+bool
+ThreadPool::TryPop(size_t index, Task& task) {
+    {
+        auto& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues_.size(); ++i) {
+        auto& victim = *queues_[(index + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+ThreadPool::Work(size_t index) {
+    tls_pool = this;
+    tls_queue = index;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+            if (pending_ == 0) {
+                return;  // stopped and drained
+            }
+            --pending_;
+        }
+        // a task is queued for every claimed count, it may just not be visible yet in its queue
+        Task task;
+        while (!TryPop(index, task)) {
+            std::this_thread::yield();
+        }
+        // a query runs on one core, parallelism comes from running several of them. Set again for every
+        // task as the previous one may have changed it
+        omp_set_num_threads(1);
+        try {
+            task();
+        } catch (std::exception& e) {
+            LOG_KNOWHERE_ERROR_ << "ThreadPool task failed: " << e.what();
+        }
+    }
+}
+
+std::shared_ptr<ThreadPool>
+ThreadPool::GetGlobalThreadPool() {
+    std::lock_guard<std::mutex> lock(global_pool_mutex);
+    if (global_pool == nullptr) {
+        global_pool = std::make_shared<ThreadPool>(std::thread::hardware_concurrency());
+    }
+    return global_pool;
+}
+
+void
+ThreadPool::InitGlobalThreadPool(size_t num_threads) {
+    // the old pool joins its workers, which can't be done from one of them
+    if (tls_pool != nullptr) {
+        KNOWHERE_THROW_MSG("the global thread pool can't be replaced from a pool thread");
+    }
+    std::shared_ptr<ThreadPool> old_pool;
+    {
+        std::lock_guard<std::mutex> lock(global_pool_mutex);
+        old_pool = global_pool;
+        global_pool = std::make_shared<ThreadPool>(num_threads);
+    }
+    // old_pool drains and joins here unless a caller still holds it
+}
+
+}  // namespace knowhere
+}  // namespace milvus
@@ -0,0 +1,99 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace milvus {
+namespace knowhere {
+
+// Fixed-size work-stealing pool running the asynchronous queries. Every worker has its own task queue,
+// tasks submitted from a worker go to that worker's queue and idle workers steal from the others.
+// Workers run every task with OpenMP limited to one thread, so the pool size bounds the cores used by
+// the queries it runs, however many of them are in flight.
+class ThreadPool {
+ public:
+    explicit ThreadPool(size_t num_threads);
+
+    // runs the tasks still queued, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool&
+    operator=(const ThreadPool&) = delete;
+
+    template <typename Func>
+    auto
+    Push(Func&& func) -> std::future<decltype(func())> {
+        using ReturnType = decltype(func());
+        auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<Func>(func));
+        auto future = task->get_future();
+        Enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    size_t
+    Size() const {
+        return queues_.size();
+    }
+
+    // pool used by VecIndex::QueryAsync, hardware_concurrency threads unless set otherwise
+    static std::shared_ptr<ThreadPool>
+    GetGlobalThreadPool();
+
+    // replace the global pool, queries already submitted finish on the old one. Throws when called from a
+    // pool thread, e.g. from a QueryAsync callback
+    static void
+    InitGlobalThreadPool(size_t num_threads);
+
+ private:
+    using Task = std::function<void()>;
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void
+    Enqueue(Task task);
+
+    void
+    Work(size_t index);
+
+    // own queue from the back, the others from the front
+    bool
+    TryPop(size_t index, Task& task);
+
+ private:
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_queue_{0};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    size_t pending_ = 0;  // queued tasks, guarded by wake_mutex_
+    bool stop_ = false;
+};
+
+using ThreadPoolPtr = std::shared_ptr<ThreadPool>;
+
+}  // namespace knowhere
+}  // namespace milvus
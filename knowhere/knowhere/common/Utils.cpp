@@ -9,7 +9,12 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <algorithm>
+#include <cstdio>
 #include <memory>
 #include <vector>
 
@@ -26,6 +31,12 @@ static const char* NAME = "name";
 static const char* SLICE_NUM = "slice_num";
 static const char* TOTAL_LEN = "total_len";
 
+// binary set file layout:
+//   magic | version | count | count * (name_len | name | offset | size) | aligned payloads
+static const uint32_t BINARY_SET_FILE_MAGIC = 0x424e574b;  // "KWNB"
+static const uint32_t BINARY_SET_FILE_VERSION = 1;
+static const int64_t BINARY_SET_FILE_ALIGN = 64;
+
 void
 Slice(const std::string& prefix,
       const BinaryPtr& data_src,
@@ -50,6 +61,30 @@ Slice(const std::string& prefix,
     ret[TOTAL_LEN] = data_src->size;
 }
 
+void
+AppendSliceMeta(milvus::json& meta_info, const std::string& name, int slice_num, int64_t total_len) {
+    milvus::json slice_i;
+    slice_i[NAME] = name;
+    slice_i[SLICE_NUM] = slice_num;
+    slice_i[TOTAL_LEN] = total_len;
+    meta_info[META].emplace_back(slice_i);
+}
+
+void
+EmitSliceMeta(const milvus::json& meta_info, const BinarySink& sink) {
+    if (!meta_info.contains(META)) {
+        return;
+    }
+    auto meta_str = meta_info.dump();
+    std::shared_ptr<uint8_t[]> meta_data(new uint8_t[meta_str.length() + 1], std::default_delete<uint8_t[]>());
+    memcpy(meta_data.get(), meta_str.data(), meta_str.length());
+    meta_data.get()[meta_str.length()] = 0;
+    auto binary = std::make_shared<Binary>();
+    binary->data = meta_data;
+    binary->size = meta_str.length() + 1;
+    sink(INDEX_FILE_SLICE_META, binary);
+}
+
 void
 Assemble(BinarySet& binarySet) {
     auto slice_meta = binarySet.Erase(INDEX_FILE_SLICE_META);
@@ -99,12 +134,125 @@ Disassemble(const int64_t& slice_size_in_byte, BinarySet& binarySet) {
         meta_info[META].emplace_back(slice_i);
     }
     if (!slice_key_list.empty()) {
-        auto meta_str = meta_info.dump();
-        std::shared_ptr<uint8_t[]> meta_data(new uint8_t[meta_str.length() + 1], std::default_delete<uint8_t[]>());
-        memcpy(meta_data.get(), meta_str.data(), meta_str.length());
-        meta_data.get()[meta_str.length()] = 0;
-        binarySet.Append(INDEX_FILE_SLICE_META, meta_data, meta_str.length() + 1);
+        EmitSliceMeta(meta_info, binarySet.AppendSink());
+    }
+}
+
+void
+WriteBinarySet(const std::string& path, const BinarySet& binarySet) {
+    auto align = [](int64_t off) {
+        return (off + BINARY_SET_FILE_ALIGN - 1) / BINARY_SET_FILE_ALIGN * BINARY_SET_FILE_ALIGN;
+    };
+
+    int64_t header_size = sizeof(uint32_t) * 2 + sizeof(int64_t);
+    for (auto& kv : binarySet.binary_map_) {
+        header_size += sizeof(int64_t) * 3 + kv.first.size();
+    }
+
+    std::vector<int64_t> offsets;
+    int64_t offset = align(header_size);
+    for (auto& kv : binarySet.binary_map_) {
+        offsets.push_back(offset);
+        offset = align(offset + kv.second->size);
+    }
+
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (fp == nullptr) {
+        KNOWHERE_THROW_MSG("could not open " + path + " for writing");
+    }
+    std::unique_ptr<FILE, decltype(&fclose)> guard(fp, &fclose);
+
+    auto write = [&](const void* ptr, size_t size) {
+        if (size > 0 && fwrite(ptr, 1, size, fp) != size) {
+            KNOWHERE_THROW_MSG("failed to write " + path);
+        }
+    };
+
+    int64_t count = binarySet.binary_map_.size();
+    write(&BINARY_SET_FILE_MAGIC, sizeof(uint32_t));
+    write(&BINARY_SET_FILE_VERSION, sizeof(uint32_t));
+    write(&count, sizeof(int64_t));
+    size_t i = 0;
+    for (auto& kv : binarySet.binary_map_) {
+        int64_t name_len = kv.first.size();
+        write(&name_len, sizeof(int64_t));
+        write(kv.first.data(), name_len);
+        write(&offsets[i++], sizeof(int64_t));
+        write(&kv.second->size, sizeof(int64_t));
+    }
+
+    std::vector<uint8_t> padding(BINARY_SET_FILE_ALIGN, 0);
+    int64_t pos = header_size;
+    i = 0;
+    for (auto& kv : binarySet.binary_map_) {
+        write(padding.data(), offsets[i] - pos);
+        write(kv.second->data.get(), kv.second->size);
+        pos = offsets[i++] + kv.second->size;
+    }
+    write(padding.data(), align(pos) - pos);
+}
+
+BinarySet
+MapBinarySet(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        KNOWHERE_THROW_MSG("could not open " + path + " for reading");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        KNOWHERE_THROW_MSG("could not stat " + path);
+    }
+    size_t file_size = st.st_size;
+    void* addr = file_size > 0 ? mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (addr == MAP_FAILED) {
+        KNOWHERE_THROW_MSG("could not map " + path);
+    }
+
+    auto base = static_cast<uint8_t*>(addr);
+    std::shared_ptr<uint8_t[]> mapping(base, [file_size](uint8_t* p) { munmap(p, file_size); });
+
+    size_t pos = 0;
+    auto read = [&](void* ptr, size_t size) {
+        if (file_size - pos < size) {
+            KNOWHERE_THROW_MSG("truncated binary set file " + path);
+        }
+        memcpy(ptr, base + pos, size);
+        pos += size;
+    };
+
+    uint32_t magic = 0, version = 0;
+    int64_t count = 0;
+    read(&magic, sizeof(uint32_t));
+    read(&version, sizeof(uint32_t));
+    if (magic != BINARY_SET_FILE_MAGIC || version != BINARY_SET_FILE_VERSION) {
+        KNOWHERE_THROW_MSG(path + " is not a binary set file");
+    }
+    read(&count, sizeof(int64_t));
+
+    BinarySet binarySet;
+    for (int64_t i = 0; i < count; ++i) {
+        int64_t name_len = 0, offset = 0, size = 0;
+        read(&name_len, sizeof(int64_t));
+        if (name_len < 0 || file_size - pos < static_cast<size_t>(name_len)) {
+            KNOWHERE_THROW_MSG("truncated binary set file " + path);
+        }
+        std::string name(reinterpret_cast<char*>(base + pos), name_len);
+        pos += name_len;
+        read(&offset, sizeof(int64_t));
+        read(&size, sizeof(int64_t));
+        if (offset < 0 || size < 0 || static_cast<size_t>(offset + size) > file_size) {
+            KNOWHERE_THROW_MSG("corrupted binary set file " + path);
+        }
+
+        auto binary = std::make_shared<Binary>();
+        binary->data = std::shared_ptr<uint8_t[]>(mapping, base + offset);
+        binary->size = size;
+        binary->mapped = true;
+        binarySet.Append(name, binary);
     }
+    return binarySet;
 }
 
 }  // namespace knowhere
@@ -28,5 +28,24 @@ Assemble(BinarySet& binarySet);
 void
 Disassemble(const int64_t& slice_size_in_byte, BinarySet& binarySet);
 
+// Record in meta_info that the binary name was written as slice_num slices named <name>_<i>
+void
+AppendSliceMeta(milvus::json& meta_info, const std::string& name, int slice_num, int64_t total_len);
+
+// Hand meta_info over to sink as the INDEX_FILE_SLICE_META binary read by Assemble(), if any slice was recorded
+void
+EmitSliceMeta(const milvus::json& meta_info, const BinarySink& sink);
+
+// Write every binary of the set into a single file at path, payloads are aligned so that
+// they can later be referenced in place from a mapping of the file.
+void
+WriteBinarySet(const std::string& path, const BinarySet& binarySet);
+
+// Map a file written by WriteBinarySet read-only into memory and return a set whose binaries
+// point into the mapping (Binary::mapped is set). The mapping is released once the last
+// binary referencing it is gone, so indexes loaded from it keep it alive as long as needed.
+BinarySet
+MapBinarySet(const std::string& path);
+
 }  // namespace knowhere
 }  // namespace milvus
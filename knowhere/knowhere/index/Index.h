@@ -25,6 +25,17 @@ class Index : public milvus::cache::DataObj {
     virtual BinarySet
     Serialize(const Config& config) = 0;
 
+    // Hand the serialized binaries to sink instead of returning them. Indexes that support it
+    // stream their slices (INDEX_FILE_SLICE_SIZE_IN_MEGABYTE) to sink as soon as each one is
+    // written, without ever holding the whole serialized index in memory.
+    virtual void
+    SerializeTo(const Config& config, const BinarySink& sink) {
+        auto binary_set = Serialize(config);
+        for (auto& kv : binary_set.binary_map_) {
+            sink(kv.first, kv.second);
+        }
+    }
+
     virtual void
     Load(const BinarySet&) = 0;
 };
@@ -52,6 +52,7 @@ extern const char* INVALID;
 extern const char* INDEX_FAISS_IDMAP;
 extern const char* INDEX_FAISS_IVFFLAT;
 extern const char* INDEX_FAISS_IVFPQ;
+extern const char* INDEX_FAISS_IVFPQFASTSCAN;
 extern const char* INDEX_FAISS_IVFSQ8;
 extern const char* INDEX_FAISS_IVFSQ8H;
 extern const char* INDEX_FAISS_IVFHNSW;
@@ -63,6 +64,7 @@ extern const char* INDEX_SPTAG_KDT_RNT;
 extern const char* INDEX_SPTAG_BKT_RNT;
 #endif
 extern const char* INDEX_HNSW;
+extern const char* INDEX_HNSW_NM;
 extern const char* INDEX_RHNSWFlat;
 extern const char* INDEX_RHNSWPQ;
 extern const char* INDEX_RHNSWSQ;
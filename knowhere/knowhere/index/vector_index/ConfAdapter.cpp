@@ -28,6 +28,11 @@ namespace knowhere {
 static const int64_t MIN_NBITS = 1;
 static const int64_t MAX_NBITS = 16;
 static const int64_t DEFAULT_NBITS = 8;
+static const int64_t FASTSCAN_NBITS = 4;
+static const int64_t MIN_REFINE_K = 1;
+static const int64_t MAX_REFINE_K = 1024;
+static const float MIN_PRUNE_RATIO = 0.0;
+static const float MAX_PRUNE_RATIO = 1.0;
 static const int64_t MIN_NLIST = 1;
 static const int64_t MAX_NLIST = 65536;
 static const int64_t MIN_NPROBE = 1;
@@ -41,7 +46,16 @@ static const int64_t HNSW_MAX_EFCONSTRUCTION = 512;
 static const int64_t HNSW_MIN_M = 4;
 static const int64_t HNSW_MAX_M = 64;
 static const int64_t HNSW_MAX_EF = 32768;
+static const int64_t HNSW_MIN_INTRA_QUERY_THREADS = 1;
+static const int64_t HNSW_MAX_INTRA_QUERY_THREADS = 256;
 static const std::vector<std::string> METRICS{knowhere::Metric::L2, knowhere::Metric::IP};
+static const std::vector<std::string> HNSW_SQ_TYPES{knowhere::SQType::QT_8BIT, knowhere::SQType::QT_FP16};
+static const std::vector<std::string> SQ_TYPES{knowhere::SQType::QT_8BIT, knowhere::SQType::QT_8BIT_UNIFORM,
+                                               knowhere::SQType::QT_6BIT, knowhere::SQType::QT_4BIT,
+                                               knowhere::SQType::QT_FP16, knowhere::SQType::QT_BF16};
+static const std::vector<std::string> COARSE_QUANTIZER_TYPES{knowhere::CoarseQuantizerType::FLAT,
+                                                             knowhere::CoarseQuantizerType::HNSW,
+                                                             knowhere::CoarseQuantizerType::IVF};
 
 #define CheckIntByRange(key, min, max)                                                                   \
     if (!oricfg.contains(key) || !oricfg[key].is_number_integer() || oricfg[key].get<int64_t>() > max || \
@@ -124,6 +138,20 @@ bool
 IVFConfAdapter::CheckTrain(Config& oricfg, const IndexMode mode) {
     CheckIntByRange(knowhere::IndexParams::nlist, MIN_NLIST, MAX_NLIST);
 
+    // optional, flat when absent
+    if (oricfg.contains(knowhere::IndexParams::coarse_quantizer)) {
+        CheckStrByValues(knowhere::IndexParams::coarse_quantizer, COARSE_QUANTIZER_TYPES);
+    }
+    if (oricfg.contains(knowhere::IndexParams::coarse_nlist)) {
+        CheckIntByRange(knowhere::IndexParams::coarse_nlist, MIN_NLIST, MAX_NLIST);
+    }
+    if (oricfg.contains(knowhere::IndexParams::M)) {
+        CheckIntByRange(knowhere::IndexParams::M, HNSW_MIN_M, HNSW_MAX_M);
+    }
+    if (oricfg.contains(knowhere::IndexParams::efConstruction)) {
+        CheckIntByRange(knowhere::IndexParams::efConstruction, HNSW_MIN_EFCONSTRUCTION, HNSW_MAX_EFCONSTRUCTION);
+    }
+
     // auto tune params
     auto rows = oricfg[knowhere::meta::ROWS].get<int64_t>();
     auto nlist = oricfg[knowhere::IndexParams::nlist].get<int64_t>();
@@ -142,12 +170,34 @@ IVFConfAdapter::CheckSearch(Config& oricfg, const IndexType type, const IndexMod
 #endif
     CheckIntByRange(knowhere::IndexParams::nprobe, MIN_NPROBE, max_nprobe);
 
+    // optional, candidates re-scored exactly per result
+    if (oricfg.contains(knowhere::IndexParams::refine_k)) {
+        CheckIntByRange(knowhere::IndexParams::refine_k, MIN_REFINE_K, MAX_REFINE_K);
+    }
+
+    // optional, skips probed lists that cannot improve the results
+    if (oricfg.contains(knowhere::IndexParams::prune_ratio)) {
+        CheckFloatByRange(knowhere::IndexParams::prune_ratio, MIN_PRUNE_RATIO, MAX_PRUNE_RATIO);
+    }
+
+    // optional, searches of an HNSW or IVF coarse quantizer
+    if (oricfg.contains(knowhere::IndexParams::ef)) {
+        CheckIntByRange(knowhere::IndexParams::ef, oricfg[knowhere::IndexParams::nprobe], HNSW_MAX_EF);
+    }
+    if (oricfg.contains(knowhere::IndexParams::coarse_nprobe)) {
+        CheckIntByRange(knowhere::IndexParams::coarse_nprobe, MIN_NPROBE, MAX_NPROBE);
+    }
+
     return ConfAdapter::CheckSearch(oricfg, type, mode);
 }
 
 bool
 IVFSQConfAdapter::CheckTrain(Config& oricfg, const IndexMode mode) {
     oricfg[knowhere::IndexParams::nbits] = DEFAULT_NBITS;
+    // optional, QT_8bit when absent
+    if (oricfg.contains(knowhere::IndexParams::quantizer_type)) {
+        CheckStrByValues(knowhere::IndexParams::quantizer_type, SQ_TYPES);
+    }
     return IVFConfAdapter::CheckTrain(oricfg, mode);
 }
 
@@ -210,6 +260,20 @@ IVFPQConfAdapter::CheckCPUPQParams(int64_t dimension, int64_t m) {
     return (dimension % m == 0);
 }
 
+bool
+IVFPQFastScanConfAdapter::CheckTrain(Config& oricfg, const IndexMode mode) {
+    if (!IVFConfAdapter::CheckTrain(oricfg, mode)) {
+        return false;
+    }
+
+    // 16 centroids per sub-quantizer, so the tables fit in a SIMD register
+    oricfg[knowhere::IndexParams::nbits] = FASTSCAN_NBITS;
+
+    auto m = oricfg[knowhere::IndexParams::m].get<int64_t>();
+    auto dimension = oricfg[knowhere::meta::DIM].get<int64_t>();
+    return IVFPQConfAdapter::CheckCPUPQParams(dimension, m);
+}
+
 bool
 IVFHNSWConfAdapter::CheckTrain(Config& oricfg, const IndexMode mode) {
     // HNSW param check
@@ -278,6 +342,10 @@ bool
 HNSWConfAdapter::CheckTrain(Config& oricfg, const IndexMode mode) {
     CheckIntByRange(knowhere::IndexParams::efConstruction, HNSW_MIN_EFCONSTRUCTION, HNSW_MAX_EFCONSTRUCTION);
     CheckIntByRange(knowhere::IndexParams::M, HNSW_MIN_M, HNSW_MAX_M);
+    // optional, full float vectors in level0 when absent
+    if (oricfg.contains(knowhere::IndexParams::quantizer_type)) {
+        CheckStrByValues(knowhere::IndexParams::quantizer_type, HNSW_SQ_TYPES);
+    }
 
     return ConfAdapter::CheckTrain(oricfg, mode);
 }
@@ -285,6 +353,11 @@ HNSWConfAdapter::CheckTrain(Config& oricfg, const IndexMode mode) {
 bool
 HNSWConfAdapter::CheckSearch(Config& oricfg, const IndexType type, const IndexMode mode) {
     CheckIntByRange(knowhere::IndexParams::ef, oricfg[knowhere::meta::TOPK], HNSW_MAX_EF);
+    // optional, each query runs on a single thread when absent
+    if (oricfg.contains(knowhere::IndexParams::intra_query_threads)) {
+        CheckIntByRange(knowhere::IndexParams::intra_query_threads, HNSW_MIN_INTRA_QUERY_THREADS,
+                        HNSW_MAX_INTRA_QUERY_THREADS);
+    }
 
     return ConfAdapter::CheckSearch(oricfg, type, mode);
 }
@@ -45,8 +45,10 @@ FaissBaseIndex::LoadImpl(const BinarySet& binary_set, const IndexType& type) {
     reader.total = binary->size;
     reader.data_ = binary->data.get();
 
-    faiss::Index* index = faiss::read_index(&reader);
+    // a mapped binary lets inverted lists be referenced in place instead of copied
+    faiss::Index* index = faiss::read_index(&reader, binary->mapped ? faiss::IO_FLAG_MMAP : 0);
     index_.reset(index);
+    mapped_binary_ = binary->mapped ? binary : nullptr;
 
     SealImpl();
 }
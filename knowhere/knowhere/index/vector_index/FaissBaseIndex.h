@@ -38,6 +38,10 @@ class FaissBaseIndex {
 
  public:
     std::shared_ptr<faiss::Index> index_ = nullptr;
+
+ protected:
+    // keeps a mapped binary alive while index_ references its inverted lists in place
+    BinaryPtr mapped_binary_ = nullptr;
 };
 
 }  // namespace knowhere
@@ -75,11 +75,13 @@ IndexAnnoy::Load(const BinarySet& index_binary) {
 
     auto index_data = index_binary.GetByName("annoy_index_data");
     char* p = nullptr;
-    if (!index_->load_index(reinterpret_cast<void*>(index_data->data.get()), index_data->size, &p)) {
+    if (!index_->load_index(reinterpret_cast<void*>(index_data->data.get()), index_data->size, &p,
+                            index_data->mapped)) {
         std::string error_msg(p);
         free(p);
         KNOWHERE_THROW_MSG(error_msg);
     }
+    mapped_binary_ = index_data->mapped ? index_data : nullptr;
 }
 
 void
@@ -110,16 +112,23 @@ IndexAnnoy::BuildAll(const DatasetPtr& dataset_ptr, const Config& config) {
 
 DatasetPtr
 IndexAnnoy::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+    return QueryIntoDataset(dataset_ptr, config, bitset);
+}
+
+void
+IndexAnnoy::QueryInto(const float* query,
+                      int64_t rows,
+                      int64_t k,
+                      float* p_dist,
+                      int64_t* p_id,
+                      const Config& config,
+                      const faiss::BitsetView bitset) {
     if (!index_) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
 
-    GET_TENSOR_DATA_DIM(dataset_ptr)
-    auto k = config[meta::TOPK].get<int64_t>();
+    auto dim = Dim();
     auto search_k = config[IndexParams::search_k].get<int64_t>();
-    auto all_num = rows * k;
-    auto p_id = static_cast<int64_t*>(malloc(all_num * sizeof(int64_t)));
-    auto p_dist = static_cast<float*>(malloc(all_num * sizeof(float)));
 
 #pragma omp parallel for
     for (unsigned int i = 0; i < rows; ++i) {
@@ -127,8 +136,7 @@ IndexAnnoy::Query(const DatasetPtr& dataset_ptr, const Config& config, const fai
         result.reserve(k);
         std::vector<float> distances;
         distances.reserve(k);
-        index_->get_nns_by_vector(static_cast<const float*>(p_data) + i * dim, k, search_k, &result, &distances,
-                                  bitset);
+        index_->get_nns_by_vector(query + i * dim, k, search_k, &result, &distances, bitset);
 
         size_t result_num = result.size();
         auto local_p_id = p_id + k * i;
@@ -143,11 +151,6 @@ IndexAnnoy::Query(const DatasetPtr& dataset_ptr, const Config& config, const fai
             local_p_dist[result_num] = 1.0 / 0.0;
         }
     }
-
-    auto ret_ds = std::make_shared<Dataset>();
-    ret_ds->Set(meta::IDS, p_id);
-    ret_ds->Set(meta::DISTANCE, p_dist);
-    return ret_ds;
 }
 
 int64_t
@@ -34,6 +34,11 @@ class IndexAnnoy : public VecIndex {
     void
     Load(const BinarySet& index_binary) override;
 
+    using VecIndex::BuildAll;
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
     void
     BuildAll(const DatasetPtr& dataset_ptr, const Config& config) override;
 
@@ -50,6 +55,15 @@ class IndexAnnoy : public VecIndex {
     DatasetPtr
     Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) override;
 
+    void
+    QueryInto(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset) override;
+
     int64_t
     Count() override;
 
@@ -62,6 +76,8 @@ class IndexAnnoy : public VecIndex {
  private:
     MetricType metric_type_;
     std::shared_ptr<AnnoyIndexInterface<int64_t, float>> index_ = nullptr;
+    // keeps a mapped binary alive while index_ references its nodes in place
+    BinaryPtr mapped_binary_ = nullptr;
 };
 
 }  // namespace knowhere
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <exception>
 #include <queue>
 #include <string>
 #include <utility>
@@ -26,6 +27,8 @@
 #include "knowhere/common/Log.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
 #include "knowhere/index/vector_index/helpers/FaissIO.h"
+#include "knowhere/index/vector_index/helpers/FilteredSearch.h"
+#include "knowhere/index/vector_index/helpers/IndexParameter.h"
 
 namespace milvus {
 namespace knowhere {
@@ -44,6 +47,12 @@ IndexHNSW::Serialize(const Config& config) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
 
+    if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
+        BinarySet res_set;
+        SerializeTo(config, res_set.AppendSink());
+        return res_set;
+    }
+
     try {
         MemoryIOWriter writer;
         index_->saveIndex(writer);
@@ -51,8 +60,11 @@ IndexHNSW::Serialize(const Config& config) {
 
         BinarySet res_set;
         res_set.Append("HNSW", data, writer.rp);
-        if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
-            Disassemble(config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024, res_set);
+        if (index_->raw_data_ != nullptr) {
+            MemoryIOWriter raw_writer;
+            index_->saveCodec(raw_writer);
+            std::shared_ptr<uint8_t[]> raw_data(raw_writer.data_);
+            res_set.Append(HNSW_RAW_DATA, raw_data, raw_writer.rp);
         }
         return res_set;
     } catch (std::exception& e) {
@@ -60,6 +72,33 @@ IndexHNSW::Serialize(const Config& config) {
     }
 }
 
+void
+IndexHNSW::SerializeTo(const Config& config, const BinarySink& sink) {
+    if (!config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
+        VecIndex::SerializeTo(config, sink);
+        return;
+    }
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
+
+    try {
+        milvus::json meta_info;
+        auto slice_size = config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024;
+        SliceIOWriter writer("HNSW", slice_size, sink);
+        index_->saveIndex(writer);
+        writer.Close(meta_info);
+        if (index_->raw_data_ != nullptr) {
+            SliceIOWriter raw_writer(HNSW_RAW_DATA, slice_size, sink);
+            index_->saveCodec(raw_writer);
+            raw_writer.Close(meta_info);
+        }
+        EmitSliceMeta(meta_info, sink);
+    } catch (std::exception& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+}
+
 void
 IndexHNSW::Load(const BinarySet& index_binary) {
     try {
@@ -73,7 +112,19 @@ IndexHNSW::Load(const BinarySet& index_binary) {
         hnswlib::SpaceInterface<float>* space = nullptr;
         index_ = std::make_shared<hnswlib::HierarchicalNSW<float>>(space);
         index_->stats_enable = (STATISTICS_LEVEL >= 3);
-        index_->loadIndex(reader);
+        index_->loadIndex(reader, 0, binary->mapped);
+        mapped_binary_ = binary->mapped ? binary : nullptr;
+        mapped_raw_binary_ = nullptr;
+        if (index_binary.Contains(HNSW_RAW_DATA)) {
+            auto raw_binary = index_binary.GetByName(HNSW_RAW_DATA);
+            MemoryIOReader raw_reader;
+            raw_reader.total = raw_binary->size;
+            raw_reader.data_ = raw_binary->data.get();
+            index_->loadCodec(raw_reader, raw_binary->mapped);
+            mapped_raw_binary_ = raw_binary->mapped ? raw_binary : nullptr;
+        } else if (index_->data_size_ != Dim() * sizeof(float)) {
+            KNOWHERE_THROW_MSG("level0 of the index is quantized, " HNSW_RAW_DATA " is missing");
+        }
         auto hnsw_stats = std::static_pointer_cast<LibHNSWStatistics>(stats);
         if (STATISTICS_LEVEL >= 3) {
             auto lock = hnsw_stats->Lock();
@@ -115,12 +166,63 @@ IndexHNSW::AddWithoutIds(const DatasetPtr& dataset_ptr, const Config& config) {
         KNOWHERE_THROW_MSG("index not initialize");
     }
 
+    // addPoint would throw it from the omp loop below
+    if (index_->level0_codec_ != hnswlib::LEVEL0_FLOAT) {
+        KNOWHERE_THROW_MSG("can't add to an HNSW whose level0 holds codes (quantizer_type) or no vectors");
+    }
+
     GET_TENSOR_DATA(dataset_ptr)
 
-    index_->addPoint(p_data, 0);
+    // appended after the current entries, a loaded index grows by half at least
+    int64_t ntotal = Count();
+    try {
+        if (ntotal + rows > static_cast<int64_t>(index_->max_elements_)) {
+            index_->resizeIndex(std::max<size_t>(ntotal + rows, index_->max_elements_ * 3 / 2));
+        }
+        if (config.contains(IndexParams::batch_build) && config[IndexParams::batch_build].get<bool>()) {
+            index_->addPointsBatched(p_data, ntotal, rows);
+        } else {
+            int64_t first = 0;
+            if (ntotal == 0 && rows > 0) {
+                index_->addPoint(p_data, 0);
+                first = 1;
+            }
+            // an exception can't leave the omp region, the first one is thrown after it
+            std::exception_ptr error = nullptr;
 #pragma omp parallel for
-    for (int i = 1; i < rows; ++i) {
-        index_->addPoint((reinterpret_cast<const float*>(p_data) + Dim() * i), i);
+            for (int64_t i = first; i < rows; ++i) {
+                try {
+                    index_->addPoint((reinterpret_cast<const float*>(p_data) + Dim() * i), ntotal + i);
+                } catch (...) {
+#pragma omp critical
+                    if (error == nullptr) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (error != nullptr) {
+                std::rethrow_exception(error);
+            }
+        }
+    } catch (std::runtime_error& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+    if (config.contains(IndexParams::reorder) && config[IndexParams::reorder].get<bool>()) {
+        Reorder();
+    }
+    if (config.contains(IndexParams::quantizer_type)) {
+        std::string quantizer_type = config[IndexParams::quantizer_type];
+        try {
+            if (quantizer_type == SQType::QT_8BIT) {
+                index_->quantizeLevel0(hnswlib::LEVEL0_SQ8);
+            } else if (quantizer_type == SQType::QT_FP16) {
+                index_->quantizeLevel0(hnswlib::LEVEL0_FP16);
+            } else {
+                KNOWHERE_THROW_MSG("HNSW doesn't support quantizer type " + quantizer_type);
+            }
+        } catch (std::runtime_error& e) {
+            KNOWHERE_THROW_MSG(e.what());
+        }
     }
     if (STATISTICS_LEVEL >= 3) {
         auto hnsw_stats = std::static_pointer_cast<LibHNSWStatistics>(stats);
@@ -131,18 +233,79 @@ IndexHNSW::AddWithoutIds(const DatasetPtr& dataset_ptr, const Config& config) {
     //     LOG_KNOWHERE_DEBUG_ << GetStatistics()->ToString();
 }
 
+int64_t
+IndexHNSW::Remove(const IDType* ids, int64_t n) {
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize");
+    }
+
+    auto ntotal = Count();
+    std::vector<int64_t> new_offsets;
+    auto new_uids = CompactOffsets(ids, n, ntotal, new_offsets);
+    if (new_uids == nullptr) {
+        return 0;
+    }
+
+    try {
+        index_->removePoints(new_offsets.data());
+    } catch (std::runtime_error& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+    // level0 is copied out of a mapped binary
+    mapped_binary_ = nullptr;
+
+    if (STATISTICS_LEVEL >= 3) {
+        auto hnsw_stats = std::static_pointer_cast<LibHNSWStatistics>(stats);
+        auto lock = hnsw_stats->Lock();
+        hnsw_stats->update_level_distribution(index_->maxlevel_, index_->level_stats_);
+    }
+    uids_ = new_uids;
+    return ntotal - static_cast<int64_t>(new_uids->size());
+}
+
 DatasetPtr
 IndexHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+    return QueryIntoDataset(dataset_ptr, config, bitset);
+}
+
+void
+IndexHNSW::QueryInto(const float* query,
+                     int64_t rows,
+                     int64_t topk,
+                     float* distances,
+                     int64_t* ids,
+                     const Config& config,
+                     const faiss::BitsetView bitset) {
+    QueryImpl(query, rows, topk, distances, ids, config, bitset, nullptr);
+}
+
+void
+IndexHNSW::QueryWithContext(const float* query,
+                            int64_t rows,
+                            int64_t topk,
+                            float* distances,
+                            int64_t* ids,
+                            const Config& config,
+                            const faiss::BitsetView bitset,
+                            SearchContext& ctx) {
+    QueryImpl(query, rows, topk, distances, ids, config, bitset, &ctx);
+}
+
+void
+IndexHNSW::QueryImpl(const float* query,
+                     int64_t rows,
+                     int64_t topk,
+                     float* distances,
+                     int64_t* ids,
+                     const Config& config,
+                     const faiss::BitsetView bitset,
+                     SearchContext* ctx) {
     if (!index_) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
-    GET_TENSOR_DATA_DIM(dataset_ptr)
+    auto dim = Dim();
 
-    size_t k = config[meta::TOPK].get<int64_t>();
-    size_t id_size = sizeof(int64_t) * k;
-    size_t dist_size = sizeof(float) * k;
-    auto p_id = static_cast<int64_t*>(malloc(id_size * rows));
-    auto p_dist = static_cast<float*>(malloc(dist_size * rows));
+    size_t k = topk;
     std::vector<hnswlib::StatisticsInfo> query_stats;
     auto hnsw_stats = std::dynamic_pointer_cast<LibHNSWStatistics>(stats);
     if (STATISTICS_LEVEL >= 3) {
@@ -152,26 +315,30 @@ IndexHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const fais
         }
     }
 
-    index_->setEf(config[IndexParams::ef].get<int64_t>());
+    auto plan = PlanFilteredSearch(bitset, Count(), config[IndexParams::ef].get<int64_t>(), topk, index_->maxM0_);
+    index_->setEf(plan.ef);
     bool transform = (index_->metric_type_ == 1);  // InnerProduct: 1
 
-    std::chrono::high_resolution_clock::time_point query_start, query_end;
-    query_start = std::chrono::high_resolution_clock::now();
+    // opt-in: with fewer queries than intra_query_threads, parallelize inside each query's base-layer
+    // expansion instead of across the queries
+    int64_t search_width = 1;
+    if (config.contains(IndexParams::intra_query_threads)) {
+        search_width = config[IndexParams::intra_query_threads].get<int64_t>();
+    }
+    bool intra_query = (ctx == nullptr && search_width > 1 && rows < search_width);
 
-#pragma omp parallel for
-    for (unsigned int i = 0; i < rows; ++i) {
-        auto single_query = (float*)p_data + i * dim;
-        std::priority_queue<std::pair<float, hnswlib::labeltype>> rst;
-        if (STATISTICS_LEVEL >= 3) {
-            rst = index_->searchKnn(single_query, k, bitset, query_stats[i]);
-        } else {
-            auto dummy_stat = hnswlib::StatisticsInfo();
-            rst = index_->searchKnn(single_query, k, bitset, dummy_stat);
-        }
+    auto search_single = [&](int64_t i, hnswlib::VisitedList* vl) {
+        auto single_query = query + i * dim;
+        auto dummy_stat = hnswlib::StatisticsInfo();
+        auto& query_stat = (STATISTICS_LEVEL >= 3) ? query_stats[i] : dummy_stat;
+        auto rst = plan.mode == FilteredSearchMode::BRUTE_FORCE
+                       ? index_->searchKnnBruteForce(single_query, k, bitset)
+                       : index_->searchKnn(single_query, k, bitset, query_stat, vl, intra_query ? search_width : 1,
+                                           plan.mode == FilteredSearchMode::TWO_HOP);
         size_t rst_size = rst.size();
 
-        auto p_single_dis = p_dist + i * k;
-        auto p_single_id = p_id + i * k;
+        auto p_single_dis = distances + i * k;
+        auto p_single_id = ids + i * k;
         size_t idx = rst_size - 1;
         while (!rst.empty()) {
             auto& it = rst.top();
@@ -186,6 +353,30 @@ IndexHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const fais
             p_single_dis[idx] = float(1.0 / 0.0);
             p_single_id[idx] = -1;
         }
+    };
+
+    std::chrono::high_resolution_clock::time_point query_start, query_end;
+    query_start = std::chrono::high_resolution_clock::now();
+
+    if (ctx != nullptr) {
+        auto vl = ContextVisitedList(*ctx);
+        for (int64_t i = 0; i < rows; ++i) {
+            search_single(i, vl);
+        }
+    } else if (intra_query) {
+        for (int64_t i = 0; i < rows; ++i) {
+            search_single(i, nullptr);
+        }
+    } else {
+        // each thread takes the queries one at a time with the visited list of its own context
+#pragma omp parallel
+        {
+            auto vl = ContextVisitedList(SearchContext::Local());
+#pragma omp for schedule(dynamic)
+            for (int64_t i = 0; i < rows; ++i) {
+                search_single(i, vl);
+            }
+        }
     }
     query_end = std::chrono::high_resolution_clock::now();
 
@@ -214,11 +405,6 @@ IndexHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const fais
     }
     //     LOG_KNOWHERE_DEBUG_ << "IndexHNSW::Query finished, show statistics:";
     //     LOG_KNOWHERE_DEBUG_ << GetStatistics()->ToString();
-
-    auto ret_ds = std::make_shared<Dataset>();
-    ret_ds->Set(meta::IDS, p_id);
-    ret_ds->Set(meta::DISTANCE, p_dist);
-    return ret_ds;
 }
 
 int64_t
@@ -245,6 +431,39 @@ IndexHNSW::UpdateIndexSize() {
     index_size_ = index_->cal_size();
 }
 
+void
+IndexHNSW::Reorder() {
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize");
+    }
+    try {
+        index_->reorderLevel0();
+        // level0 and the raw vectors have been copied out of the mapped buffers
+        mapped_binary_ = nullptr;
+        mapped_raw_binary_ = nullptr;
+    } catch (std::exception& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+}
+
+hnswlib::VisitedList*
+IndexHNSW::ContextVisitedList(SearchContext& ctx) {
+    auto& visited = ctx.Get<std::unique_ptr<hnswlib::VisitedList>>(search_owner_);
+    if (visited == nullptr || static_cast<size_t>(visited->numelements) < index_->max_elements_) {
+        visited = std::make_unique<hnswlib::VisitedList>(index_->max_elements_);
+    }
+    return visited.get();
+}
+
+faiss::PayloadPlacement
+IndexHNSW::GetPayloadPlacement() {
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize");
+    }
+    return faiss::payload_query(index_->data_level0_memory_,
+                                index_->cur_element_count * index_->size_data_per_element_);
+}
+
 void
 IndexHNSW::ClearStatistics() {
     if (!STATISTICS_LEVEL)
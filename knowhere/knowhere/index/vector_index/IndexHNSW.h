@@ -21,6 +21,9 @@
 namespace milvus {
 namespace knowhere {
 
+// codec and full vectors of an index built with IndexParams::quantizer_type, whose level0 holds codes
+#define HNSW_RAW_DATA "HNSW_RAW_DATA"
+
 class IndexHNSW : public VecIndex {
  public:
     IndexHNSW() {
@@ -31,18 +34,51 @@ class IndexHNSW : public VecIndex {
     BinarySet
     Serialize(const Config& config) override;
 
+    void
+    SerializeTo(const Config& config, const BinarySink& sink) override;
+
     void
     Load(const BinarySet& index_binary) override;
 
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
     void
     Train(const DatasetPtr& dataset_ptr, const Config& config) override;
 
+    // Appends to the entries already in the index, growing its storage when it is full. Not supported once
+    // level0 is referenced in place from a mapped binary, or holds codes (quantizer_type) or no vectors.
     void
     AddWithoutIds(const DatasetPtr&, const Config&) override;
 
+    // Links of the remaining nodes to removed ones are repaired over the neighbors of those, then the graph is
+    // compacted, so that the freed slots are reused by the next AddWithoutIds.
+    int64_t
+    Remove(const IDType*, int64_t) override;
+
     DatasetPtr
     Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) override;
 
+    void
+    QueryInto(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset) override;
+
+    void
+    QueryWithContext(const float* query,
+                     int64_t nq,
+                     int64_t k,
+                     float* distances,
+                     int64_t* ids,
+                     const Config& config,
+                     const faiss::BitsetView bitset,
+                     SearchContext& ctx) override;
+
     int64_t
     Count() override;
 
@@ -52,11 +88,39 @@ class IndexHNSW : public VecIndex {
     void
     UpdateIndexSize() override;
 
+    faiss::PayloadPlacement
+    GetPayloadPlacement() override;
+
     void
     ClearStatistics() override;
 
+    // Renumbers the graph in BFS order for locality of the level-0 walk. Done after build when
+    // IndexParams::reorder is set; the order is kept by Serialize, so a loaded index only needs it once.
+    void
+    Reorder();
+
  private:
+    // ctx == nullptr: parallel over the queries with the thread-local contexts
+    void
+    QueryImpl(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset,
+              SearchContext* ctx);
+
+    hnswlib::VisitedList*
+    ContextVisitedList(SearchContext& ctx);
+
+ protected:
     std::shared_ptr<hnswlib::HierarchicalNSW<float>> index_;
+    // keeps a mapped binary alive while index_ references its level0 in place
+    BinaryPtr mapped_binary_ = nullptr;
+    BinaryPtr mapped_raw_binary_ = nullptr;
+    // key of this index's visited list in the search contexts
+    SearchContextOwner search_owner_;
 };
 
 }  // namespace knowhere
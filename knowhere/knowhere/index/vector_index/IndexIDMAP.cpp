@@ -168,6 +168,15 @@ IDMAP::CopyCpuToGpu(const int64_t device_id, const Config& config) {
 #endif
 }
 
+faiss::PayloadPlacement
+IDMAP::GetPayloadPlacement() {
+    auto flat_index = dynamic_cast<faiss::IndexFlat*>(index_.get());
+    if (flat_index == nullptr) {
+        return faiss::PayloadPlacement();
+    }
+    return faiss::payload_query(flat_index->xb.data(), flat_index->xb.size() * sizeof(float));
+}
+
 const float*
 IDMAP::GetRawVectors() {
     try {
@@ -37,6 +37,10 @@ class IDMAP : public VecIndex, public FaissBaseIndex {
     void
     Load(const BinarySet&) override;
 
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
@@ -60,6 +64,9 @@ class IDMAP : public VecIndex, public FaissBaseIndex {
         return Count() * Dim() * sizeof(FloatType);
     }
 
+    faiss::PayloadPlacement
+    GetPayloadPlacement() override;
+
     VecIndexPtr
     CopyCpuToGpu(const int64_t, const Config&);
 
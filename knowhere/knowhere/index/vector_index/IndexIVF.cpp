@@ -10,6 +10,8 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <faiss/AutoTune.h>
+#include <faiss/Clustering.h>
+#include <faiss/FaissHook.h>
 #include <faiss/IVFlib.h>
 #include <faiss/IndexFlat.h>
 #include <faiss/IndexIVF.h>
@@ -24,6 +26,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -33,6 +38,8 @@
 #include "knowhere/common/Log.h"
 #include "knowhere/index/vector_index/IndexIVF.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/CoarseQuantizer.h"
+#include "knowhere/index/vector_index/helpers/FaissIO.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #ifdef KNOWHERE_GPU_VERSION
 #include "knowhere/index/vector_index/gpu/IndexGPUIVF.h"
@@ -44,12 +51,25 @@ namespace knowhere {
 
 using stdclock = std::chrono::high_resolution_clock;
 
+// average number of queries per list from which a batch is scanned list by list
+static const int64_t LIST_MAJOR_MIN_QUERIES_PER_LIST = 16;
+
+static const float DEFAULT_MAX_LIST_SIZE_RATIO = 4.0;
+static const float DEFAULT_MIN_LIST_SIZE_RATIO = 0.1;
+
 BinarySet
 IVF::Serialize(const Config& config) {
     if (!index_ || !index_->is_trained) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
 
+    if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE) && index_mode_ == IndexMode::MODE_CPU) {
+        // write the slices directly instead of disassembling a full copy of the index
+        BinarySet ret;
+        SerializeTo(config, ret.AppendSink());
+        return ret;
+    }
+
     auto ret = SerializeImpl(index_type_);
     if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
         Disassemble(config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024, ret);
@@ -57,11 +77,39 @@ IVF::Serialize(const Config& config) {
     return ret;
 }
 
+void
+IVF::SerializeTo(const Config& config, const BinarySink& sink) {
+    if (!config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE) || index_mode_ != IndexMode::MODE_CPU) {
+        VecIndex::SerializeTo(config, sink);
+        return;
+    }
+    if (!index_ || !index_->is_trained) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
+
+    try {
+        milvus::json meta_info;
+        SliceIOWriter writer("IVF", config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024, sink);
+        faiss::write_index(index_.get(), &writer);
+        writer.Close(meta_info);
+        EmitSliceMeta(meta_info, sink);
+    } catch (std::exception& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+}
+
 void
 IVF::Load(const BinarySet& binary_set) {
     Assemble(const_cast<BinarySet&>(binary_set));
     LoadImpl(binary_set, index_type_);
 
+    // raw vectors are only kept when refine_k can use them
+    raw_data_ = nullptr;
+    if (RefineWithRawData()) {
+        LoadRawData(binary_set);
+    }
+    ResetListRadius();
+
     if (IndexMode() == IndexMode::MODE_CPU && STATISTICS_LEVEL >= 3) {
         auto ivf_index = static_cast<faiss::IndexIVFFlat*>(index_.get());
         ivf_index->nprobe_statistics.resize(ivf_index->nlist, 0);
@@ -74,7 +122,7 @@ IVF::Train(const DatasetPtr& dataset_ptr, const Config& config) {
 
     auto nlist = config[IndexParams::nlist].get<int64_t>();
     faiss::MetricType metric_type = GetMetricType(config[Metric::TYPE].get<std::string>());
-    faiss::Index* coarse_quantizer = new faiss::IndexFlat(dim, metric_type);
+    auto coarse_quantizer = BuildCoarseQuantizer(config, rows, static_cast<const float*>(p_data), dim, metric_type);
     auto index = std::make_shared<faiss::IndexIVFFlat>(coarse_quantizer, dim, nlist, metric_type);
     index->own_fields = true;
     index->train(rows, reinterpret_cast<const float*>(p_data));
@@ -87,50 +135,130 @@ IVF::AddWithoutIds(const DatasetPtr& dataset_ptr, const Config& config) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
 
+    CheckListsWritable();
+
     GET_TENSOR_DATA(dataset_ptr)
+    auto ntotal = index_->ntotal;
+    // the new entries are appended to the lists, only they can widen computed radii
+    std::vector<size_t> list_sizes;
+    auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index_.get());
+    bool widen = false;
+    {
+        std::lock_guard<std::mutex> lock(list_radius_mutex_);
+        widen = list_radius_ != nullptr;
+    }
+    if (widen && ivf_index != nullptr) {
+        list_sizes.resize(ivf_index->invlists->nlist);
+        for (size_t i = 0; i < list_sizes.size(); ++i) {
+            list_sizes[i] = ivf_index->invlists->list_size(i);
+        }
+    }
     index_->add(rows, reinterpret_cast<const float*>(p_data));
+    if (widen) {
+        WidenListRadius(list_sizes);
+    }
+
+    // keep the raw vectors of refine_k in step with the index, from the first add on when the build asks for them
+    bool keep_raw = (ntotal == 0 && RefineWithRawData() && config.contains(IndexParams::refine_k) &&
+                     config[IndexParams::refine_k].get<int64_t>() > 1);
+    if (raw_data_ != nullptr || keep_raw) {
+        auto row_size = index_->d * sizeof(float);
+        auto raw_data = std::make_shared<Binary>();
+        raw_data->size = (ntotal + rows) * row_size;
+        raw_data->data = std::shared_ptr<uint8_t[]>(new uint8_t[raw_data->size]);
+        if (ntotal > 0) {
+            memcpy(raw_data->data.get(), raw_data_->data.get(), ntotal * row_size);
+        }
+        memcpy(raw_data->data.get() + ntotal * row_size, p_data, rows * row_size);
+        raw_data_ = raw_data;
+    }
 }
 
-DatasetPtr
-IVF::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+int64_t
+IVF::Remove(const IDType* ids, int64_t n) {
     if (!index_ || !index_->is_trained) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
 
-    GET_TENSOR_DATA(dataset_ptr)
+    auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index_.get());
+    if (ivf_index == nullptr) {
+        KNOWHERE_THROW_MSG("Remove is only supported on CPU indexes");
+    }
+    CheckListsWritable();
+    auto ntotal = ivf_index->ntotal;
+    std::vector<int64_t> new_offsets;
+    auto new_uids = CompactOffsets(ids, n, ntotal, new_offsets);
+    if (new_uids == nullptr) {
+        return 0;
+    }
 
-    int64_t* p_id = nullptr;
-    float* p_dist = nullptr;
-    auto release_when_exception = [&]() {
-        if (p_id != nullptr) {
-            free(p_id);
-        }
-        if (p_dist != nullptr) {
-            free(p_dist);
+    try {
+        ivf_index->compact_ids(new_offsets.data());
+    } catch (faiss::FaissException& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+
+    if (raw_data_ != nullptr) {
+        auto row_size = index_->d * sizeof(float);
+        auto raw_data = std::make_shared<Binary>();
+        raw_data->size = new_uids->size() * row_size;
+        raw_data->data = std::shared_ptr<uint8_t[]>(new uint8_t[raw_data->size]);
+        for (int64_t i = 0; i < ntotal; ++i) {
+            if (new_offsets[i] >= 0) {
+                memcpy(raw_data->data.get() + new_offsets[i] * row_size, raw_data_->data.get() + i * row_size,
+                       row_size);
+            }
         }
-    };
+        raw_data_ = raw_data;
+    }
+    uids_ = new_uids;
+    return ntotal - static_cast<int64_t>(new_uids->size());
+}
 
-    try {
-        auto k = config[meta::TOPK].get<int64_t>();
-        auto elems = rows * k;
+void
+IVF::CheckListsWritable() {
+    auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index_.get());
+    if (ivf_index != nullptr && dynamic_cast<faiss::ReadOnlyInvertedLists*>(ivf_index->invlists) != nullptr) {
+        KNOWHERE_THROW_MSG("the inverted lists are referenced in place from a mapped binary, they are read-only");
+    }
+}
 
-        size_t p_id_size = sizeof(int64_t) * elems;
-        size_t p_dist_size = sizeof(float) * elems;
-        p_id = static_cast<int64_t*>(malloc(p_id_size));
-        p_dist = static_cast<float*>(malloc(p_dist_size));
+DatasetPtr
+IVF::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+    return QueryIntoDataset(dataset_ptr, config, bitset);
+}
 
-        QueryImpl(rows, reinterpret_cast<const float*>(p_data), k, p_dist, p_id, config, bitset);
-        MapOffsetToUid(p_id, static_cast<size_t>(elems));
+void
+IVF::QueryInto(const float* query,
+               int64_t nq,
+               int64_t k,
+               float* distances,
+               int64_t* ids,
+               const Config& config,
+               const faiss::BitsetView bitset) {
+    if (!index_ || !index_->is_trained) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
 
-        auto ret_ds = std::make_shared<Dataset>();
-        ret_ds->Set(meta::IDS, p_id);
-        ret_ds->Set(meta::DISTANCE, p_dist);
-        return ret_ds;
+    try {
+        int64_t refine_k = config.contains(IndexParams::refine_k) ? config[IndexParams::refine_k].get<int64_t>() : 1;
+        if (refine_k > 1 && RefineWithRawData()) {
+            if (raw_data_ == nullptr) {
+                KNOWHERE_THROW_MSG("refine_k needs the raw vectors: build with refine_k or load with " RAW_DATA);
+            }
+            // search k * refine_k candidates on the codes, keep the k best by exact distance
+            auto candidate_k = k * refine_k;
+            std::vector<float> candidate_distances(nq * candidate_k);
+            std::vector<int64_t> candidate_ids(nq * candidate_k);
+            QueryImpl(nq, query, candidate_k, candidate_distances.data(), candidate_ids.data(), config, bitset);
+            Refine(nq, query, k, candidate_k, candidate_ids.data(), distances, ids);
+        } else {
+            QueryImpl(nq, query, k, distances, ids, config, bitset);
+        }
+        MapOffsetToUid(ids, static_cast<size_t>(nq * k));
     } catch (faiss::FaissException& e) {
-        release_when_exception();
         KNOWHERE_THROW_MSG(e.what());
     } catch (std::exception& e) {
-        release_when_exception();
         KNOWHERE_THROW_MSG(e.what());
     }
 }
@@ -226,6 +354,119 @@ IVF::Dim() {
     return index_->d;
 }
 
+void
+IVF::Rebalance(const Config& config) {
+    if (!index_ || !index_->is_trained) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
+    auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index_.get());
+    auto quantizer = ivf_index ? dynamic_cast<faiss::IndexFlat*>(ivf_index->quantizer) : nullptr;
+    auto ails = ivf_index ? dynamic_cast<faiss::ArrayInvertedLists*>(ivf_index->invlists) : nullptr;
+    if (quantizer == nullptr || ails == nullptr || !ivf_index->direct_map.no()) {
+        KNOWHERE_THROW_MSG("Rebalance needs a CPU index with a flat quantizer and array inverted lists");
+    }
+    auto max_ratio = config.contains(IndexParams::max_list_size_ratio)
+                         ? config[IndexParams::max_list_size_ratio].get<float>()
+                         : DEFAULT_MAX_LIST_SIZE_RATIO;
+    auto min_ratio = config.contains(IndexParams::min_list_size_ratio)
+                         ? config[IndexParams::min_list_size_ratio].get<float>()
+                         : DEFAULT_MIN_LIST_SIZE_RATIO;
+    if (max_ratio <= 1 || min_ratio < 0 || min_ratio >= 1) {
+        KNOWHERE_THROW_MSG("Rebalance needs max_list_size_ratio > 1 and 0 <= min_list_size_ratio < 1");
+    }
+
+    auto nlist = ivf_index->nlist;
+    auto d = ivf_index->d;
+    auto ntotal = ivf_index->ntotal;
+    if (ntotal == 0) {
+        return;
+    }
+    double avg_size = static_cast<double>(ntotal) / nlist;
+
+    // entries of the lists to split or merge are taken out, with their vectors
+    auto raw = raw_data_ ? reinterpret_cast<const float*>(raw_data_->data.get()) : nullptr;
+    std::vector<int64_t> moved_ids;
+    std::vector<float> moved_x;
+    auto take_out = [&](size_t list_no) {
+        auto list_size = ails->ids[list_no].size();
+        auto begin = moved_x.size();
+        moved_x.resize(begin + list_size * d);
+        for (size_t j = 0; j < list_size; ++j) {
+            auto id = ails->ids[list_no][j];
+            if (raw != nullptr) {
+                memcpy(moved_x.data() + begin + j * d, raw + id * d, d * sizeof(float));
+            } else {
+                ivf_index->reconstruct_from_offset(list_no, j, moved_x.data() + begin + j * d);
+            }
+            moved_ids.push_back(id);
+        }
+        ails->ids[list_no].clear();
+        ails->codes[list_no].clear();
+        return moved_x.data() + begin;
+    };
+
+    faiss::PayloadVector<float> centroids;
+    std::vector<int64_t> list_map(nlist, -1);  // old list number to the new one, -1 for merged lists
+    std::vector<float> split_centroids;
+    for (size_t i = 0; i < nlist; ++i) {
+        auto list_size = ails->ids[i].size();
+        const float* centroid = quantizer->xb.data() + i * d;
+        if (list_size < min_ratio * avg_size) {
+            take_out(i);
+            continue;
+        }
+        std::vector<float> sub_centroids;
+        if (list_size > max_ratio * avg_size) {
+            auto k = static_cast<size_t>(std::ceil(list_size / avg_size));
+            sub_centroids.resize(k * d);
+            auto x = take_out(i);
+            faiss::kmeans_clustering(d, list_size, k, x, sub_centroids.data());
+            split_centroids.insert(split_centroids.end(), sub_centroids.begin() + d, sub_centroids.end());
+            centroid = sub_centroids.data();
+        }
+        list_map[i] = centroids.size() / d;
+        centroids.insert(centroids.end(), centroid, centroid + d);
+    }
+    if (split_centroids.empty() && centroids.size() == nlist * d) {
+        return;
+    }
+    centroids.insert(centroids.end(), split_centroids.begin(), split_centroids.end());
+    size_t new_nlist = centroids.size() / d;
+
+    std::vector<faiss::PayloadVector<uint8_t>> codes(new_nlist);
+    std::vector<std::vector<faiss::Index::idx_t>> ids(new_nlist);
+    for (size_t i = 0; i < nlist; ++i) {
+        if (list_map[i] >= 0) {
+            codes[list_map[i]].swap(ails->codes[i]);
+            ids[list_map[i]].swap(ails->ids[i]);
+        }
+    }
+    ails->codes.swap(codes);
+    ails->ids.swap(ids);
+    ails->nlist = new_nlist;
+    ivf_index->nlist = new_nlist;
+    quantizer->xb.swap(centroids);
+    quantizer->ntotal = new_nlist;
+    if (auto ivfpq_index = dynamic_cast<faiss::IndexIVFPQ*>(ivf_index)) {
+        ivfpq_index->precompute_table();
+    }
+
+    // the codes of residual encodings depend on the centroid, the moved entries are encoded again
+    auto nmoved = moved_ids.size();
+    std::vector<faiss::Index::idx_t> list_nos(nmoved);
+    std::vector<uint8_t> moved_codes(nmoved * ivf_index->code_size);
+    quantizer->assign(nmoved, moved_x.data(), list_nos.data());
+    ivf_index->encode_vectors(nmoved, moved_x.data(), list_nos.data(), moved_codes.data());
+    for (size_t i = 0; i < nmoved; ++i) {
+        ails->add_entries(list_nos[i], 1, &moved_ids[i], moved_codes.data() + i * ivf_index->code_size);
+    }
+
+    if (!ivf_index->nprobe_statistics.empty()) {
+        ivf_index->nprobe_statistics.assign(new_nlist, 0);
+    }
+    ResetListRadius();
+}
+
 void
 IVF::Seal() {
     if (!index_ || !index_->is_trained) {
@@ -247,6 +488,24 @@ IVF::UpdateIndexSize() {
     index_size_ = nb * code_size + nb * sizeof(int64_t) + nlist * code_size;
 }
 
+faiss::PayloadPlacement
+IVF::GetPayloadPlacement() {
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize");
+    }
+    auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index_.get());
+    auto ails = ivf_index ? dynamic_cast<faiss::ArrayInvertedLists*>(ivf_index->invlists) : nullptr;
+    if (ails == nullptr) {
+        return faiss::PayloadPlacement();
+    }
+    std::vector<faiss::PayloadRange> ranges;
+    ranges.reserve(ails->nlist);
+    for (size_t i = 0; i < ails->nlist; i++) {
+        ranges.emplace_back(ails->codes[i].data(), ails->codes[i].size());
+    }
+    return faiss::payload_query(ranges);
+}
+
 VecIndexPtr
 IVF::CopyCpuToGpu(const int64_t device_id, const Config& config) {
 #ifdef KNOWHERE_GPU_VERSION
@@ -322,11 +581,27 @@ IVF::QueryImpl(int64_t n,
     stdclock::time_point before = stdclock::now();
     if (params->nprobe > 1 && n <= 4) {
         ivf_index->parallel_mode = 1;
+    } else if (ListMajorScan() &&
+               n * ivf_index->nprobe >= LIST_MAJOR_MIN_QUERIES_PER_LIST * ivf_index->invlists->nlist) {
+        ivf_index->parallel_mode = 2;
     } else {
         ivf_index->parallel_mode = 0;
     }
+    SetCoarseQuantizerParams(ivf_index->quantizer, config);
     auto ivf_stats = std::dynamic_pointer_cast<IVFStatistics>(stats);
-    ivf_index->search(n, data, k, distances, labels, bitset);
+    if (config.contains(IndexParams::prune_ratio)) {
+        // lists are skipped on the k-th result of the query, which parallel_mode 1 splits over the threads
+        if (ivf_index->parallel_mode == 1) {
+            ivf_index->parallel_mode = 0;
+        }
+        params->nprobe = ivf_index->nprobe;
+        auto list_radius = ListRadius();
+        params->list_radius = list_radius ? list_radius->data() : nullptr;
+        params->radius_ratio = config[IndexParams::prune_ratio].get<float>();
+        ivf_index->search_with_params(n, data, k, distances, labels, params.get(), bitset);
+    } else {
+        ivf_index->search(n, data, k, distances, labels, bitset);
+    }
     stdclock::time_point after = stdclock::now();
     double search_cost = (std::chrono::duration<double, std::micro>(after - before)).count();
     if (STATISTICS_LEVEL) {
@@ -351,6 +626,117 @@ IVF::QueryImpl(int64_t n,
     //     LOG_KNOWHERE_DEBUG_ << GetStatistics()->ToString();
 }
 
+void
+IVF::LoadRawData(const BinarySet& binary_set) {
+    raw_data_ = nullptr;
+    if (!binary_set.Contains(RAW_DATA)) {
+        return;
+    }
+    // referenced rather than copied, so a mapped RAW_DATA stays on the mapping
+    auto raw_data = binary_set.GetByName(RAW_DATA);
+    if (raw_data->size == static_cast<int64_t>(index_->ntotal * index_->d * sizeof(float))) {
+        raw_data_ = raw_data;
+    } else {
+        LOG_KNOWHERE_WARNING_ << "IVF ignores RAW_DATA of unexpected size " << raw_data->size;
+    }
+}
+
+void
+IVF::Refine(int64_t n,
+            const float* data,
+            int64_t k,
+            int64_t candidate_k,
+            const int64_t* candidate_ids,
+            float* distances,
+            int64_t* labels) {
+    auto raw = reinterpret_cast<const float*>(raw_data_->data.get());
+    auto d = index_->d;
+    bool is_ip = (index_->metric_type == faiss::METRIC_INNER_PRODUCT);
+
+#pragma omp parallel for if (n > 1)
+    for (int64_t i = 0; i < n; ++i) {
+        auto query = data + i * d;
+        std::vector<std::pair<float, int64_t>> candidates;
+        candidates.reserve(candidate_k);
+        for (int64_t j = 0; j < candidate_k; ++j) {
+            auto id = candidate_ids[i * candidate_k + j];
+            if (id < 0) {
+                break;
+            }
+            // negated inner product, so that smaller is better for both metrics
+            auto vec = raw + id * d;
+            float dis = is_ip ? -faiss::fvec_inner_product(query, vec, d) : faiss::fvec_L2sqr(query, vec, d);
+            candidates.emplace_back(dis, id);
+        }
+        auto top = std::min(k, static_cast<int64_t>(candidates.size()));
+        std::partial_sort(candidates.begin(), candidates.begin() + top, candidates.end());
+
+        for (int64_t j = 0; j < k; ++j) {
+            if (j < top) {
+                distances[i * k + j] = is_ip ? -candidates[j].first : candidates[j].first;
+                labels[i * k + j] = candidates[j].second;
+            } else {
+                distances[i * k + j] = is_ip ? -std::numeric_limits<float>::max() : std::numeric_limits<float>::max();
+                labels[i * k + j] = -1;
+            }
+        }
+    }
+}
+
+std::shared_ptr<const std::vector<float>>
+IVF::ListRadius() {
+    std::lock_guard<std::mutex> lock(list_radius_mutex_);
+    if (list_radius_ == nullptr || list_radius_index_.lock() != index_) {
+        list_radius_ = ComputeListRadius(nullptr, {});
+        list_radius_index_ = index_;
+    }
+    return list_radius_;
+}
+
+void
+IVF::WidenListRadius(const std::vector<size_t>& list_sizes) {
+    std::lock_guard<std::mutex> lock(list_radius_mutex_);
+    if (list_radius_ == nullptr || list_radius_index_.lock() != index_ || list_radius_->size() != list_sizes.size()) {
+        list_radius_ = nullptr;
+        return;
+    }
+    list_radius_ = ComputeListRadius(list_radius_.get(), list_sizes);
+}
+
+void
+IVF::ResetListRadius() {
+    std::lock_guard<std::mutex> lock(list_radius_mutex_);
+    list_radius_ = nullptr;
+}
+
+std::shared_ptr<const std::vector<float>>
+IVF::ComputeListRadius(const std::vector<float>* radius, const std::vector<size_t>& list_sizes) {
+    auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index_.get());
+    if (ivf_index == nullptr || !PruneByListRadius()) {
+        return nullptr;
+    }
+
+    auto invlists = ivf_index->invlists;
+    auto d = ivf_index->d;
+    auto list_radius = std::make_shared<std::vector<float>>(invlists->nlist, 0.0f);
+    if (radius != nullptr) {
+        *list_radius = *radius;
+    }
+#pragma omp parallel for
+    for (size_t i = 0; i < invlists->nlist; ++i) {
+        std::vector<float> centroid(d), recons(d);
+        ivf_index->quantizer->reconstruct(i, centroid.data());
+        float squared = (*list_radius)[i] * (*list_radius)[i];
+        auto list_size = invlists->list_size(i);
+        for (size_t j = radius != nullptr ? list_sizes[i] : 0; j < list_size; ++j) {
+            ivf_index->reconstruct_from_offset(i, j, recons.data());
+            squared = std::max(squared, faiss::fvec_L2sqr(centroid.data(), recons.data(), d));
+        }
+        (*list_radius)[i] = std::sqrt(squared);
+    }
+    return list_radius;
+}
+
 void
 IVF::SealImpl() {
 #ifdef KNOWHERE_GPU_VERSION
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -39,9 +40,16 @@ class IVF : public VecIndex, public FaissBaseIndex {
     BinarySet
     Serialize(const Config&) override;
 
+    void
+    SerializeTo(const Config&, const BinarySink&) override;
+
     void
     Load(const BinarySet&) override;
 
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
@@ -51,6 +59,18 @@ class IVF : public VecIndex, public FaissBaseIndex {
     DatasetPtr
     Query(const DatasetPtr&, const Config&, const faiss::BitsetView) override;
 
+    int64_t
+    Remove(const IDType*, int64_t) override;
+
+    void
+    QueryInto(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset) override;
+
 #if 0
     DatasetPtr
     QueryById(const DatasetPtr& dataset, const Config& config) override;
@@ -65,6 +85,9 @@ class IVF : public VecIndex, public FaissBaseIndex {
     void
     UpdateIndexSize() override;
 
+    faiss::PayloadPlacement
+    GetPayloadPlacement() override;
+
     StatisticsPtr
     GetStatistics() override;
 
@@ -76,6 +99,13 @@ class IVF : public VecIndex, public FaissBaseIndex {
     GetVectorById(const DatasetPtr& dataset, const Config& config) override;
 #endif
 
+    // Maintenance of a CPU index, e.g. before re-serializing it: lists above max_list_size_ratio x the average
+    // size are split by k-means on their members into lists of about the average size, lists below
+    // min_list_size_ratio x the average are merged into their neighbours. Changes nlist. The moved vectors are
+    // read from the loaded RAW_DATA if any, else decoded, where entries sharing a code can't be told apart.
+    virtual void
+    Rebalance(const Config&);
+
     virtual void
     Seal();
 
@@ -92,8 +122,63 @@ class IVF : public VecIndex, public FaissBaseIndex {
     virtual void
     QueryImpl(int64_t, const float*, int64_t, float*, int64_t*, const Config&, const faiss::BitsetView);
 
+    // whether QueryImpl returns approximate distances that refine_k re-scores against raw_data_
+    virtual bool
+    RefineWithRawData() const {
+        return false;
+    }
+
+    // whether large batches scan each list once for all the queries probing it (faiss parallel_mode 2),
+    // worth it when setting a scanner up for a query is cheap
+    virtual bool
+    ListMajorScan() const {
+        return true;
+    }
+
+    // whether QueryImpl can skip lists by prune_ratio, which needs list_radius_
+    virtual bool
+    PruneByListRadius() const {
+        return true;
+    }
+
+    void
+    LoadRawData(const BinarySet&);
+
+    // throws when the lists are referenced in place from a mapped binary: adding or removing entries writes them,
+    // and faiss does so from omp regions that can't carry the exception out
+    void
+    CheckListsWritable();
+
+    void
+    Refine(int64_t, const float*, int64_t, int64_t, const int64_t*, float*, int64_t*);
+
+    // per list, the largest distance of its entries to the centroid, computed by the first query that sets
+    // prune_ratio and shared with the queries running while it is replaced. nullptr when the index can't prune
+    std::shared_ptr<const std::vector<float>>
+    ListRadius();
+
+    // widen computed radii by the entries appended to the lists since they had list_sizes. Remove leaves the
+    // radii as they are, an over-estimate only prunes less; Load and Rebalance drop them
+    void
+    WidenListRadius(const std::vector<size_t>& list_sizes);
+
+    void
+    ResetListRadius();
+
+    // radii of radius, or with a null radius of empty lists, widened by the list entries from list_sizes on
+    std::shared_ptr<const std::vector<float>>
+    ComputeListRadius(const std::vector<float>* radius, const std::vector<size_t>& list_sizes);
+
     void
     SealImpl() override;
+
+ protected:
+    // RAW_DATA of the loaded binary set, or the vectors added to a build configured with refine_k
+    BinaryPtr raw_data_ = nullptr;
+
+    std::mutex list_radius_mutex_;
+    std::shared_ptr<const std::vector<float>> list_radius_ = nullptr;
+    std::weak_ptr<faiss::Index> list_radius_index_;  // index list_radius_ was computed for
 };
 
 using IVFPtr = std::shared_ptr<IVF>;
@@ -32,9 +32,17 @@ class IVFHNSW : public IVF {
     BinarySet
     Serialize(const Config&) override;
 
+    // the HNSW storage is serialized apart from the IVF data, so don't stream the IVF part alone
+    void
+    SerializeTo(const Config& config, const BinarySink& sink) override {
+        VecIndex::SerializeTo(config, sink);
+    }
+
     void
     Load(const BinarySet&) override;
 
+    using VecIndex::Train;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
@@ -53,6 +61,11 @@ class IVFHNSW : public IVF {
               int64_t* labels,
               const Config& config,
               const faiss::BitsetView bitset) override;
+
+    bool
+    PruneByListRadius() const override {
+        return false;
+    }
 };
 
 using IVFHNSWPtr = std::shared_ptr<IVFHNSW>;
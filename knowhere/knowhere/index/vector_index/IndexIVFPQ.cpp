@@ -22,6 +22,7 @@
 #include "knowhere/common/Log.h"
 #include "knowhere/index/vector_index/IndexIVFPQ.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/CoarseQuantizer.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #ifdef KNOWHERE_GPU_VERSION
 #include "knowhere/index/vector_index/ConfAdapter.h"
@@ -37,7 +38,7 @@ IVFPQ::Train(const DatasetPtr& dataset_ptr, const Config& config) {
     GET_TENSOR_DATA_DIM(dataset_ptr)
 
     faiss::MetricType metric_type = GetMetricType(config[Metric::TYPE].get<std::string>());
-    faiss::Index* coarse_quantizer = new faiss::IndexFlat(dim, metric_type);
+    auto coarse_quantizer = BuildCoarseQuantizer(config, rows, static_cast<const float*>(p_data), dim, metric_type);
     auto index = std::make_shared<faiss::IndexIVFPQ>(coarse_quantizer, dim, config[IndexParams::nlist].get<int64_t>(),
                                                      config[IndexParams::m].get<int64_t>(),
                                                      config[IndexParams::nbits].get<int64_t>(), metric_type);
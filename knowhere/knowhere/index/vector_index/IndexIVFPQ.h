@@ -31,6 +31,8 @@ class IVFPQ : public IVF {
         stats = std::make_shared<milvus::knowhere::IVFStatistics>(index_type_);
     }
 
+    using VecIndex::Train;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
@@ -43,6 +45,17 @@ class IVFPQ : public IVF {
  protected:
     std::shared_ptr<faiss::IVFSearchParameters>
     GenParams(const Config& config) override;
+
+    bool
+    RefineWithRawData() const override {
+        return true;
+    }
+
+    // the distance tables of a query would be rebuilt for every list it probes
+    bool
+    ListMajorScan() const override {
+        return false;
+    }
 };
 
 using IVFPQPtr = std::shared_ptr<IVFPQ>;
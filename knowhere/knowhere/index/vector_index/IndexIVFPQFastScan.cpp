@@ -0,0 +1,254 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <faiss/IndexFlat.h>
+#include <faiss/IndexIVFPQ.h>
+#include <faiss/impl/PQ4FastScan.h>
+#include <faiss/FaissHook.h>
+
+#include "knowhere/common/Exception.h"
+#include "knowhere/index/vector_index/IndexIVFPQFastScan.h"
+#include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/CoarseQuantizer.h"
+#include "knowhere/index/vector_index/helpers/IndexParameter.h"
+
+namespace milvus {
+namespace knowhere {
+
+namespace {
+
+constexpr int64_t FASTSCAN_NBITS = 4;
+
+// candidate of the scan, ordered by approximate distance (smaller is better)
+struct Candidate {
+    float distance;
+    int64_t list_no;
+    int64_t offset;
+    int64_t id;
+
+    bool
+    operator<(const Candidate& other) const {
+        return distance < other.distance;
+    }
+};
+
+}  // namespace
+
+void
+IVFPQFastScan::Load(const BinarySet& binary_set) {
+    IVFPQ::Load(binary_set);
+    LoadRawData(binary_set);
+    PackCodes();
+}
+
+void
+IVFPQFastScan::Train(const DatasetPtr& dataset_ptr, const Config& config) {
+    GET_TENSOR_DATA_DIM(dataset_ptr)
+
+    faiss::MetricType metric_type = GetMetricType(config[Metric::TYPE].get<std::string>());
+    auto coarse_quantizer = BuildCoarseQuantizer(config, rows, static_cast<const float*>(p_data), dim, metric_type);
+    auto index = std::make_shared<faiss::IndexIVFPQ>(coarse_quantizer, dim, config[IndexParams::nlist].get<int64_t>(),
+                                                     config[IndexParams::m].get<int64_t>(), FASTSCAN_NBITS,
+                                                     metric_type);
+    index->own_fields = true;
+    index->train(rows, reinterpret_cast<const float*>(p_data));
+    index_ = index;
+    packed_codes_.clear();
+}
+
+void
+IVFPQFastScan::AddWithoutIds(const DatasetPtr& dataset_ptr, const Config& config) {
+    IVFPQ::AddWithoutIds(dataset_ptr, config);
+    PackCodes();
+}
+
+int64_t
+IVFPQFastScan::Remove(const IDType* ids, int64_t n) {
+    auto nremove = IVFPQ::Remove(ids, n);
+    if (nremove > 0) {
+        PackCodes();
+    }
+    return nremove;
+}
+
+void
+IVFPQFastScan::Rebalance(const Config& config) {
+    IVFPQ::Rebalance(config);
+    PackCodes();
+}
+
+VecIndexPtr
+IVFPQFastScan::CopyCpuToGpu(const int64_t device_id, const Config& config) {
+    KNOWHERE_THROW_MSG("IVFPQFastScan has no GPU version");
+}
+
+void
+IVFPQFastScan::UpdateIndexSize() {
+    IVFPQ::UpdateIndexSize();
+    for (auto& packed : packed_codes_) {
+        index_size_ += packed.size();
+    }
+}
+
+void
+IVFPQFastScan::PackCodes() {
+    auto ivfpq_index = dynamic_cast<faiss::IndexIVFPQ*>(index_.get());
+    if (ivfpq_index == nullptr) {
+        packed_codes_.clear();
+        return;
+    }
+    if (ivfpq_index->pq.nbits != FASTSCAN_NBITS) {
+        KNOWHERE_THROW_MSG("IVFPQFastScan needs 4-bit sub-quantizers");
+    }
+    auto invlists = ivfpq_index->invlists;
+    auto M = ivfpq_index->pq.M;
+    packed_codes_.resize(invlists->nlist);
+#pragma omp parallel for
+    for (size_t i = 0; i < invlists->nlist; i++) {
+        auto list_size = invlists->list_size(i);
+        packed_codes_[i].resize(faiss::pq4_packed_size(list_size, M));
+        faiss::InvertedLists::ScopedCodes codes(invlists, i);
+        faiss::pq4_pack_codes(codes.get(), list_size, M, packed_codes_[i].data());
+    }
+}
+
+void
+IVFPQFastScan::QueryImpl(int64_t n,
+                         const float* data,
+                         int64_t k,
+                         float* distances,
+                         int64_t* labels,
+                         const Config& config,
+                         const faiss::BitsetView bitset) {
+    auto ivfpq_index = static_cast<faiss::IndexIVFPQ*>(index_.get());
+    auto invlists = ivfpq_index->invlists;
+    if (packed_codes_.size() != invlists->nlist) {
+        KNOWHERE_THROW_MSG("index not packed");
+    }
+    auto& pq = ivfpq_index->pq;
+    auto d = ivfpq_index->d;
+    bool is_ip = (ivfpq_index->metric_type == faiss::METRIC_INNER_PRODUCT);
+    bool by_residual = ivfpq_index->by_residual;
+
+    auto nprobe = std::min(static_cast<size_t>(config[IndexParams::nprobe].get<int64_t>()), invlists->nlist);
+    int64_t refine_k = config.contains(IndexParams::refine_k) ? config[IndexParams::refine_k].get<int64_t>() : 1;
+    auto num_candidates = static_cast<size_t>(k * std::max(refine_k, static_cast<int64_t>(1)));
+
+    SetCoarseQuantizerParams(ivfpq_index->quantizer, config);
+    std::vector<faiss::Index::idx_t> coarse_ids(n * nprobe);
+    std::vector<float> coarse_dis(n * nprobe);
+    ivfpq_index->quantizer->search(n, data, nprobe, coarse_dis.data(), coarse_ids.data());
+
+    auto raw = raw_data_ ? reinterpret_cast<const float*>(raw_data_->data.get()) : nullptr;
+    auto M = pq.M;
+
+#pragma omp parallel for if (n > 1)
+    for (int64_t q = 0; q < n; ++q) {
+        auto query = data + q * d;
+        std::vector<float> residual(d), lut(M * pq.ksub), recons(d);
+        std::vector<uint8_t> lut_q(faiss::pq4_padded_M(M) * 16);
+        std::vector<uint16_t> acc;
+        std::vector<Candidate> heap;
+        heap.reserve(num_candidates);
+
+        // table as a distance to minimize. Only the L2 residuals differ between lists, the inner product
+        // of a residual is the one of the query minus the coarse term, added back as a bias of the list
+        float scale, lut_bias;
+        bool lut_per_list = by_residual && !is_ip;
+        if (is_ip) {
+            pq.compute_inner_prod_table(query, lut.data());
+            for (auto& v : lut) {
+                v = -v;
+            }
+        } else if (!by_residual) {
+            pq.compute_distance_table(query, lut.data());
+        }
+        if (!lut_per_list) {
+            faiss::pq4_quantize_lut(lut.data(), M, lut_q.data(), scale, lut_bias);
+        }
+
+        for (size_t p = 0; p < nprobe; ++p) {
+            auto list_no = coarse_ids[q * nprobe + p];
+            if (list_no < 0) {
+                continue;
+            }
+            auto list_size = invlists->list_size(list_no);
+            if (list_size == 0) {
+                continue;
+            }
+
+            if (lut_per_list) {
+                ivfpq_index->quantizer->compute_residual(query, residual.data(), list_no);
+                pq.compute_distance_table(residual.data(), lut.data());
+                faiss::pq4_quantize_lut(lut.data(), M, lut_q.data(), scale, lut_bias);
+            }
+            float list_bias = lut_bias + (is_ip && by_residual ? -coarse_dis[q * nprobe + p] : 0);
+
+            auto nblocks = (list_size + faiss::pq4_block_size - 1) / faiss::pq4_block_size;
+            acc.resize(nblocks * faiss::pq4_block_size);
+            faiss::pq4_accumulate(packed_codes_[list_no].data(), nblocks, M, lut_q.data(), acc.data());
+
+            faiss::InvertedLists::ScopedIds ids(invlists, list_no);
+            for (size_t j = 0; j < list_size; ++j) {
+                if (bitset && bitset.test(ids[j])) {
+                    continue;
+                }
+                float dis = list_bias + acc[j] / scale;
+                if (heap.size() < num_candidates) {
+                    heap.push_back(Candidate{dis, list_no, static_cast<int64_t>(j), ids[j]});
+                    std::push_heap(heap.begin(), heap.end());
+                } else if (dis < heap.front().distance) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = Candidate{dis, list_no, static_cast<int64_t>(j), ids[j]};
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+        }
+
+        // exact distances of the candidates
+        for (auto& candidate : heap) {
+            const float* vec = raw ? raw + d * candidate.id : recons.data();
+            if (raw == nullptr) {
+                ivfpq_index->reconstruct_from_offset(candidate.list_no, candidate.offset, recons.data());
+            }
+            candidate.distance = is_ip ? -faiss::fvec_inner_product(query, vec, d) : faiss::fvec_L2sqr(query, vec, d);
+        }
+        std::sort(heap.begin(), heap.end());
+
+        auto dis_out = distances + q * k;
+        auto ids_out = labels + q * k;
+        for (int64_t i = 0; i < k; ++i) {
+            if (i < static_cast<int64_t>(heap.size())) {
+                dis_out[i] = is_ip ? -heap[i].distance : heap[i].distance;
+                ids_out[i] = heap[i].id;
+            } else {
+                dis_out[i] = is_ip ? -std::numeric_limits<float>::max() : std::numeric_limits<float>::max();
+                ids_out[i] = -1;
+            }
+        }
+    }
+
+    if (STATISTICS_LEVEL >= 1) {
+        auto ivf_stats = std::dynamic_pointer_cast<IVFStatistics>(stats);
+        auto lock = ivf_stats->Lock();
+        ivf_stats->update_nq(n);
+        ivf_stats->count_nprobe(nprobe);
+    }
+}
+
+}  // namespace knowhere
+}  // namespace milvus
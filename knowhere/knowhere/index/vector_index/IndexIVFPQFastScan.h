@@ -0,0 +1,90 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "knowhere/index/vector_index/IndexIVFPQ.h"
+
+namespace milvus {
+namespace knowhere {
+
+// IVFPQ with 4-bit sub-quantizers whose lists are scanned with 8-bit lookup tables held in SIMD registers
+// (faiss/impl/PQ4FastScan.h). The faiss index keeps the plain codes and is what gets serialized, the
+// packed copy used by the scan is rebuilt after Add and Load. The k * refine_k best candidates of the scan
+// are re-scored with exact distances, against RAW_DATA when it was loaded and against the PQ
+// reconstruction otherwise.
+class IVFPQFastScan : public IVFPQ {
+ public:
+    IVFPQFastScan() : IVFPQ() {
+        index_type_ = IndexEnum::INDEX_FAISS_IVFPQFASTSCAN;
+        stats = std::make_shared<milvus::knowhere::IVFStatistics>(index_type_);
+    }
+
+    explicit IVFPQFastScan(std::shared_ptr<faiss::Index> index) : IVFPQ(std::move(index)) {
+        index_type_ = IndexEnum::INDEX_FAISS_IVFPQFASTSCAN;
+        stats = std::make_shared<milvus::knowhere::IVFStatistics>(index_type_);
+        PackCodes();
+    }
+
+    void
+    Load(const BinarySet&) override;
+
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+
+    void
+    Train(const DatasetPtr&, const Config&) override;
+
+    void
+    AddWithoutIds(const DatasetPtr&, const Config&) override;
+
+    int64_t
+    Remove(const IDType*, int64_t) override;
+
+    void
+    Rebalance(const Config&) override;
+
+    VecIndexPtr
+    CopyCpuToGpu(const int64_t, const Config&) override;
+
+    void
+    UpdateIndexSize() override;
+
+ protected:
+    void
+    QueryImpl(int64_t, const float*, int64_t, float*, int64_t*, const Config&, const faiss::BitsetView) override;
+
+    // the scan re-scores its own candidates, against raw_data_ or the PQ reconstruction
+    bool
+    RefineWithRawData() const override {
+        return false;
+    }
+
+    bool
+    PruneByListRadius() const override {
+        return false;
+    }
+
+    void
+    PackCodes();
+
+ protected:
+    std::vector<std::vector<uint8_t>> packed_codes_;  // per inverted list
+};
+
+using IVFPQFastScanPtr = std::shared_ptr<IVFPQFastScan>;
+
+}  // namespace knowhere
+}  // namespace milvus
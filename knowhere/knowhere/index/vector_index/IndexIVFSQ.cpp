@@ -23,6 +23,7 @@
 #include "knowhere/common/Exception.h"
 #include "knowhere/index/vector_index/IndexIVFSQ.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/CoarseQuantizer.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #ifdef KNOWHERE_GPU_VERSION
 #include "knowhere/index/vector_index/gpu/IndexGPUIVFSQ.h"
@@ -32,14 +33,45 @@
 namespace milvus {
 namespace knowhere {
 
+namespace {
+
+faiss::QuantizerType
+GetQuantizerType(const Config& config) {
+    if (!config.contains(IndexParams::quantizer_type)) {
+        return faiss::QuantizerType::QT_8bit;
+    }
+    auto type = config[IndexParams::quantizer_type].get<std::string>();
+    if (type == SQType::QT_8BIT) {
+        return faiss::QuantizerType::QT_8bit;
+    }
+    if (type == SQType::QT_8BIT_UNIFORM) {
+        return faiss::QuantizerType::QT_8bit_uniform;
+    }
+    if (type == SQType::QT_6BIT) {
+        return faiss::QuantizerType::QT_6bit;
+    }
+    if (type == SQType::QT_4BIT) {
+        return faiss::QuantizerType::QT_4bit;
+    }
+    if (type == SQType::QT_FP16) {
+        return faiss::QuantizerType::QT_fp16;
+    }
+    if (type == SQType::QT_BF16) {
+        return faiss::QuantizerType::QT_bf16;
+    }
+    KNOWHERE_THROW_MSG("Quantizer type is invalid");
+}
+
+}  // namespace
+
 void
 IVFSQ::Train(const DatasetPtr& dataset_ptr, const Config& config) {
     GET_TENSOR_DATA_DIM(dataset_ptr)
 
     faiss::MetricType metric_type = GetMetricType(config[Metric::TYPE].get<std::string>());
-    faiss::Index* coarse_quantizer = new faiss::IndexFlat(dim, metric_type);
+    auto coarse_quantizer = BuildCoarseQuantizer(config, rows, static_cast<const float*>(p_data), dim, metric_type);
     auto index = std::make_shared<faiss::IndexIVFScalarQuantizer>(
-        coarse_quantizer, dim, config[IndexParams::nlist].get<int64_t>(), faiss::QuantizerType::QT_8bit, metric_type);
+        coarse_quantizer, dim, config[IndexParams::nlist].get<int64_t>(), GetQuantizerType(config), metric_type);
     index->own_fields = true;
     index->train(rows, reinterpret_cast<const float*>(p_data));
     index_ = index;
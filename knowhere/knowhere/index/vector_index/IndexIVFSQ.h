@@ -31,6 +31,8 @@ class IVFSQ : public IVF {
         stats = std::make_shared<milvus::knowhere::IVFStatistics>(index_type_);
     }
 
+    using VecIndex::Train;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
@@ -39,6 +41,12 @@ class IVFSQ : public IVF {
 
     void
     UpdateIndexSize() override;
+
+ protected:
+    bool
+    RefineWithRawData() const override {
+        return true;
+    }
 };
 
 using IVFSQPtr = std::shared_ptr<IVFSQ>;
@@ -14,8 +14,10 @@
 #include <omp.h>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/FaissIO.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 
 namespace milvus {
@@ -26,6 +28,12 @@ IndexNGT::Serialize(const Config& config) {
     if (!index_) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
+    if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
+        BinarySet res_set;
+        SerializeTo(config, res_set.AppendSink());
+        return res_set;
+    }
+
     std::stringstream obj, grp, prf, tre;
     index_->saveIndex(obj, grp, prf, tre);
 
@@ -52,12 +60,42 @@ IndexNGT::Serialize(const Config& config) {
     res_set.Append("ngt_grp_data", grp_data, grp_size);
     res_set.Append("ngt_prf_data", prf_data, prf_size);
     res_set.Append("ngt_tre_data", tre_data, tre_size);
-    if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
-        Disassemble(config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024, res_set);
-    }
     return res_set;
 }
 
+void
+IndexNGT::SerializeTo(const Config& config, const BinarySink& sink) {
+    if (!config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
+        VecIndex::SerializeTo(config, sink);
+        return;
+    }
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
+    // NGT can only serialize into string streams, slice them without the intermediate string copies
+    std::stringstream obj, grp, prf, tre;
+    index_->saveIndex(obj, grp, prf, tre);
+
+    auto slice_size = config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024;
+    milvus::json meta_info;
+    auto drain = [&](std::stringstream& ss, const std::string& name) {
+        SliceIOWriter writer(name, slice_size, sink);
+        std::vector<char> buf(1 << 16);
+        std::streamsize n;
+        while ((n = ss.rdbuf()->sgetn(buf.data(), buf.size())) > 0) {
+            writer(buf.data(), 1, n);
+        }
+        writer.Close(meta_info);
+        // release the stream memory before draining the next one
+        std::stringstream().swap(ss);
+    };
+    drain(obj, "ngt_obj_data");
+    drain(grp, "ngt_grp_data");
+    drain(prf, "ngt_prf_data");
+    drain(tre, "ngt_tre_data");
+    EmitSliceMeta(meta_info, sink);
+}
+
 void
 IndexNGT::Load(const BinarySet& index_binary) {
     Assemble(const_cast<BinarySet&>(index_binary));
@@ -123,28 +161,32 @@ IndexNGT::AddWithoutIds(const DatasetPtr& dataset_ptr, const Config& config) {
 
 DatasetPtr
 IndexNGT::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+    return QueryIntoDataset(dataset_ptr, config, bitset);
+}
+
+void
+IndexNGT::QueryInto(const float* query,
+                    int64_t rows,
+                    int64_t k,
+                    float* p_dist,
+                    int64_t* p_id,
+                    const Config& config,
+                    const faiss::BitsetView bitset) {
     if (!index_) {
         KNOWHERE_THROW_MSG("index not initialize");
     }
-    GET_TENSOR_DATA(dataset_ptr);
 
-    int k = config[meta::TOPK].get<int>();
     auto epsilon = config[IndexParams::epsilon].get<float>();
     auto edge_size = config[IndexParams::max_search_edges].get<int>();
     if (edge_size == -1) {  // pass -1
         edge_size--;
     }
-    size_t id_size = sizeof(int64_t) * k;
-    size_t dist_size = sizeof(float) * k;
-    auto p_id = static_cast<int64_t*>(malloc(id_size * rows));
-    auto p_dist = static_cast<float*>(malloc(dist_size * rows));
-
     NGT::Command::SearchParameter sp;
     sp.size = k;
 
 #pragma omp parallel for
     for (unsigned int i = 0; i < rows; ++i) {
-        const float* single_query = reinterpret_cast<float*>(const_cast<void*>(p_data)) + i * Dim();
+        const float* single_query = query + i * Dim();
 
         NGT::Object* object = index_->allocateObject(single_query, Dim());
         NGT::SearchContainer sc(*object);
@@ -186,14 +228,10 @@ IndexNGT::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss
         while (res_num < static_cast<int64_t>(k)) {
             *(local_id + res_num) = -1;
             *(local_dist + res_num) = 1.0 / 0.0;
+            ++res_num;
         }
         index_->deleteObject(object);
     }
-
-    auto res_ds = std::make_shared<Dataset>();
-    res_ds->Set(meta::IDS, p_id);
-    res_ds->Set(meta::DISTANCE, p_dist);
-    return res_ds;
 }
 
 int64_t
@@ -32,9 +32,17 @@ class IndexNGT : public VecIndex {
     BinarySet
     Serialize(const Config& config) override;
 
+    void
+    SerializeTo(const Config& config, const BinarySink& sink) override;
+
     void
     Load(const BinarySet& index_binary) override;
 
+    using VecIndex::BuildAll;
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
     void
     BuildAll(const DatasetPtr& dataset_ptr, const Config& config) override;
 
@@ -51,6 +59,15 @@ class IndexNGT : public VecIndex {
     DatasetPtr
     Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) override;
 
+    void
+    QueryInto(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset) override;
+
     int64_t
     Count() override;
 
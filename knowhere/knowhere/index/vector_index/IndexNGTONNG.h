@@ -22,6 +22,8 @@ class IndexNGTONNG : public IndexNGT {
         index_type_ = IndexEnum::INDEX_NGTONNG;
     }
 
+    using VecIndex::BuildAll;
+
     void
     BuildAll(const DatasetPtr& dataset_ptr, const Config& config) override;
 
@@ -22,6 +22,8 @@ class IndexNGTPANNG : public IndexNGT {
         index_type_ = IndexEnum::INDEX_NGTPANNG;
     }
 
+    using VecIndex::BuildAll;
+
     void
     BuildAll(const DatasetPtr& dataset_ptr, const Config& config) override;
 
@@ -22,6 +22,7 @@
 #include "knowhere/common/Log.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
 #include "knowhere/index/vector_index/helpers/FaissIO.h"
+#include "knowhere/index/vector_index/helpers/FilteredSearch.h"
 
 namespace milvus {
 namespace knowhere {
@@ -99,15 +100,22 @@ IndexRHNSW::AddWithoutIds(const DatasetPtr& dataset_ptr, const Config& config) {
 
 DatasetPtr
 IndexRHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+    return QueryIntoDataset(dataset_ptr, config, bitset);
+}
+
+void
+IndexRHNSW::QueryInto(const float* query,
+                      int64_t rows,
+                      int64_t k,
+                      float* p_dist,
+                      int64_t* p_id,
+                      const Config& config,
+                      const faiss::BitsetView bitset) {
     if (!index_) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
-    GET_TENSOR_DATA(dataset_ptr)
-    auto k = config[meta::TOPK].get<int64_t>();
     auto result_count = rows * k;
 
-    auto p_id = static_cast<int64_t*>(malloc(result_count * sizeof(int64_t)));
-    auto p_dist = static_cast<float*>(malloc(result_count * sizeof(float)));
     for (int64_t i = 0; i < result_count; ++i) {
         p_id[i] = -1;
         p_dist[i] = -1;
@@ -115,11 +123,23 @@ IndexRHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const fai
 
     auto real_index = dynamic_cast<faiss::IndexRHNSW*>(index_.get());
 
-    real_index->hnsw.efSearch = (config[IndexParams::ef].get<int64_t>());
+    auto plan = PlanFilteredSearch(bitset, Count(), config[IndexParams::ef].get<int64_t>(), k, real_index->hnsw.M * 2);
+    real_index->hnsw.efSearch = plan.ef;
+    auto filter_mode = faiss::RHNSW::FILTER_WALK;
+    switch (plan.mode) {
+        case FilteredSearchMode::TWO_HOP:
+            filter_mode = faiss::RHNSW::FILTER_TWO_HOP;
+            break;
+        case FilteredSearchMode::BRUTE_FORCE:
+            filter_mode = faiss::RHNSW::FILTER_BRUTE_FORCE;
+            break;
+        default:
+            break;
+    }
 
     std::chrono::high_resolution_clock::time_point query_start, query_end;
     query_start = std::chrono::high_resolution_clock::now();
-    real_index->search(rows, reinterpret_cast<const float*>(p_data), k, p_dist, p_id, bitset);
+    real_index->search(rows, query, k, p_dist, p_id, bitset, filter_mode);
     query_end = std::chrono::high_resolution_clock::now();
     if (STATISTICS_LEVEL) {
         auto hnsw_stats = std::dynamic_pointer_cast<RHNSWStatistics>(stats);
@@ -138,11 +158,6 @@ IndexRHNSW::Query(const DatasetPtr& dataset_ptr, const Config& config, const fai
     //     LOG_KNOWHERE_DEBUG_ << GetStatistics()->ToString();
 
     MapOffsetToUid(p_id, result_count);
-
-    auto ret_ds = std::make_shared<Dataset>();
-    ret_ds->Set(meta::IDS, p_id);
-    ret_ds->Set(meta::DISTANCE, p_dist);
-    return ret_ds;
 }
 
 int64_t
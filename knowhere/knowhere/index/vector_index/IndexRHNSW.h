@@ -44,6 +44,10 @@ class IndexRHNSW : public VecIndex, public FaissBaseIndex {
     void
     Load(const BinarySet& index_binary) override;
 
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
     void
     Train(const DatasetPtr& dataset_ptr, const Config& config) override;
 
@@ -53,6 +57,15 @@ class IndexRHNSW : public VecIndex, public FaissBaseIndex {
     DatasetPtr
     Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) override;
 
+    void
+    QueryInto(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset) override;
+
     int64_t
     Count() override;
 
@@ -40,6 +40,8 @@ class IndexRHNSWFlat : public IndexRHNSW {
     void
     Load(const BinarySet& index_binary) override;
 
+    using VecIndex::Train;
+
     void
     Train(const DatasetPtr& dataset_ptr, const Config& config) override;
 
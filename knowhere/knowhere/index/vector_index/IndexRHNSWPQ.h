@@ -39,6 +39,8 @@ class IndexRHNSWPQ : public IndexRHNSW {
     void
     Load(const BinarySet& index_binary) override;
 
+    using VecIndex::Train;
+
     void
     Train(const DatasetPtr& dataset_ptr, const Config& config) override;
 
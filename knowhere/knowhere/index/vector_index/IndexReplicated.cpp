@@ -0,0 +1,214 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "knowhere/index/vector_index/IndexReplicated.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "knowhere/common/Log.h"
+#include "knowhere/index/vector_index/VecIndexFactory.h"
+
+namespace milvus {
+namespace knowhere {
+
+namespace {
+
+// parses a sysfs list such as "0-3,8,10-11"
+std::vector<int64_t>
+ParseSysfsList(const std::string& path) {
+    std::vector<int64_t> result;
+    std::ifstream in(path);
+    std::string list;
+    if (!in.is_open() || !std::getline(in, list)) {
+        return result;
+    }
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        auto dash = item.find('-');
+        int64_t lo = std::stoll(item.substr(0, dash));
+        int64_t hi = (dash == std::string::npos) ? lo : std::stoll(item.substr(dash + 1));
+        for (int64_t i = lo; i <= hi; ++i) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+ReplicatedIndex::ReplicatedIndex(const IndexType& type, const std::vector<int64_t>& numa_nodes) : nodes_(numa_nodes) {
+    index_type_ = type;
+    if (nodes_.empty()) {
+        nodes_ = OnlineNodes();
+    }
+}
+
+BinarySet
+ReplicatedIndex::Serialize(const Config& config) {
+    if (replicas_.empty()) {
+        KNOWHERE_THROW_MSG("index not initialize");
+    }
+    return replicas_[0]->Serialize(config);
+}
+
+void
+ReplicatedIndex::Load(const BinarySet& index_binary) {
+    std::vector<VecIndexPtr> replicas(nodes_.size());
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        std::exception_ptr error = nullptr;
+        // load from a thread pinned to the node, so that first touch of the payload happens there too
+        std::thread loader([&]() {
+            try {
+                auto node = nodes_[i];
+                if (!PinCurrentThread(node)) {
+                    LOG_KNOWHERE_WARNING_ << "ReplicatedIndex can't pin the loader to numa node " << node;
+                }
+                faiss::PayloadNumaScope numa_scope(static_cast<int>(node));
+
+                // each replica gets its own copy of the binaries mapped from a file, Load() would share them
+                BinarySet binary_set;
+                for (auto& kv : index_binary.binary_map_) {
+                    if (kv.second->mapped) {
+                        std::shared_ptr<uint8_t[]> data(CopyBinary(kv.second));
+                        binary_set.Append(kv.first, data, kv.second->size);
+                    } else {
+                        binary_set.Append(kv.first, kv.second);
+                    }
+                }
+
+                auto replica = VecIndexFactory::GetInstance().CreateVecIndex(index_type_, IndexMode::MODE_CPU);
+                if (replica == nullptr) {
+                    KNOWHERE_THROW_MSG("ReplicatedIndex doesn't support index type " + index_type_);
+                }
+                replica->Load(binary_set);
+                replicas[i] = replica;
+            } catch (...) {
+                error = std::current_exception();
+            }
+        });
+        loader.join();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    replicas_.swap(replicas);
+}
+
+VecIndexPtr
+ReplicatedIndex::Replica(int64_t numa_node) {
+    if (replicas_.empty()) {
+        KNOWHERE_THROW_MSG("index not initialize");
+    }
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodes_[i] == numa_node) {
+            return replicas_[i];
+        }
+    }
+    return replicas_[0];
+}
+
+DatasetPtr
+ReplicatedIndex::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+    return QueryIntoDataset(dataset_ptr, config, bitset);
+}
+
+void
+ReplicatedIndex::QueryInto(const float* query,
+                           int64_t nq,
+                           int64_t k,
+                           float* distances,
+                           int64_t* ids,
+                           const Config& config,
+                           const faiss::BitsetView bitset) {
+    // replicas hold no uids, offsets are mapped here
+    Replica(CurrentNode())->QueryInto(query, nq, k, distances, ids, config, bitset);
+    MapOffsetToUid(ids, static_cast<size_t>(nq * k));
+}
+
+int64_t
+ReplicatedIndex::Count() {
+    return Replica(0)->Count();
+}
+
+int64_t
+ReplicatedIndex::Dim() {
+    return Replica(0)->Dim();
+}
+
+void
+ReplicatedIndex::UpdateIndexSize() {
+    int64_t size = 0;
+    for (auto& replica : replicas_) {
+        replica->UpdateIndexSize();
+        size += replica->IndexSize();
+    }
+    index_size_ = size;
+}
+
+faiss::PayloadPlacement
+ReplicatedIndex::GetPayloadPlacement() {
+    faiss::PayloadPlacement placement;
+    for (auto& replica : replicas_) {
+        placement.merge(replica->GetPayloadPlacement());
+    }
+    return placement;
+}
+
+int64_t
+ReplicatedIndex::CurrentNode() {
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return 0;
+    }
+    return node;
+}
+
+std::vector<int64_t>
+ReplicatedIndex::OnlineNodes() {
+    auto nodes = ParseSysfsList("/sys/devices/system/node/online");
+    if (nodes.empty()) {
+        nodes.push_back(0);
+    }
+    return nodes;
+}
+
+bool
+ReplicatedIndex::PinCurrentThread(int64_t numa_node) {
+    auto cpus = ParseSysfsList("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist");
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+}  // namespace knowhere
+}  // namespace milvus
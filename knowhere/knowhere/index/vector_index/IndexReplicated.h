@@ -0,0 +1,104 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "knowhere/common/Exception.h"
+#include "knowhere/index/vector_index/VecIndex.h"
+
+namespace milvus {
+namespace knowhere {
+
+// Read-only index holding one loaded copy of another index per NUMA node. Each replica is loaded by a
+// thread pinned to its node, so its payload is local to that node, and queries go to the replica of the
+// node the calling thread runs on. Serving threads should be pinned with PinCurrentThread().
+class ReplicatedIndex : public VecIndex {
+ public:
+    // numa_nodes: one replica per entry, all online nodes when empty
+    explicit ReplicatedIndex(const IndexType& type, const std::vector<int64_t>& numa_nodes = {});
+
+    BinarySet
+    Serialize(const Config& config) override;
+
+    void
+    Load(const BinarySet& index_binary) override;
+
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
+    void
+    Train(const DatasetPtr&, const Config&) override {
+        KNOWHERE_THROW_MSG("ReplicatedIndex is read-only, build the index before replicating it");
+    }
+
+    void
+    AddWithoutIds(const DatasetPtr&, const Config&) override {
+        KNOWHERE_THROW_MSG("ReplicatedIndex is read-only, build the index before replicating it");
+    }
+
+    DatasetPtr
+    Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) override;
+
+    void
+    QueryInto(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset) override;
+
+    int64_t
+    Count() override;
+
+    int64_t
+    Dim() override;
+
+    void
+    UpdateIndexSize() override;
+
+    faiss::PayloadPlacement
+    GetPayloadPlacement() override;
+
+    // replica serving the given node, the first replica when the node has none
+    VecIndexPtr
+    Replica(int64_t numa_node);
+
+    const std::vector<int64_t>&
+    Nodes() const {
+        return nodes_;
+    }
+
+    // NUMA node of the calling thread, 0 when it can't be determined
+    static int64_t
+    CurrentNode();
+
+    // ids of the online NUMA nodes
+    static std::vector<int64_t>
+    OnlineNodes();
+
+    // restrict the calling thread to the cpus of numa_node, returns false when that is not possible
+    static bool
+    PinCurrentThread(int64_t numa_node);
+
+ private:
+    std::vector<int64_t> nodes_;
+    std::vector<VecIndexPtr> replicas_;
+};
+
+using ReplicatedIndexPtr = std::shared_ptr<ReplicatedIndex>;
+
+}  // namespace knowhere
+}  // namespace milvus
@@ -33,6 +33,11 @@ class CPUSPTAGRNG : public VecIndex {
     void
     Load(const BinarySet& index_array) override;
 
+    using VecIndex::BuildAll;
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
     void
     BuildAll(const DatasetPtr&, const Config&) override;
 
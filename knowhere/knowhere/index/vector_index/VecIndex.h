@@ -11,17 +11,29 @@
 
 #pragma once
 
+#include <faiss/utils/PayloadMemory.h>
+
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
+#include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "knowhere/common/Dataset.h"
 #include "knowhere/common/Exception.h"
+#include "knowhere/common/Log.h"
+#include "knowhere/common/ThreadPool.h"
 #include "knowhere/common/Typedef.h"
 #include "knowhere/common/Utils.h"
 #include "knowhere/index/Index.h"
 #include "knowhere/index/IndexType.h"
 #include "knowhere/index/vector_index/Statistics.h"
+#include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/SearchContext.h"
 #include "knowhere/utils/BitsetView.h"
 
 #ifdef __linux__
@@ -51,6 +63,153 @@ class VecIndex : public Index {
     virtual DatasetPtr
     Query(const DatasetPtr& dataset, const Config& config, const faiss::BitsetView bitset) = 0;
 
+    // AddWithoutIds() for an index that may already hold entries, e.g. after Load(). uids are the ids of the
+    // new rows, required once SetUids() was called; without them the rows are known by their offset.
+    void
+    Add(const DatasetPtr& dataset, const IDType* uids, const Config& config) {
+        if (uids_ && uids == nullptr) {
+            KNOWHERE_THROW_MSG("the index has uids, the added rows need theirs");
+        }
+        auto ntotal = Count();
+        AddWithoutIds(dataset, config);
+        if (uids != nullptr) {
+            auto rows = dataset->Get<int64_t>(meta::ROWS);
+            auto new_uids = std::make_shared<std::vector<IDType>>();
+            new_uids->reserve(ntotal + rows);
+            for (int64_t i = 0; i < ntotal; ++i) {
+                new_uids->push_back(uids_ ? uids_->at(i) : i);
+            }
+            new_uids->insert(new_uids->end(), uids, uids + rows);
+            uids_ = new_uids;
+        }
+    }
+
+    // Physically drops the entries of the n ids (uids once set) and returns how many were found. The other
+    // entries are renumbered to dense offsets, so bitsets of later queries index the remaining entries, while
+    // the ids returned by queries are unchanged.
+    virtual int64_t
+    Remove(const IDType* ids, int64_t n) {
+        KNOWHERE_THROW_MSG("Remove is not supported by " + index_type_);
+    }
+
+    // DatasetView flavors of the entry points, the indexes pull them in next to their Dataset overloads.
+    // Query() goes straight to QueryInto(), the others build a legacy Dataset as they are not on the hot
+    // path. Views of a built index must match its Dim(), QueryInto() trusts the row width.
+    void
+    BuildAll(const DatasetView& view, const Config& config) {
+        BuildAll(GenDataset(view), config);
+    }
+
+    void
+    Train(const DatasetView& view, const Config& config) {
+        Train(GenDataset(view), config);
+    }
+
+    void
+    AddWithoutIds(const DatasetView& view, const Config& config) {
+        CheckViewDim(view);
+        AddWithoutIds(GenDataset(view), config);
+    }
+
+    // results are written into result.ids and result.distances (query.rows * k elements), nothing is allocated
+    void
+    Query(const DatasetView& query, const DatasetView& result, const Config& config, const faiss::BitsetView bitset) {
+        if (result.ids == nullptr || result.distances == nullptr) {
+            KNOWHERE_THROW_MSG("result ids and distances must be provided");
+        }
+        CheckViewDim(query);
+        QueryInto(static_cast<const float*>(query.tensor), query.rows, config[meta::TOPK].get<int64_t>(),
+                  result.distances, result.ids, config, bitset);
+    }
+
+    DatasetPtr
+    Query(const DatasetView& query, const Config& config, const faiss::BitsetView bitset) {
+        CheckViewDim(query);
+        auto k = config[meta::TOPK].get<int64_t>();
+        auto p_id = static_cast<int64_t*>(malloc(sizeof(int64_t) * query.rows * k));
+        auto p_dist = static_cast<float*>(malloc(sizeof(float) * query.rows * k));
+        try {
+            QueryInto(static_cast<const float*>(query.tensor), query.rows, k, p_dist, p_id, config, bitset);
+        } catch (...) {
+            free(p_id);
+            free(p_dist);
+            throw;
+        }
+
+        auto ret_ds = std::make_shared<Dataset>();
+        ret_ds->Set(meta::IDS, p_id);
+        ret_ds->Set(meta::DISTANCE, p_dist);
+        return ret_ds;
+    }
+
+    // Search nq queries of Dim() floats, writing the k nearest ids and distances of every query
+    // into caller-provided buffers of nq * k elements. Indexes that implement it natively don't
+    // allocate anything for the result, so callers can reuse their buffers across requests.
+    virtual void
+    QueryInto(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset) {
+        auto query_config = config;
+        query_config[meta::TOPK] = k;
+        auto result = Query(GenDataset(nq, Dim(), query), query_config, bitset);
+        memcpy(ids, result->Get<int64_t*>(meta::IDS), sizeof(int64_t) * nq * k);
+        memcpy(distances, result->Get<float*>(meta::DISTANCE), sizeof(float) * nq * k);
+    }
+
+    using QueryCallback = std::function<void(const DatasetPtr& result, std::exception_ptr error)>;
+
+    // Query() run on the knowhere thread pool (KnowhereConfig::SetQueryThreadPoolSize), one pool thread per
+    // query with OpenMP limited to that thread. The index and the memory behind dataset and bitset must stay
+    // alive until the query completes.
+    std::future<DatasetPtr>
+    QueryAsync(const DatasetPtr& dataset, const Config& config, const faiss::BitsetView bitset) {
+        return ThreadPool::GetGlobalThreadPool()->Push(
+            [this, dataset, config, bitset]() { return Query(dataset, config, bitset); });
+    }
+
+    // same, handing the result or the error to callback on the pool thread. Nobody waits on the task, so an
+    // exception thrown by the callback is logged and dropped
+    void
+    QueryAsync(const DatasetPtr& dataset,
+               const Config& config,
+               const faiss::BitsetView bitset,
+               QueryCallback callback) {
+        ThreadPool::GetGlobalThreadPool()->Push([this, dataset, config, bitset, callback]() {
+            DatasetPtr result;
+            std::exception_ptr error = nullptr;
+            try {
+                result = Query(dataset, config, bitset);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            try {
+                callback(result, error);
+            } catch (std::exception& e) {
+                LOG_KNOWHERE_ERROR_ << "QueryAsync callback failed: " << e.what();
+            } catch (...) {
+                LOG_KNOWHERE_ERROR_ << "QueryAsync callback failed";
+            }
+        });
+    }
+
+    // QueryInto() run serially on the calling thread, the graph indexes take all their scratch memory from
+    // ctx. Meant for serving workers that own one context each and handle one request at a time.
+    virtual void
+    QueryWithContext(const float* query,
+                     int64_t nq,
+                     int64_t k,
+                     float* distances,
+                     int64_t* ids,
+                     const Config& config,
+                     const faiss::BitsetView bitset,
+                     SearchContext& ctx) {
+        QueryInto(query, nq, k, distances, ids, config, bitset);
+    }
+
     virtual int64_t
     Dim() = 0;
 
@@ -138,12 +297,63 @@ class VecIndex : public Index {
     UpdateIndexSize() {
     }
 
+    // how the main payload (vectors, codes, level0 graph) is backed in memory, see KnowhereConfig::SetPayloadMemory
+    virtual faiss::PayloadPlacement
+    GetPayloadPlacement() {
+        return faiss::PayloadPlacement();
+    }
+
     int64_t
     Size() override {
         return UidsSize() + IndexSize();
     }
 
  protected:
+    // payload data of an unmapped binary, copied to memory following KnowhereConfig::SetPayloadMemory when
+    // the policy applies to its size: the binary's own buffer may share pages with other heap objects
+    static std::shared_ptr<uint8_t[]>
+    PayloadData(const BinaryPtr& binary) {
+        auto data = static_cast<uint8_t*>(faiss::payload_copy(binary->data.get(), binary->size));
+        if (data == nullptr) {
+            return binary->data;
+        }
+        return std::shared_ptr<uint8_t[]>(data, faiss::payload_free);
+    }
+
+    // For Remove(): new_offsets[o] is the offset of entry o once the entries of the n ids are dropped, -1 for
+    // those. Returns the ids of the remaining entries for uids_, nullptr when none of the ids is found.
+    std::shared_ptr<std::vector<IDType>>
+    CompactOffsets(const IDType* ids, int64_t n, int64_t ntotal, std::vector<int64_t>& new_offsets) {
+        std::unordered_set<IDType> removed(ids, ids + n);
+        auto new_uids = std::make_shared<std::vector<IDType>>();
+        new_offsets.resize(ntotal);
+        for (int64_t i = 0; i < ntotal; ++i) {
+            auto id = uids_ ? uids_->at(i) : i;
+            if (removed.count(id)) {
+                new_offsets[i] = -1;
+            } else {
+                new_offsets[i] = new_uids->size();
+                new_uids->push_back(id);
+            }
+        }
+        return static_cast<int64_t>(new_uids->size()) < ntotal ? new_uids : nullptr;
+    }
+
+    void
+    CheckViewDim(const DatasetView& view) {
+        if (view.dim != Dim()) {
+            KNOWHERE_THROW_MSG("dataset dim " + std::to_string(view.dim) + " does not match index dim " +
+                               std::to_string(Dim()));
+        }
+    }
+
+    // Query() for indexes implementing QueryInto(), the result buffers are owned by the returned dataset
+    DatasetPtr
+    QueryIntoDataset(const DatasetPtr& dataset, const Config& config, const faiss::BitsetView bitset) {
+        GET_TENSOR_DATA(dataset)
+        return Query(DatasetView(rows, Dim(), p_data), config, bitset);
+    }
+
     IndexType index_type_ = "";
     IndexMode index_mode_ = IndexMode::MODE_CPU;
     std::shared_ptr<std::vector<IDType>> uids_ = nullptr;
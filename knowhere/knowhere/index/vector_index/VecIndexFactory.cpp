@@ -22,12 +22,14 @@
 #include "knowhere/index/vector_index/IndexIDMAP.h"
 #include "knowhere/index/vector_index/IndexIVF.h"
 #include "knowhere/index/vector_index/IndexIVFPQ.h"
+#include "knowhere/index/vector_index/IndexIVFPQFastScan.h"
 #include "knowhere/index/vector_index/IndexIVFSQ.h"
 #include "knowhere/index/vector_index/IndexNGTONNG.h"
 #include "knowhere/index/vector_index/IndexNGTPANNG.h"
 #include "knowhere/index/vector_index/IndexRHNSWFlat.h"
 #include "knowhere/index/vector_index/IndexRHNSWPQ.h"
 #include "knowhere/index/vector_index/IndexRHNSWSQ.h"
+#include "knowhere/index/vector_offset_index/IndexHNSW_NM.h"
 #include "knowhere/index/vector_offset_index/IndexIVF_NM.h"
 #include "knowhere/index/vector_offset_index/IndexNSG_NM.h"
 
@@ -72,6 +74,8 @@ VecIndexFactory::CreateVecIndex(const IndexType& type, const IndexMode mode) {
         }
 #endif
         return std::make_shared<knowhere::IVFPQ>();
+    } else if (type == IndexEnum::INDEX_FAISS_IVFPQFASTSCAN) {
+        return std::make_shared<knowhere::IVFPQFastScan>();
     } else if (type == IndexEnum::INDEX_FAISS_IVFSQ8) {
 #ifdef KNOWHERE_GPU_VERSION
         if (mode == IndexMode::MODE_GPU) {
@@ -97,6 +101,8 @@ VecIndexFactory::CreateVecIndex(const IndexType& type, const IndexMode mode) {
 #endif
     } else if (type == IndexEnum::INDEX_HNSW) {
         return std::make_shared<knowhere::IndexHNSW>();
+    } else if (type == IndexEnum::INDEX_HNSW_NM) {
+        return std::make_shared<knowhere::IndexHNSW_NM>();
     } else if (type == IndexEnum::INDEX_ANNOY) {
         return std::make_shared<knowhere::IndexAnnoy>();
     } else if (type == IndexEnum::INDEX_RHNSWFlat) {
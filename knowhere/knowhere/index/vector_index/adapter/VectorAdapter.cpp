@@ -27,5 +27,10 @@ GenDataset(const int64_t nb, const int64_t dim, const void* xb) {
     return ret_ds;
 }
 
+DatasetPtr
+GenDataset(const DatasetView& view) {
+    return GenDataset(view.rows, view.dim, view.tensor);
+}
+
 }  // namespace knowhere
 }  // namespace milvus
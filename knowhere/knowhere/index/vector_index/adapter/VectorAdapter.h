@@ -29,5 +29,9 @@ namespace knowhere {
 extern DatasetPtr
 GenDataset(const int64_t nb, const int64_t dim, const void* xb);
 
+// legacy dataset over the rows of view, ids and distances are left out since a Dataset frees them
+extern DatasetPtr
+GenDataset(const DatasetView& view);
+
 }  // namespace knowhere
 }  // namespace milvus
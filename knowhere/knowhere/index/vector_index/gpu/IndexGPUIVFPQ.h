@@ -30,6 +30,8 @@ class GPUIVFPQ : public GPUIVF {
         index_type_ = IndexEnum::INDEX_FAISS_IVFPQ;
     }
 
+    using VecIndex::Train;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
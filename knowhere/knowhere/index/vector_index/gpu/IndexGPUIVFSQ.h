@@ -30,6 +30,8 @@ class GPUIVFSQ : public GPUIVF {
         index_type_ = IndexEnum::INDEX_FAISS_IVFSQ8;
     }
 
+    using VecIndex::Train;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
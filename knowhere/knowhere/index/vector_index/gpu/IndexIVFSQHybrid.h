@@ -55,6 +55,8 @@ class IVFSQHybrid : public GPUIVFSQ {
     }
 
  public:
+    using VecIndex::Train;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
@@ -0,0 +1,95 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <faiss/Clustering.h>
+#include <faiss/IndexFlat.h>
+#include <faiss/IndexHNSW.h>
+#include <faiss/IndexIVFFlat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "knowhere/common/Exception.h"
+#include "knowhere/index/vector_index/helpers/CoarseQuantizer.h"
+#include "knowhere/index/vector_index/helpers/IndexParameter.h"
+
+namespace milvus {
+namespace knowhere {
+
+namespace {
+
+constexpr int64_t DEFAULT_HNSW_M = 32;
+constexpr int64_t DEFAULT_HNSW_EFCONSTRUCTION = 200;
+constexpr int64_t DEFAULT_COARSE_NPROBE = 8;
+
+int64_t
+GetInt(const Config& config, const char* key, int64_t default_value) {
+    return config.contains(key) ? config[key].get<int64_t>() : default_value;
+}
+
+}  // namespace
+
+faiss::Index*
+BuildCoarseQuantizer(const Config& config,
+                     int64_t rows,
+                     const float* data,
+                     int64_t dim,
+                     faiss::MetricType metric_type) {
+    std::string type = config.contains(IndexParams::coarse_quantizer)
+                           ? config[IndexParams::coarse_quantizer].get<std::string>()
+                           : CoarseQuantizerType::FLAT;
+    if (type == CoarseQuantizerType::FLAT) {
+        return new faiss::IndexFlat(dim, metric_type);
+    }
+    if (type != CoarseQuantizerType::HNSW && type != CoarseQuantizerType::IVF) {
+        KNOWHERE_THROW_MSG("Invalid coarse quantizer: " + type);
+    }
+
+    // the centroids, as the IVF training would compute them with a flat quantizer
+    auto nlist = config[IndexParams::nlist].get<int64_t>();
+    faiss::Clustering clus(dim, nlist);
+    faiss::IndexFlat assigner(dim, metric_type);
+    clus.train(rows, data, assigner);
+
+    if (type == CoarseQuantizerType::HNSW) {
+        auto quantizer = new faiss::IndexHNSWFlat(dim, GetInt(config, IndexParams::M, DEFAULT_HNSW_M), metric_type);
+        quantizer->hnsw.efConstruction = GetInt(config, IndexParams::efConstruction, DEFAULT_HNSW_EFCONSTRUCTION);
+        quantizer->add(nlist, clus.centroids.data());
+        return quantizer;
+    }
+
+    // two levels: an IVF over the centroids, with a direct map to reconstruct them
+    auto coarse_nlist = std::min(GetInt(config, IndexParams::coarse_nlist, std::lround(std::sqrt(nlist))), nlist);
+    auto quantizer = new faiss::IndexIVFFlat(new faiss::IndexFlat(dim, metric_type), dim, coarse_nlist, metric_type);
+    quantizer->own_fields = true;
+    quantizer->train(nlist, clus.centroids.data());
+    quantizer->add(nlist, clus.centroids.data());
+    quantizer->make_direct_map(true);
+    quantizer->nprobe = std::min(DEFAULT_COARSE_NPROBE, coarse_nlist);
+    return quantizer;
+}
+
+void
+SetCoarseQuantizerParams(faiss::Index* quantizer, const Config& config) {
+    if (auto hnsw = dynamic_cast<faiss::IndexHNSW*>(quantizer)) {
+        if (config.contains(IndexParams::ef)) {
+            hnsw->hnsw.efSearch = config[IndexParams::ef].get<int64_t>();
+        }
+    } else if (auto ivf = dynamic_cast<faiss::IndexIVF*>(quantizer)) {
+        if (config.contains(IndexParams::coarse_nprobe)) {
+            ivf->nprobe = std::min(static_cast<size_t>(config[IndexParams::coarse_nprobe].get<int64_t>()), ivf->nlist);
+        }
+    }
+}
+
+}  // namespace knowhere
+}  // namespace milvus
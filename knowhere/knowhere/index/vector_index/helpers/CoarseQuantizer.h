@@ -0,0 +1,33 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <faiss/Index.h>
+
+#include "knowhere/common/Config.h"
+
+namespace milvus {
+namespace knowhere {
+
+// Coarse quantizer of an IVF index, as chosen by IndexParams::coarse_quantizer (one of CoarseQuantizerType).
+// FLAT, the default, is returned untrained for the IVF training to fill. HNSW and IVF (two-level) quantizers
+// are built over the nlist k-means centroids of data, so that the IVF training keeps them. They are
+// serialized with the IVF index.
+faiss::Index*
+BuildCoarseQuantizer(const Config& config, int64_t rows, const float* data, int64_t dim, faiss::MetricType metric_type);
+
+// search parameters of a quantizer made by BuildCoarseQuantizer(): ef for HNSW, coarse_nprobe for IVF
+void
+SetCoarseQuantizerParams(faiss::Index* quantizer, const Config& config);
+
+}  // namespace knowhere
+}  // namespace milvus
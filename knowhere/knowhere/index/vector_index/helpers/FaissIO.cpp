@@ -9,9 +9,12 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <algorithm>
 #include <cstring>
+#include <utility>
 
 #include "knowhere/common/Log.h"
+#include "knowhere/common/Utils.h"
 #include "knowhere/index/vector_index/helpers/FaissIO.h"
 
 namespace milvus {
@@ -49,6 +52,69 @@ MemoryIOWriter::operator()(const void* ptr, size_t size, size_t nitems) {
     return nitems;
 }
 
+SliceIOWriter::SliceIOWriter(std::string name, size_t slice_size, BinarySink sink)
+    : name_(std::move(name)), slice_size_(slice_size), sink_(std::move(sink)) {
+    if (slice_size_ == 0) {
+        KNOWHERE_THROW_MSG("slice size must be positive");
+    }
+}
+
+SliceIOWriter::~SliceIOWriter() {
+    delete[] data_;
+}
+
+size_t
+SliceIOWriter::operator()(const void* ptr, size_t size, size_t nitems) {
+    auto src = static_cast<const uint8_t*>(ptr);
+    size_t remain = size * nitems;
+    while (remain > 0) {
+        if (data_ == nullptr) {
+            total = slice_size_;
+            rp = 0;
+            data_ = new uint8_t[total];
+        } else if (rp == total) {
+            // only emitted once more data arrives, an exactly full last slice stays unsliced
+            EmitSlice(name_ + "_" + std::to_string(slice_num_++));
+            continue;
+        }
+        size_t n = std::min(remain, total - rp);
+        memcpy(data_ + rp, src, n);
+        rp += n;
+        src += n;
+        remain -= n;
+    }
+    written_ += size * nitems;
+    return nitems;
+}
+
+void
+SliceIOWriter::EmitSlice(const std::string& name) {
+    // only the last slice can be partly filled, it is handed over without the unused rest of slice_size_
+    if (data_ != nullptr && rp < total) {
+        auto fitted = new uint8_t[rp];
+        memcpy(fitted, data_, rp);
+        delete[] data_;
+        data_ = fitted;
+        total = rp;
+    }
+    auto binary = std::make_shared<Binary>();
+    binary->data = std::shared_ptr<uint8_t[]>(data_);
+    binary->size = rp;
+    data_ = nullptr;
+    rp = 0;
+    sink_(name, binary);
+}
+
+void
+SliceIOWriter::Close(milvus::json& meta_info) {
+    if (slice_num_ == 0) {
+        EmitSlice(name_);
+        return;
+    }
+    EmitSlice(name_ + "_" + std::to_string(slice_num_++));
+    AppendSliceMeta(meta_info, name_, slice_num_, written_);
+}
+
 size_t
 MemoryIOReader::operator()(void* ptr, size_t size, size_t nitems) {
     if (rp >= total) {
@@ -63,5 +129,15 @@ MemoryIOReader::operator()(void* ptr, size_t size, size_t nitems) {
     return nitems;
 }
 
+const uint8_t*
+MemoryIOReader::read_in_place(size_t nbytes) {
+    if (rp > total || total - rp < nbytes) {
+        return nullptr;
+    }
+    auto ptr = data_ + rp;
+    rp += nbytes;
+    return ptr;
+}
+
 }  // namespace knowhere
 }  // namespace milvus
@@ -13,6 +13,11 @@
 
 #include <faiss/impl/io.h>
 
+#include <string>
+
+#include "knowhere/common/BinarySet.h"
+#include "knowhere/common/Config.h"
+
 namespace milvus {
 namespace knowhere {
 
@@ -31,6 +36,32 @@ struct MemoryIOWriter : public faiss::IOWriter {
     }
 };
 
+// Writes into fixed-size slices instead of one growing buffer. A slice is handed to the sink
+// as soon as it is full, named and described the way Disassemble() does so that Assemble()
+// reads it back. Data that fits into a single slice is handed over unsliced under name.
+struct SliceIOWriter : public MemoryIOWriter {
+    SliceIOWriter(std::string name, size_t slice_size, BinarySink sink);
+
+    ~SliceIOWriter();
+
+    size_t
+    operator()(const void* ptr, size_t size, size_t nitems) override;
+
+    // hand the last slice over and record the slices written in meta_info
+    void
+    Close(milvus::json& meta_info);
+
+ private:
+    void
+    EmitSlice(const std::string& name);
+
+    std::string name_;
+    size_t slice_size_;
+    BinarySink sink_;
+    int slice_num_ = 0;
+    int64_t written_ = 0;
+};
+
 struct MemoryIOReader : public faiss::IOReader {
     uint8_t* data_;
     size_t rp = 0;
@@ -39,6 +70,9 @@ struct MemoryIOReader : public faiss::IOReader {
     size_t
     operator()(void* ptr, size_t size, size_t nitems) override;
 
+    const uint8_t*
+    read_in_place(size_t nbytes) override;
+
     template <typename T>
     size_t
     read(T* ptr, size_t size, size_t nitems = 1) {
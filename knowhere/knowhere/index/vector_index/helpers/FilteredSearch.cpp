@@ -0,0 +1,50 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "knowhere/index/vector_index/helpers/FilteredSearch.h"
+
+#include <algorithm>
+
+namespace milvus {
+namespace knowhere {
+
+namespace {
+
+constexpr double TWO_HOP_FILTER_RATIO = 0.5;
+constexpr double EXPAND_EF_FILTER_RATIO = 0.9;
+constexpr int64_t EXPAND_EF_FACTOR = 2;
+
+}  // namespace
+
+FilteredSearchPlan
+PlanFilteredSearch(const faiss::BitsetView bitset, int64_t ntotal, int64_t ef, int64_t k, int64_t max_degree) {
+    FilteredSearchPlan plan;
+    plan.ef = ef;
+    if (bitset.empty() || ntotal == 0) {
+        return plan;
+    }
+
+    int64_t filtered = std::min(static_cast<int64_t>(bitset.count_1()), ntotal);
+    int64_t left = ntotal - filtered;
+    double ratio = static_cast<double>(filtered) / ntotal;
+    if (left <= std::max(ef, k) * max_degree) {
+        plan.mode = FilteredSearchMode::BRUTE_FORCE;
+    } else if (ratio >= TWO_HOP_FILTER_RATIO) {
+        plan.mode = FilteredSearchMode::TWO_HOP;
+        if (ratio >= EXPAND_EF_FILTER_RATIO) {
+            plan.ef = ef * EXPAND_EF_FACTOR;
+        }
+    }
+    return plan;
+}
+
+}  // namespace knowhere
+}  // namespace milvus
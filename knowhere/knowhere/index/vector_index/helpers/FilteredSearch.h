@@ -0,0 +1,41 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "knowhere/utils/BitsetView.h"
+
+namespace milvus {
+namespace knowhere {
+
+// How a graph index searches around the entries a bitset filters out
+enum class FilteredSearchMode {
+    WALK,         // through them, as through any node
+    TWO_HOP,      // without their distances, straight on to their neighbors
+    BRUTE_FORCE,  // no walk, the distances to all the entries left
+};
+
+struct FilteredSearchPlan {
+    FilteredSearchMode mode = FilteredSearchMode::WALK;
+    int64_t ef = 0;
+};
+
+// Chosen from the share of the ntotal entries that bitset filters out. Once it is half of them, most
+// neighbors are filtered and the walk goes two hops; from nine tenths, the entries left are too far apart
+// for ef and it is doubled. When a walk would compute as many distances (ef times the base-layer degree)
+// as there are entries left, those are scanned instead.
+FilteredSearchPlan
+PlanFilteredSearch(const faiss::BitsetView bitset, int64_t ntotal, int64_t ef, int64_t k, int64_t max_degree);
+
+}  // namespace knowhere
+}  // namespace milvus
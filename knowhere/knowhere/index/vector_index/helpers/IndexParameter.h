@@ -35,8 +35,17 @@ constexpr const char* range_search_buffer_size = "range_search_buffer_size";
 // IVF Params
 constexpr const char* nprobe = "nprobe";
 constexpr const char* nlist = "nlist";
-constexpr const char* m = "m";          // PQ
-constexpr const char* nbits = "nbits";  // PQ/SQ
+constexpr const char* m = "m";                                      // PQ
+constexpr const char* nbits = "nbits";                              // PQ/SQ
+constexpr const char* quantizer_type = "quantizer_type";            // SQ and HNSW level0, one of SQType
+constexpr const char* save_arranged_data = "save_arranged_data";    // IVF_NM
+constexpr const char* refine_k = "refine_k";                        // candidates per result re-scored exactly
+constexpr const char* prune_ratio = "prune_ratio";                  // scale of the list radius when skipping lists
+constexpr const char* max_list_size_ratio = "max_list_size_ratio";  // Rebalance() splits lists above it x average
+constexpr const char* min_list_size_ratio = "min_list_size_ratio";  // Rebalance() merges lists below it x average
+constexpr const char* coarse_quantizer = "coarse_quantizer";        // one of CoarseQuantizerType
+constexpr const char* coarse_nlist = "coarse_nlist";                // IVF coarse quantizer
+constexpr const char* coarse_nprobe = "coarse_nprobe";              // IVF coarse quantizer
 
 // NSG Params
 constexpr const char* knng = "knng";
@@ -48,6 +57,9 @@ constexpr const char* candidate = "candidate_pool_size";
 constexpr const char* efConstruction = "efConstruction";
 constexpr const char* M = "M";
 constexpr const char* ef = "ef";
+constexpr const char* intra_query_threads = "intra_query_threads";
+constexpr const char* reorder = "reorder";
+constexpr const char* batch_build = "batch_build";
 
 // Annoy Params
 constexpr const char* n_trees = "n_trees";
@@ -69,6 +81,21 @@ constexpr const char* outgoing_edge_size = "outgoing_edge_size";
 constexpr const char* incoming_edge_size = "incoming_edge_size";
 }  // namespace IndexParams
 
+namespace SQType {
+constexpr const char* QT_8BIT = "QT_8bit";
+constexpr const char* QT_8BIT_UNIFORM = "QT_8bit_uniform";
+constexpr const char* QT_6BIT = "QT_6bit";
+constexpr const char* QT_4BIT = "QT_4bit";
+constexpr const char* QT_FP16 = "QT_fp16";
+constexpr const char* QT_BF16 = "QT_bf16";
+}  // namespace SQType
+
+namespace CoarseQuantizerType {
+constexpr const char* FLAT = "FLAT";
+constexpr const char* HNSW = "HNSW";  // M and efConstruction to build, ef to search
+constexpr const char* IVF = "IVF";    // two levels, coarse_nlist to build, coarse_nprobe to search
+}  // namespace CoarseQuantizerType
+
 namespace Metric {
 constexpr const char* TYPE = "metric_type";
 constexpr const char* IP = "IP";
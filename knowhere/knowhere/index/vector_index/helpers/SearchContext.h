@@ -0,0 +1,182 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <vector>
+
+namespace milvus {
+namespace knowhere {
+
+class SearchContext;
+
+// Identity of an index that keeps scratch in search contexts. Each owner is a fresh token, so a new index
+// never picks up the buffers of a destroyed one that happened to live at the same address. Destroying the
+// owner drops its slots from the context of the destroying thread at once and from every other context on
+// that context's next Get().
+class SearchContextOwner {
+ public:
+    SearchContextOwner() : token_(std::make_shared<char>()) {
+    }
+
+    SearchContextOwner(const SearchContextOwner&) = delete;
+    SearchContextOwner&
+    operator=(const SearchContextOwner&) = delete;
+
+    ~SearchContextOwner();
+
+ private:
+    friend class SearchContext;
+    std::shared_ptr<char> token_;
+};
+
+// Scratch memory of one search thread: visited tags, candidate pools and result buffers of the graph
+// indexes. Indexes keep their buffers in the context and reuse them for every later query, so a warmed-up
+// thread searches without allocating and without taking a pool lock. A context must not be used by two
+// threads at the same time; workers own one each, or use Local().
+//
+// HNSW and NSG take their scratch from here. RHNSW lives in faiss, which does not depend on knowhere, and
+// recycles its visited lists through its own pool; Annoy and NGT allocate their per-query heaps inside the
+// third-party search routines, which have no hook to pass scratch in.
+class SearchContext {
+ public:
+    // scratch of type T belonging to owner, default-constructed on first use. The last kMaxSlots
+    // (owner, type) pairs are kept; users must size-check what they get, the owner may have grown since.
+    template <typename T>
+    T&
+    Get(const SearchContextOwner& owner) {
+        if (seen_releases_ != Releases().load(std::memory_order_acquire)) {
+            DropExpired();
+        }
+        std::type_index type(typeid(T));
+        for (auto& slot : slots_) {
+            if (slot.type == type && SameOwner(slot.owner, owner)) {
+                return *static_cast<T*>(slot.data.get());
+            }
+        }
+        Slot slot{owner.token_, type, std::make_shared<T>()};
+        if (slots_.size() < kMaxSlots) {
+            slots_.push_back(slot);
+            return *static_cast<T*>(slots_.back().data.get());
+        }
+        auto& evicted = slots_[next_evict_];
+        next_evict_ = (next_evict_ + 1) % kMaxSlots;
+        evicted = slot;
+        return *static_cast<T*>(evicted.data.get());
+    }
+
+    // drops the slots of owner
+    void
+    Release(const SearchContextOwner& owner) {
+        Drop([&](const Slot& slot) { return SameOwner(slot.owner, owner); });
+    }
+
+    size_t
+    Size() const {
+        return slots_.size();
+    }
+
+    void
+    Clear() {
+        slots_.clear();
+        next_evict_ = 0;
+    }
+
+    // context of the calling thread, used by the parallel Query()/QueryInto() paths
+    static SearchContext&
+    Local();
+
+ private:
+    friend class SearchContextOwner;
+
+    static constexpr size_t kMaxSlots = 8;
+
+    // the owner destructor must not touch Local() of a thread that has not created it or is tearing it down
+    enum LocalState { LOCAL_NONE, LOCAL_ALIVE, LOCAL_GONE };
+
+    static LocalState&
+    LocalStateOfThread() {
+        thread_local LocalState state = LOCAL_NONE;
+        return state;
+    }
+
+    struct LocalContext;
+
+    struct Slot {
+        std::weak_ptr<char> owner;
+        std::type_index type;
+        std::shared_ptr<void> data;
+    };
+
+    static bool
+    SameOwner(const std::weak_ptr<char>& slot_owner, const SearchContextOwner& owner) {
+        return !slot_owner.owner_before(owner.token_) && !owner.token_.owner_before(slot_owner);
+    }
+
+    // bumped by every destroyed owner, so contexts sweep for expired slots only after something went away
+    static std::atomic<uint64_t>&
+    Releases() {
+        static std::atomic<uint64_t> releases{0};
+        return releases;
+    }
+
+    void
+    DropExpired() {
+        seen_releases_ = Releases().load(std::memory_order_acquire);
+        Drop([](const Slot& slot) { return slot.owner.expired(); });
+    }
+
+    template <typename Pred>
+    void
+    Drop(Pred pred) {
+        slots_.erase(std::remove_if(slots_.begin(), slots_.end(), pred), slots_.end());
+        next_evict_ = slots_.empty() ? 0 : next_evict_ % slots_.size();
+    }
+
+    std::vector<Slot> slots_;
+    size_t next_evict_ = 0;
+    uint64_t seen_releases_ = 0;
+};
+
+struct SearchContext::LocalContext {
+    LocalContext() {
+        LocalStateOfThread() = LOCAL_ALIVE;
+    }
+    ~LocalContext() {
+        LocalStateOfThread() = LOCAL_GONE;
+    }
+    SearchContext ctx;
+};
+
+inline SearchContext&
+SearchContext::Local() {
+    thread_local LocalContext local;
+    return local.ctx;
+}
+
+inline SearchContextOwner::~SearchContextOwner() {
+    if (SearchContext::LocalStateOfThread() == SearchContext::LOCAL_ALIVE) {
+        SearchContext::Local().Release(*this);
+    }
+    // expire the token before announcing it, so a sweep triggered by the bump sees it gone
+    token_.reset();
+    SearchContext::Releases().fetch_add(1, std::memory_order_release);
+}
+
+using SearchContextPtr = std::shared_ptr<SearchContext>;
+
+}  // namespace knowhere
+}  // namespace milvus
@@ -22,6 +22,7 @@
 #include "knowhere/common/Exception.h"
 #include "knowhere/common/Log.h"
 #include "knowhere/common/Timer.h"
+#include "knowhere/index/vector_index/helpers/SearchContext.h"
 #include "knowhere/index/vector_index/impl/nsg/NSGHelper.h"
 
 namespace milvus {
@@ -111,8 +112,9 @@ NsgIndex::InitNavigationPoint(float* data) {
 
     // select navigation point
     std::vector<Neighbor> resset;
+    SearchScratch scratch;
     navigation_point = rand_r(&seed) % ntotal;  // random initialize navigating point
-    GetNeighbors(center, data, resset, knng);
+    GetNeighbors(center, data, resset, knng, scratch);
     navigation_point = resset[0].id;
 
     // Debug code
@@ -341,17 +343,24 @@ NsgIndex::GetNeighbors(const float* query, float* data, std::vector<Neighbor>& r
 }
 
 void
-NsgIndex::GetNeighbors(
-    const float* query, float* data, std::vector<Neighbor>& resset, Graph& graph, SearchParams* params) {
+NsgIndex::GetNeighbors(const float* query,
+                       float* data,
+                       std::vector<Neighbor>& resset,
+                       Graph& graph,
+                       SearchScratch& scratch,
+                       SearchParams* params) {
     size_t buffer_size = params ? params->search_length : search_length;
 
     if (buffer_size > ntotal) {
         KNOWHERE_THROW_MSG("Build Error, search_length > ntotal");
     }
 
-    std::vector<node_t> init_ids(buffer_size);
+    auto& init_ids = scratch.init_ids;
+    init_ids.resize(buffer_size);
     resset.resize(buffer_size);
-    boost::dynamic_bitset<> has_calculated_dist{ntotal, 0};
+    scratch.NewQuery(ntotal);
+    auto visited = scratch.visited.data();
+    auto tag = scratch.tag;
 
     {
         /*
@@ -362,17 +371,17 @@ NsgIndex::GetNeighbors(
         // Get all neighbors
         for (size_t i = 0; i < init_ids.size() && i < graph[navigation_point].size(); ++i) {
             init_ids[i] = graph[navigation_point][i];
-            has_calculated_dist[init_ids[i]] = true;
+            visited[init_ids[i]] = tag;
             ++count;
         }
         while (count < buffer_size) {
             node_t id = rand_r(&seed) % ntotal;
-            if (has_calculated_dist[id]) {
+            if (visited[id] == tag) {
                 continue;  // duplicate id
             }
             init_ids[count] = id;
             ++count;
-            has_calculated_dist[id] = true;
+            visited[id] = tag;
         }
     }
 
@@ -403,10 +412,10 @@ NsgIndex::GetNeighbors(
                 node_t start_pos = resset[cursor].id;
                 auto& wait_for_search_node_vec = graph[start_pos];
                 for (node_t id : wait_for_search_node_vec) {
-                    if (has_calculated_dist[id]) {
+                    if (visited[id] == tag) {
                         continue;
                     }
-                    has_calculated_dist[id] = true;
+                    visited[id] = tag;
 
                     float dist = distance_->Compare(query, data + dimension * id, dimension);
 
@@ -869,40 +878,66 @@ NsgIndex::Search(const float* query,
                  int64_t* ids,
                  SearchParams& params,
                  const faiss::BitsetView bitset) {
-    std::vector<std::vector<Neighbor>> resset(nq);
-
     TimeRecorder rc("NsgIndex::search", 1);
+    if (params.search_length > ntotal) {
+        KNOWHERE_THROW_MSG("Build Error, search_length > ntotal");  // checked up front, omp threads can't throw
+    }
     if (nq == 1) {
-        GetNeighbors(query, data, resset[0], nsg, &params);
+        Search(query, data, nq, dim, k, dist, ids, params, bitset,
+               SearchContext::Local().Get<SearchScratch>(search_owner));
     } else {
 #pragma omp parallel for
         for (unsigned int i = 0; i < nq; ++i) {
+            auto& scratch = SearchContext::Local().Get<SearchScratch>(search_owner);
             const float* single_query = query + i * dim;
-            GetNeighbors(single_query, data, resset[i], nsg, &params);
+            GetNeighbors(single_query, data, scratch.resset, nsg, scratch, &params);
+            CopyResult(scratch.resset, k, dist + i * k, ids + i * k, bitset);
         }
     }
     rc.RecordSection("search");
+}
 
-    bool is_ip = (metric_type == Metric_Type::Metric_Type_IP);
+void
+NsgIndex::Search(const float* query,
+                 float* data,
+                 const unsigned& nq,
+                 const unsigned& dim,
+                 const unsigned& k,
+                 float* dist,
+                 int64_t* ids,
+                 SearchParams& params,
+                 const faiss::BitsetView bitset,
+                 SearchScratch& scratch) {
     for (unsigned int i = 0; i < nq; ++i) {
-        unsigned int pos = 0;
-        for (auto node : resset[i]) {
-            if (pos >= k) {
-                break;  // already top k
-            }
-            if (!bitset || !bitset.test(node.id)) {
-                ids[i * k + pos] = ids_[node.id];
-                dist[i * k + pos] = is_ip ? -node.distance : node.distance;
-                ++pos;
-            }
+        const float* single_query = query + i * dim;
+        GetNeighbors(single_query, data, scratch.resset, nsg, scratch, &params);
+        CopyResult(scratch.resset, k, dist + i * k, ids + i * k, bitset);
+    }
+}
+
+void
+NsgIndex::CopyResult(const std::vector<Neighbor>& resset,
+                     const unsigned& k,
+                     float* dist,
+                     int64_t* ids,
+                     const faiss::BitsetView bitset) {
+    bool is_ip = (metric_type == Metric_Type::Metric_Type_IP);
+    unsigned int pos = 0;
+    for (auto& node : resset) {
+        if (pos >= k) {
+            break;  // already top k
         }
-        // fill with -1
-        for (unsigned int j = pos; j < k; ++j) {
-            ids[i * k + j] = -1;
-            dist[i * k + j] = -1;
+        if (!bitset || !bitset.test(node.id)) {
+            ids[pos] = ids_[node.id];
+            dist[pos] = is_ip ? -node.distance : node.distance;
+            ++pos;
         }
     }
-    rc.RecordSection("merge");
+    // fill with -1
+    for (unsigned int j = pos; j < k; ++j) {
+        ids[j] = -1;
+        dist[j] = -1;
+    }
 }
 
 void
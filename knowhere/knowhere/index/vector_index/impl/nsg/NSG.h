@@ -22,6 +22,7 @@
 #include "knowhere/utils/BitsetView.h"
 #include "knowhere/common/Config.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
+#include "knowhere/index/vector_index/helpers/SearchContext.h"
 
 namespace milvus {
 namespace knowhere {
@@ -42,6 +43,28 @@ struct SearchParams {
 
 using Graph = std::vector<std::vector<node_t>>;
 
+// Buffers of one search thread, reused across queries so a warmed-up search does not allocate
+struct SearchScratch {
+    // visited[id] == tag once the distance to id has been computed in the current query
+    std::vector<uint16_t> visited;
+    uint16_t tag = 0;
+    std::vector<node_t> init_ids;
+    std::vector<Neighbor> resset;
+
+    // starts a new query over n nodes, clears visited in O(1) except on tag wrap-around
+    void
+    NewQuery(size_t n) {
+        if (visited.size() < n) {
+            visited.assign(n, 0);
+            tag = 0;
+        }
+        if (++tag == 0) {
+            std::fill(visited.begin(), visited.end(), 0);
+            tag = 1;
+        }
+    }
+};
+
 class NsgIndex {
  public:
     enum Metric_Type {
@@ -70,6 +93,9 @@ class NsgIndex {
     size_t candidate_pool_size;  // search deepth in fullset
     size_t out_degree;
 
+    // key of this index's SearchScratch in the search contexts
+    SearchContextOwner search_owner;
+
  public:
     explicit NsgIndex(const size_t& dimension, const size_t& n, Metric_Type metric);
 
@@ -94,6 +120,19 @@ class NsgIndex {
            SearchParams& params,
            const faiss::BitsetView bitset);
 
+    // same, running the nq queries serially on the calling thread with its scratch
+    void
+    Search(const float* query,
+           float* data,
+           const unsigned& nq,
+           const unsigned& dim,
+           const unsigned& k,
+           float* dist,
+           int64_t* ids,
+           SearchParams& params,
+           const faiss::BitsetView bitset,
+           SearchScratch& scratch);
+
     int64_t
     GetSize();
 
@@ -128,8 +167,20 @@ class NsgIndex {
 
     // navigation-point
     void
-    GetNeighbors(
-        const float* query, float* data, std::vector<Neighbor>& resset, Graph& graph, SearchParams* param = nullptr);
+    GetNeighbors(const float* query,
+                 float* data,
+                 std::vector<Neighbor>& resset,
+                 Graph& graph,
+                 SearchScratch& scratch,
+                 SearchParams* param = nullptr);
+
+    // write the top k of resset that pass bitset into ids/dist
+    void
+    CopyResult(const std::vector<Neighbor>& resset,
+               const unsigned& k,
+               float* dist,
+               int64_t* ids,
+               const faiss::BitsetView bitset);
 
     // only for search
     // void
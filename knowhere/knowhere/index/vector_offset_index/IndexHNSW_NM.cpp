@@ -0,0 +1,134 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include "knowhere/index/vector_offset_index/IndexHNSW_NM.h"
+
+#include <string>
+
+#include "hnswlib/hnswalg.h"
+#include "knowhere/common/Exception.h"
+#include "knowhere/index/vector_index/helpers/FaissIO.h"
+#include "knowhere/index/vector_index/helpers/IndexParameter.h"
+
+namespace milvus {
+namespace knowhere {
+
+BinarySet
+IndexHNSW_NM::Serialize(const Config& config) {
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
+
+    if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
+        BinarySet res_set;
+        SerializeTo(config, res_set.AppendSink());
+        return res_set;
+    }
+
+    try {
+        MemoryIOWriter writer;
+        index_->saveIndex(writer, true);
+        std::shared_ptr<uint8_t[]> data(writer.data_);
+
+        BinarySet res_set;
+        res_set.Append("HNSW_NM", data, writer.rp);
+        return res_set;
+    } catch (std::exception& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+}
+
+void
+IndexHNSW_NM::SerializeTo(const Config& config, const BinarySink& sink) {
+    if (!config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
+        VecIndex::SerializeTo(config, sink);
+        return;
+    }
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
+
+    try {
+        milvus::json meta_info;
+        SliceIOWriter writer("HNSW_NM", config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024, sink);
+        index_->saveIndex(writer, true);
+        writer.Close(meta_info);
+        EmitSliceMeta(meta_info, sink);
+    } catch (std::exception& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+}
+
+void
+IndexHNSW_NM::Load(const BinarySet& index_binary) {
+    try {
+        Assemble(const_cast<BinarySet&>(index_binary));
+        auto binary = index_binary.GetByName("HNSW_NM");
+
+        MemoryIOReader reader;
+        reader.total = binary->size;
+        reader.data_ = binary->data.get();
+
+        hnswlib::SpaceInterface<float>* space = nullptr;
+        index_ = std::make_shared<hnswlib::HierarchicalNSW<float>>(space);
+        index_->stats_enable = (STATISTICS_LEVEL >= 3);
+        index_->loadIndex(reader, 0, binary->mapped);
+        mapped_binary_ = binary->mapped ? binary : nullptr;
+        if (index_->level0_codec_ != hnswlib::LEVEL0_NONE) {
+            KNOWHERE_THROW_MSG("HNSW_NM binary holds vectors, load it with HNSW");
+        }
+
+        if (!index_binary.Contains(RAW_DATA)) {
+            KNOWHERE_THROW_MSG("HNSW_NM needs RAW_DATA to load");
+        }
+        auto raw_data = index_binary.GetByName(RAW_DATA);
+        if (raw_data->size != static_cast<int64_t>(Count() * Dim() * sizeof(float))) {
+            KNOWHERE_THROW_MSG("RAW_DATA doesn't match the index");
+        }
+        if (!raw_data->mapped) {
+            auto placed = std::make_shared<Binary>(*raw_data);
+            placed->data = PayloadData(raw_data);
+            raw_data = placed;
+        }
+        index_->setRawData(raw_data->data.get());
+        raw_data_ = raw_data;
+
+        if (STATISTICS_LEVEL >= 3) {
+            auto hnsw_stats = std::static_pointer_cast<LibHNSWStatistics>(stats);
+            auto lock = hnsw_stats->Lock();
+            hnsw_stats->update_level_distribution(index_->maxlevel_, index_->level_stats_);
+        }
+    } catch (std::exception& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+}
+
+void
+IndexHNSW_NM::AddWithoutIds(const DatasetPtr& dataset_ptr, const Config& config) {
+    // the serialized graph must keep labels as internal ids and full vectors in level0
+    if ((config.contains(IndexParams::reorder) && config[IndexParams::reorder].get<bool>()) ||
+        config.contains(IndexParams::quantizer_type)) {
+        KNOWHERE_THROW_MSG("HNSW_NM supports neither reorder nor quantizer_type");
+    }
+    IndexHNSW::AddWithoutIds(dataset_ptr, config);
+}
+
+faiss::PayloadPlacement
+IndexHNSW_NM::GetPayloadPlacement() {
+    auto placement = IndexHNSW::GetPayloadPlacement();
+    if (index_->level0_codec_ == hnswlib::LEVEL0_NONE) {
+        placement.merge(faiss::payload_query(raw_data_->data.get(), raw_data_->size));
+    }
+    return placement;
+}
+
+}  // namespace knowhere
+}  // namespace milvus
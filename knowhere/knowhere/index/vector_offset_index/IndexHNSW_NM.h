@@ -0,0 +1,52 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <memory>
+
+#include "knowhere/index/vector_index/IndexHNSW.h"
+
+namespace milvus {
+namespace knowhere {
+
+// HNSW that serializes its graph only. Load() walks the vectors of RAW_DATA in place, so they
+// are not held twice, and can be a mapping of a file owned by the caller. It is built like
+// IndexHNSW; reorder and quantizer_type are not supported, a loaded index is read-only.
+class IndexHNSW_NM : public IndexHNSW {
+ public:
+    IndexHNSW_NM() {
+        index_type_ = IndexEnum::INDEX_HNSW_NM;
+    }
+
+    BinarySet
+    Serialize(const Config& config) override;
+
+    void
+    SerializeTo(const Config& config, const BinarySink& sink) override;
+
+    void
+    Load(const BinarySet& index_binary) override;
+
+    using VecIndex::AddWithoutIds;
+
+    void
+    AddWithoutIds(const DatasetPtr& dataset_ptr, const Config& config) override;
+
+    faiss::PayloadPlacement
+    GetPayloadPlacement() override;
+
+ private:
+    BinaryPtr raw_data_ = nullptr;  // RAW_DATA of the loaded binary set
+};
+
+}  // namespace knowhere
+}  // namespace milvus
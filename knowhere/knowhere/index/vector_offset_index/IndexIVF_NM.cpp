@@ -31,6 +31,7 @@
 #include "knowhere/common/Exception.h"
 #include "knowhere/common/Log.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/index/vector_index/helpers/CoarseQuantizer.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #include "knowhere/index/vector_offset_index/IndexIVF_NM.h"
 #ifdef KNOWHERE_GPU_VERSION
@@ -50,6 +51,19 @@ IVF_NM::Serialize(const Config& config) {
     }
 
     auto ret = SerializeImpl(index_type_);
+#ifndef KNOWHERE_GPU_VERSION
+    if (compacted_ ||
+        (config.contains(IndexParams::save_arranged_data) && config[IndexParams::save_arranged_data].get<bool>())) {
+        if (data_ == nullptr) {
+            KNOWHERE_THROW_MSG("no arranged data, load the index or add with save_arranged_data first");
+        }
+        ret.Append(ARRANGED_DATA, data_, index_->ntotal * index_->d * sizeof(float));
+        auto prefix_sum_size = prefix_sum.size() * sizeof(size_t);
+        std::shared_ptr<uint8_t[]> prefix_sum_data(new uint8_t[prefix_sum_size]);
+        memcpy(prefix_sum_data.get(), prefix_sum.data(), prefix_sum_size);
+        ret.Append(PREFIX_SUM, prefix_sum_data, prefix_sum_size);
+    }
+#endif
     if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
         Disassemble(config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024, ret);
     }
@@ -61,33 +75,38 @@ IVF_NM::Load(const BinarySet& binary_set) {
     Assemble(const_cast<BinarySet&>(binary_set));
     LoadImpl(binary_set, index_type_);
 
-    // Construct arranged data from original data
-    auto binary = binary_set.GetByName(RAW_DATA);
-    auto original_data = reinterpret_cast<const float*>(binary->data.get());
     auto ivf_index = static_cast<faiss::IndexIVF*>(index_.get());
     auto invlists = ivf_index->invlists;
     auto d = ivf_index->d;
-    prefix_sum.resize(invlists->nlist);
-    size_t curr_index = 0;
 
     if (STATISTICS_LEVEL >= 3) {
         ivf_index->nprobe_statistics.resize(invlists->nlist, 0);
     }
 
 #ifndef KNOWHERE_GPU_VERSION
-    auto ails = dynamic_cast<faiss::ArrayInvertedLists*>(invlists);
-    size_t nb = binary->size / invlists->code_size;
-    auto arranged_data = new float[d * nb];
-    for (size_t i = 0; i < invlists->nlist; i++) {
-        auto list_size = ails->ids[i].size();
-        for (size_t j = 0; j < list_size; j++) {
-            memcpy(arranged_data + d * (curr_index + j), original_data + d * ails->ids[i][j], d * sizeof(float));
+    if (binary_set.Contains(ARRANGED_DATA)) {
+        // already in list order: reference it, in place when it is mapped from a file
+        auto arranged = binary_set.GetByName(ARRANGED_DATA);
+        auto sums = binary_set.GetByName(PREFIX_SUM);
+        if (arranged->size != static_cast<int64_t>(ivf_index->ntotal * d * sizeof(float)) ||
+            sums->size != static_cast<int64_t>(invlists->nlist * sizeof(size_t))) {
+            KNOWHERE_THROW_MSG("arranged data doesn't match the index");
         }
-        prefix_sum[i] = curr_index;
-        curr_index += list_size;
+        prefix_sum.resize(invlists->nlist);
+        memcpy(prefix_sum.data(), sums->data.get(), sums->size);
+        data_ = arranged->mapped ? arranged->data : PayloadData(arranged);
+        return;
     }
-    data_ = std::shared_ptr<uint8_t[]>(reinterpret_cast<uint8_t*>(arranged_data));
+
+    // Construct arranged data from original data
+    auto binary = binary_set.GetByName(RAW_DATA);
+    data_ = nullptr;
+    ArrangeData(reinterpret_cast<const float*>(binary->data.get()), 0);
 #else
+    auto binary = binary_set.GetByName(RAW_DATA);
+    auto original_data = reinterpret_cast<const float*>(binary->data.get());
+    prefix_sum.resize(invlists->nlist);
+    size_t curr_index = 0;
     auto rol = dynamic_cast<faiss::ReadOnlyArrayInvertedLists*>(invlists);
     auto arranged_data = reinterpret_cast<float*>(rol->pin_readonly_codes->data);
     auto lengths = rol->readonly_length;
@@ -111,13 +130,75 @@ IVF_NM::Load(const BinarySet& binary_set) {
     //    LOG_KNOWHERE_DEBUG_ << ivf_stats->ToString();
 }
 
+void
+IVF_NM::ArrangeData(const float* raw, size_t raw_begin) {
+    auto ivf_index = static_cast<faiss::IndexIVF*>(index_.get());
+    auto ails = dynamic_cast<faiss::ArrayInvertedLists*>(ivf_index->invlists);
+    if (ails == nullptr) {
+        KNOWHERE_THROW_MSG("IVF_NM can only arrange array inverted lists");
+    }
+    auto d = ivf_index->d;
+    auto nlist = ails->nlist;
+    auto old_data = reinterpret_cast<const float*>(data_.get());
+    if (raw_begin > 0 && (old_data == nullptr || prefix_sum.size() != nlist)) {
+        KNOWHERE_THROW_MSG("no arranged data to extend");
+    }
+
+    auto arranged_data = reinterpret_cast<float*>(faiss::payload_alloc(ivf_index->ntotal * d * sizeof(float)));
+    if (arranged_data == nullptr) {
+        KNOWHERE_THROW_MSG("failed to allocate arranged data");
+    }
+    std::vector<size_t> new_prefix_sum(nlist);
+    size_t curr_index = 0;
+    for (size_t i = 0; i < nlist; i++) {
+        auto& list_ids = ails->ids[i];
+        for (size_t j = 0; j < list_ids.size(); j++) {
+            auto offset = static_cast<size_t>(list_ids[j]);
+            auto src = (offset >= raw_begin) ? raw + d * (offset - raw_begin) : old_data + d * (prefix_sum[i] + j);
+            memcpy(arranged_data + d * (curr_index + j), src, d * sizeof(float));
+        }
+        new_prefix_sum[i] = curr_index;
+        curr_index += list_ids.size();
+    }
+    prefix_sum.swap(new_prefix_sum);
+    data_ = std::shared_ptr<uint8_t[]>(reinterpret_cast<uint8_t*>(arranged_data),
+                                       [](uint8_t* p) { faiss::payload_free(p); });
+}
+
+BinaryPtr
+IVF_NM::GetRawData() {
+    if (!index_ || data_ == nullptr) {
+        KNOWHERE_THROW_MSG("index not initialize or loaded");
+    }
+    auto ivf_index = static_cast<faiss::IndexIVF*>(index_.get());
+    auto ails = dynamic_cast<faiss::ArrayInvertedLists*>(ivf_index->invlists);
+    if (ails == nullptr) {
+        KNOWHERE_THROW_MSG("IVF_NM can only restore array inverted lists");
+    }
+    auto d = ivf_index->d;
+    auto size = ivf_index->ntotal * d * sizeof(float);
+    std::shared_ptr<uint8_t[]> raw_data(new uint8_t[size]);
+    auto raw = reinterpret_cast<float*>(raw_data.get());
+    auto arranged = reinterpret_cast<const float*>(data_.get());
+    for (size_t i = 0; i < ails->nlist; i++) {
+        auto& list_ids = ails->ids[i];
+        for (size_t j = 0; j < list_ids.size(); j++) {
+            memcpy(raw + d * list_ids[j], arranged + d * (prefix_sum[i] + j), d * sizeof(float));
+        }
+    }
+    auto binary = std::make_shared<Binary>();
+    binary->data = raw_data;
+    binary->size = size;
+    return binary;
+}
+
 void
 IVF_NM::Train(const DatasetPtr& dataset_ptr, const Config& config) {
     GET_TENSOR_DATA_DIM(dataset_ptr)
 
     int64_t nlist = config[IndexParams::nlist].get<int64_t>();
     faiss::MetricType metric_type = GetMetricType(config[Metric::TYPE].get<std::string>());
-    auto coarse_quantizer = new faiss::IndexFlat(dim, metric_type);
+    auto coarse_quantizer = BuildCoarseQuantizer(config, rows, static_cast<const float*>(p_data), dim, metric_type);
     auto index = std::make_shared<faiss::IndexIVFFlat>(coarse_quantizer, dim, nlist, metric_type);
     index->own_fields = true;
     index->train(rows, reinterpret_cast<const float*>(p_data));
@@ -131,49 +212,98 @@ IVF_NM::AddWithoutIds(const DatasetPtr& dataset_ptr, const Config& config) {
     }
 
     GET_TENSOR_DATA(dataset_ptr)
+    auto raw_begin = index_->ntotal;
+#ifndef KNOWHERE_GPU_VERSION
+    // keep the arranged data current when it exists or is to be saved, so the index is searchable and
+    // serializable without RAW_DATA
+    bool arrange = data_ != nullptr || (config.contains(IndexParams::save_arranged_data) &&
+                                        config[IndexParams::save_arranged_data].get<bool>());
+    if (arrange && data_ == nullptr && raw_begin > 0) {
+        KNOWHERE_THROW_MSG("save_arranged_data must be set from the first add on");
+    }
+#endif
     index_->add_without_codes(rows, reinterpret_cast<const float*>(p_data));
+#ifndef KNOWHERE_GPU_VERSION
+    if (arrange) {
+        ArrangeData(reinterpret_cast<const float*>(p_data), raw_begin);
+    }
+#endif
 }
 
-DatasetPtr
-IVF_NM::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+int64_t
+IVF_NM::Remove(const IDType* ids, int64_t n) {
     if (!index_ || !index_->is_trained) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
 
-    GET_TENSOR_DATA(dataset_ptr)
+    auto ivf_index = static_cast<faiss::IndexIVF*>(index_.get());
+    auto ails = dynamic_cast<faiss::ArrayInvertedLists*>(ivf_index->invlists);
+    if (ails == nullptr) {
+        KNOWHERE_THROW_MSG("IVF_NM can only compact array inverted lists");
+    }
+    // without it, the entries left could only be read back from a RAW_DATA in the old offset order
+    if (data_ == nullptr) {
+        KNOWHERE_THROW_MSG("no arranged data, load the index or add with save_arranged_data before removing");
+    }
+    auto ntotal = ivf_index->ntotal;
+    std::vector<int64_t> new_offsets;
+    auto new_uids = CompactOffsets(ids, n, ntotal, new_offsets);
+    if (new_uids == nullptr) {
+        return 0;
+    }
 
-    int64_t* p_id = nullptr;
-    float* p_dist = nullptr;
-    auto release_when_exception = [&]() {
-        if (p_id != nullptr) {
-            free(p_id);
+    // the arranged data follows the lists, drop the same entries from it
+    {
+        auto d = ivf_index->d;
+        auto old_data = reinterpret_cast<const float*>(data_.get());
+        auto arranged_data = reinterpret_cast<float*>(faiss::payload_alloc(new_uids->size() * d * sizeof(float)));
+        if (arranged_data == nullptr) {
+            KNOWHERE_THROW_MSG("failed to allocate arranged data");
         }
-        if (p_dist != nullptr) {
-            free(p_dist);
+        size_t curr_index = 0;
+        for (size_t i = 0; i < ails->nlist; i++) {
+            auto& list_ids = ails->ids[i];
+            auto list_begin = curr_index;
+            for (size_t j = 0; j < list_ids.size(); j++) {
+                if (new_offsets[list_ids[j]] >= 0) {
+                    memcpy(arranged_data + d * curr_index++, old_data + d * (prefix_sum[i] + j), d * sizeof(float));
+                }
+            }
+            prefix_sum[i] = list_begin;
         }
-    };
+        data_ = std::shared_ptr<uint8_t[]>(reinterpret_cast<uint8_t*>(arranged_data),
+                                           [](uint8_t* p) { faiss::payload_free(p); });
+    }
 
-    try {
-        auto k = config[meta::TOPK].get<int64_t>();
-        auto elems = rows * k;
+    ivf_index->compact_ids(new_offsets.data());
+    compacted_ = true;
+    uids_ = new_uids;
+    return ntotal - static_cast<int64_t>(new_uids->size());
+}
 
-        size_t p_id_size = sizeof(int64_t) * elems;
-        size_t p_dist_size = sizeof(float) * elems;
-        auto p_id = static_cast<int64_t*>(malloc(p_id_size));
-        auto p_dist = static_cast<float*>(malloc(p_dist_size));
+DatasetPtr
+IVF_NM::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+    return QueryIntoDataset(dataset_ptr, config, bitset);
+}
 
-        QueryImpl(rows, reinterpret_cast<const float*>(p_data), k, p_dist, p_id, config, bitset);
-        MapOffsetToUid(p_id, static_cast<size_t>(elems));
+void
+IVF_NM::QueryInto(const float* query,
+                  int64_t nq,
+                  int64_t k,
+                  float* distances,
+                  int64_t* ids,
+                  const Config& config,
+                  const faiss::BitsetView bitset) {
+    if (!index_ || !index_->is_trained) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
 
-        auto ret_ds = std::make_shared<Dataset>();
-        ret_ds->Set(meta::IDS, p_id);
-        ret_ds->Set(meta::DISTANCE, p_dist);
-        return ret_ds;
+    try {
+        QueryImpl(nq, query, k, distances, ids, config, bitset);
+        MapOffsetToUid(ids, static_cast<size_t>(nq * k));
     } catch (faiss::FaissException& e) {
-        release_when_exception();
         KNOWHERE_THROW_MSG(e.what());
     } catch (std::exception& e) {
-        release_when_exception();
         KNOWHERE_THROW_MSG(e.what());
     }
 }
@@ -328,6 +458,7 @@ IVF_NM::QueryImpl(int64_t n,
         ivf_index->parallel_mode = 0;
     }
     bool is_sq8 = (index_type_ == IndexEnum::INDEX_FAISS_IVFSQ8) ? true : false;
+    SetCoarseQuantizerParams(ivf_index->quantizer, config);
 
 #ifndef KNOWHERE_GPU_VERSION
     auto data = static_cast<const uint8_t*>(data_.get());
@@ -401,6 +532,15 @@ IVF_NM::UpdateIndexSize() {
     index_size_ = nb * code_size + nb * sizeof(int64_t) + nlist * code_size;
 }
 
+faiss::PayloadPlacement
+IVF_NM::GetPayloadPlacement() {
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize");
+    }
+    auto ivf_index = static_cast<faiss::IndexIVF*>(index_.get());
+    return faiss::payload_query(data_.get(), data_ ? ivf_index->ntotal * ivf_index->d * sizeof(float) : 0);
+}
+
 StatisticsPtr
 IVF_NM::GetStatistics() {
     if (!STATISTICS_LEVEL) {
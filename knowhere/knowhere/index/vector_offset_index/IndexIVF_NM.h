@@ -25,6 +25,11 @@
 namespace milvus {
 namespace knowhere {
 
+// vectors in inverted list order and the offset of every list in them, written by Serialize() when
+// IndexParams::save_arranged_data is set so that Load() doesn't need RAW_DATA
+#define ARRANGED_DATA "ARRANGED_DATA"
+#define PREFIX_SUM "PREFIX_SUM"
+
 class IVF_NM : public VecIndex, public OffsetBaseIndex {
  public:
     IVF_NM() : OffsetBaseIndex(nullptr) {
@@ -43,6 +48,10 @@ class IVF_NM : public VecIndex, public OffsetBaseIndex {
     void
     Load(const BinarySet&) override;
 
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
@@ -52,6 +61,21 @@ class IVF_NM : public VecIndex, public OffsetBaseIndex {
     DatasetPtr
     Query(const DatasetPtr&, const Config&, const faiss::BitsetView bitset) override;
 
+    // Needs the arranged data (a loaded index, or one added with save_arranged_data). The RAW_DATA of the host
+    // no longer follows the offsets afterwards, so Serialize() writes the arranged data from then on; GetRawData()
+    // returns the vectors in the new offset order.
+    int64_t
+    Remove(const IDType*, int64_t) override;
+
+    void
+    QueryInto(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset) override;
+
 #if 0
     DatasetPtr
     QueryById(const DatasetPtr& dataset, const Config& config) override;
@@ -66,6 +90,9 @@ class IVF_NM : public VecIndex, public OffsetBaseIndex {
     void
     UpdateIndexSize() override;
 
+    faiss::PayloadPlacement
+    GetPayloadPlacement() override;
+
     StatisticsPtr
     GetStatistics() override;
 
@@ -77,6 +104,11 @@ class IVF_NM : public VecIndex, public OffsetBaseIndex {
     GetVectorById(const DatasetPtr& dataset, const Config& config) override;
 #endif
 
+    // vectors in id (insertion) order rebuilt from the arranged data, for users that need RAW_DATA back
+    // from an index loaded without it
+    BinaryPtr
+    GetRawData();
+
     virtual void
     Seal();
 
@@ -96,15 +128,23 @@ class IVF_NM : public VecIndex, public OffsetBaseIndex {
     void
     SealImpl() override;
 
+    // rebuild data_ and prefix_sum in inverted list order; vectors with offset >= raw_begin are read from
+    // raw, the ones below from the current data_ (lists only grow at their end)
+    void
+    ArrangeData(const float* raw, size_t raw_begin);
+
  protected:
     std::mutex mutex_;
     std::vector<size_t> prefix_sum;
 
-    // data_:    if CPU, malloc memory while loading data
+    // data_:    if CPU, vectors in inverted list order, allocated while loading or referencing the
+    //           ARRANGED_DATA binary
     // ro_codes: if GPU, hold a ptr of read only codes so that
     //            destruction won't be done twice
     std::shared_ptr<uint8_t[]> data_ = nullptr;
     faiss::PageLockMemoryPtr ro_codes = nullptr;
+    // set by Remove(): RAW_DATA can't rebuild data_ anymore
+    bool compacted_ = false;
 };
 
 using IVFNMPtr = std::shared_ptr<IVF_NM>;
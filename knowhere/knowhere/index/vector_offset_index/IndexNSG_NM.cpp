@@ -35,6 +35,12 @@ NSG_NM::Serialize(const Config& config) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
 
+    if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
+        BinarySet res_set;
+        SerializeTo(config, res_set.AppendSink());
+        return res_set;
+    }
+
     try {
         impl::NsgIndex* index = index_.get();
 
@@ -44,15 +50,33 @@ NSG_NM::Serialize(const Config& config) {
 
         BinarySet res_set;
         res_set.Append("NSG_NM", data, writer.rp);
-        if (config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
-            Disassemble(config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024, res_set);
-        }
         return res_set;
     } catch (std::exception& e) {
         KNOWHERE_THROW_MSG(e.what());
     }
 }
 
+void
+NSG_NM::SerializeTo(const Config& config, const BinarySink& sink) {
+    if (!config.contains(INDEX_FILE_SLICE_SIZE_IN_MEGABYTE)) {
+        VecIndex::SerializeTo(config, sink);
+        return;
+    }
+    if (!index_ || !index_->is_trained) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
+
+    try {
+        milvus::json meta_info;
+        SliceIOWriter writer("NSG_NM", config[INDEX_FILE_SLICE_SIZE_IN_MEGABYTE].get<int64_t>() * 1024 * 1024, sink);
+        impl::write_index(index_.get(), writer);
+        writer.Close(meta_info);
+        EmitSliceMeta(meta_info, sink);
+    } catch (std::exception& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+}
+
 void
 NSG_NM::Load(const BinarySet& index_binary) {
     try {
@@ -66,7 +90,8 @@ NSG_NM::Load(const BinarySet& index_binary) {
         auto index = impl::read_index(reader);
         index_.reset(index);
 
-        data_ = index_binary.GetByName(RAW_DATA)->data;
+        auto raw_data = index_binary.GetByName(RAW_DATA);
+        data_ = raw_data->mapped ? raw_data->data : PayloadData(raw_data);
     } catch (std::exception& e) {
         KNOWHERE_THROW_MSG(e.what());
     }
@@ -74,31 +99,52 @@ NSG_NM::Load(const BinarySet& index_binary) {
 
 DatasetPtr
 NSG_NM::Query(const DatasetPtr& dataset_ptr, const Config& config, const faiss::BitsetView bitset) {
+    return QueryIntoDataset(dataset_ptr, config, bitset);
+}
+
+void
+NSG_NM::QueryInto(const float* query,
+                  int64_t nq,
+                  int64_t k,
+                  float* distances,
+                  int64_t* ids,
+                  const Config& config,
+                  const faiss::BitsetView bitset) {
     if (!index_ || !index_->is_trained) {
         KNOWHERE_THROW_MSG("index not initialize or trained");
     }
 
-    GET_TENSOR_DATA_DIM(dataset_ptr)
-
     try {
-        auto topK = config[meta::TOPK].get<int64_t>();
-        auto elems = rows * topK;
-        size_t p_id_size = sizeof(int64_t) * elems;
-        size_t p_dist_size = sizeof(float) * elems;
-        auto p_id = static_cast<int64_t*>(malloc(p_id_size));
-        auto p_dist = static_cast<float*>(malloc(p_dist_size));
+        impl::SearchParams s_params;
+        s_params.search_length = config[IndexParams::search_length];
+        s_params.k = k;
+        index_->Search(query, reinterpret_cast<float*>(data_.get()), nq, Dim(), k, distances, ids, s_params, bitset);
+        MapOffsetToUid(ids, static_cast<size_t>(nq * k));
+    } catch (std::exception& e) {
+        KNOWHERE_THROW_MSG(e.what());
+    }
+}
 
+void
+NSG_NM::QueryWithContext(const float* query,
+                         int64_t nq,
+                         int64_t k,
+                         float* distances,
+                         int64_t* ids,
+                         const Config& config,
+                         const faiss::BitsetView bitset,
+                         SearchContext& ctx) {
+    if (!index_ || !index_->is_trained) {
+        KNOWHERE_THROW_MSG("index not initialize or trained");
+    }
+
+    try {
         impl::SearchParams s_params;
         s_params.search_length = config[IndexParams::search_length];
-        s_params.k = config[meta::TOPK];
-        index_->Search(reinterpret_cast<const float*>(p_data), reinterpret_cast<float*>(data_.get()), rows, dim, topK,
-                       p_dist, p_id, s_params, bitset);
-        MapOffsetToUid(p_id, static_cast<size_t>(elems));
-
-        auto ret_ds = std::make_shared<Dataset>();
-        ret_ds->Set(meta::IDS, p_id);
-        ret_ds->Set(meta::DISTANCE, p_dist);
-        return ret_ds;
+        s_params.k = k;
+        index_->Search(query, reinterpret_cast<float*>(data_.get()), nq, Dim(), k, distances, ids, s_params, bitset,
+                       ctx.Get<impl::SearchScratch>(index_->search_owner));
+        MapOffsetToUid(ids, static_cast<size_t>(nq * k));
     } catch (std::exception& e) {
         KNOWHERE_THROW_MSG(e.what());
     }
@@ -172,6 +218,14 @@ NSG_NM::Dim() {
     return index_->dimension;
 }
 
+faiss::PayloadPlacement
+NSG_NM::GetPayloadPlacement() {
+    if (!index_) {
+        KNOWHERE_THROW_MSG("index not initialize");
+    }
+    return faiss::payload_query(data_.get(), Dim() * Count() * sizeof(float));
+}
+
 void
 NSG_NM::UpdateIndexSize() {
     if (!index_) {
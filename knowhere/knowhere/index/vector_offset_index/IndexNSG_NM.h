@@ -37,9 +37,17 @@ class NSG_NM : public VecIndex {
     BinarySet
     Serialize(const Config& config) override;
 
+    void
+    SerializeTo(const Config& config, const BinarySink& sink) override;
+
     void
     Load(const BinarySet&) override;
 
+    using VecIndex::BuildAll;
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+    using VecIndex::Query;
+
     void
     BuildAll(const DatasetPtr& dataset_ptr, const Config& config) override;
 
@@ -56,6 +64,25 @@ class NSG_NM : public VecIndex {
     DatasetPtr
     Query(const DatasetPtr&, const Config&, const faiss::BitsetView bitset) override;
 
+    void
+    QueryInto(const float* query,
+              int64_t nq,
+              int64_t k,
+              float* distances,
+              int64_t* ids,
+              const Config& config,
+              const faiss::BitsetView bitset) override;
+
+    void
+    QueryWithContext(const float* query,
+                     int64_t nq,
+                     int64_t k,
+                     float* distances,
+                     int64_t* ids,
+                     const Config& config,
+                     const faiss::BitsetView bitset,
+                     SearchContext& ctx) override;
+
     int64_t
     Count() override;
 
@@ -65,6 +92,9 @@ class NSG_NM : public VecIndex {
     void
     UpdateIndexSize() override;
 
+    faiss::PayloadPlacement
+    GetPayloadPlacement() override;
+
  private:
     int64_t gpu_;
     std::shared_ptr<impl::NsgIndex> index_ = nullptr;
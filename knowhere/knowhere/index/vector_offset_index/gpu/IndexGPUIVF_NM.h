@@ -31,6 +31,9 @@ class GPUIVF_NM : public IVF, public GPUIndex {
         index_mode_ = IndexMode::MODE_GPU;
     }
 
+    using VecIndex::Train;
+    using VecIndex::AddWithoutIds;
+
     void
     Train(const DatasetPtr&, const Config&) override;
 
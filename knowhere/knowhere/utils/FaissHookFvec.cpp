@@ -21,6 +21,14 @@ fvec_func_ptr fvec_L2sqr = fvec_L2sqr_avx;
 fvec_func_ptr fvec_L1 = fvec_L1_avx;
 fvec_func_ptr fvec_Linf = fvec_Linf_avx;
 
+fvec_batch_func_ptr fvec_L2sqr_batch = fvec_L2sqr_batch_avx;
+fvec_batch_func_ptr fvec_inner_product_batch = fvec_inner_product_batch_avx;
+
+fvec_sq8_func_ptr fvec_L2sqr_sq8 = fvec_L2sqr_sq8_avx;
+fvec_sq8_func_ptr fvec_inner_product_sq8 = fvec_inner_product_sq8_avx;
+fvec_fp16_func_ptr fvec_L2sqr_fp16 = fvec_L2sqr_fp16_avx;
+fvec_fp16_func_ptr fvec_inner_product_fp16 = fvec_inner_product_fp16_avx;
+
 /*****************************************************************************/
 
 bool cpu_support_avx512() {
@@ -50,6 +58,12 @@ void hook_fvec(std::string& simd_type) {
         fvec_L2sqr = fvec_L2sqr_avx512;
         fvec_L1 = fvec_L1_avx512;
         fvec_Linf = fvec_Linf_avx512;
+        fvec_L2sqr_batch = fvec_L2sqr_batch_avx512;
+        fvec_inner_product_batch = fvec_inner_product_batch_avx512;
+        fvec_L2sqr_sq8 = fvec_L2sqr_sq8_avx512;
+        fvec_inner_product_sq8 = fvec_inner_product_sq8_avx512;
+        fvec_L2sqr_fp16 = fvec_L2sqr_fp16_avx512;
+        fvec_inner_product_fp16 = fvec_inner_product_fp16_avx512;
 
         simd_type = "AVX512";
     } else if (faiss_use_avx2 && cpu_support_avx2()) {
@@ -57,6 +71,12 @@ void hook_fvec(std::string& simd_type) {
         fvec_L2sqr = fvec_L2sqr_avx;
         fvec_L1 = fvec_L1_avx;
         fvec_Linf = fvec_Linf_avx;
+        fvec_L2sqr_batch = fvec_L2sqr_batch_avx;
+        fvec_inner_product_batch = fvec_inner_product_batch_avx;
+        fvec_L2sqr_sq8 = fvec_L2sqr_sq8_avx;
+        fvec_inner_product_sq8 = fvec_inner_product_sq8_avx;
+        fvec_L2sqr_fp16 = fvec_L2sqr_fp16_avx;
+        fvec_inner_product_fp16 = fvec_inner_product_fp16_avx;
 
         simd_type = "AVX2";
     } else if (faiss_use_sse4_2 && cpu_support_sse4_2()) {
@@ -64,6 +84,13 @@ void hook_fvec(std::string& simd_type) {
         fvec_L2sqr = fvec_L2sqr_sse;
         fvec_L1 = fvec_L1_sse;
         fvec_Linf = fvec_Linf_sse;
+        fvec_L2sqr_batch = fvec_L2sqr_batch_sse;
+        fvec_inner_product_batch = fvec_inner_product_batch_sse;
+        // no SSE flavor of the SQ8 / FP16 kernels, the reference ones vectorize
+        fvec_L2sqr_sq8 = fvec_L2sqr_sq8_ref;
+        fvec_inner_product_sq8 = fvec_inner_product_sq8_ref;
+        fvec_L2sqr_fp16 = fvec_L2sqr_fp16_ref;
+        fvec_inner_product_fp16 = fvec_inner_product_fp16_ref;
 
         simd_type = "SSE4_2";
     } else {
@@ -71,6 +98,12 @@ void hook_fvec(std::string& simd_type) {
         fvec_L2sqr = fvec_L2sqr_ref;
         fvec_L1 = fvec_L1_ref;
         fvec_Linf = fvec_Linf_ref;
+        fvec_L2sqr_batch = fvec_L2sqr_batch_ref;
+        fvec_inner_product_batch = fvec_inner_product_batch_ref;
+        fvec_L2sqr_sq8 = fvec_L2sqr_sq8_ref;
+        fvec_inner_product_sq8 = fvec_inner_product_sq8_ref;
+        fvec_L2sqr_fp16 = fvec_L2sqr_fp16_ref;
+        fvec_inner_product_fp16 = fvec_inner_product_fp16_ref;
 
         simd_type = "REF";
     }
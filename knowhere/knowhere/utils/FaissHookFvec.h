@@ -3,11 +3,15 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace faiss {
 
 typedef float (*fvec_func_ptr)(const float*, const float*, size_t);
+typedef void (*fvec_batch_func_ptr)(float*, const float*, const float*, size_t, size_t);
+typedef float (*fvec_sq8_func_ptr)(const float*, const uint8_t*, const float*, const float*, size_t);
+typedef float (*fvec_fp16_func_ptr)(const float*, const uint16_t*, size_t);
 
 extern bool faiss_use_avx512;
 extern bool faiss_use_avx2;
@@ -18,6 +22,17 @@ extern fvec_func_ptr fvec_L2sqr;
 extern fvec_func_ptr fvec_L1;
 extern fvec_func_ptr fvec_Linf;
 
+/* distances between one vector and ny contiguous vectors: (dis, x, y, d, ny) */
+extern fvec_batch_func_ptr fvec_L2sqr_batch;
+extern fvec_batch_func_ptr fvec_inner_product_batch;
+
+/* distances between a float vector and a SQ8 code (x, code, vmin, step, d), decoded as
+ * vmin[i] + code[i] * step[i], or an FP16 code (x, code, d) */
+extern fvec_sq8_func_ptr fvec_L2sqr_sq8;
+extern fvec_sq8_func_ptr fvec_inner_product_sq8;
+extern fvec_fp16_func_ptr fvec_L2sqr_fp16;
+extern fvec_fp16_func_ptr fvec_inner_product_fp16;
+
 bool cpu_support_avx512();
 bool cpu_support_avx2();
 bool cpu_support_sse4_2();
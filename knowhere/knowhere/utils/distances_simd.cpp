@@ -9,6 +9,7 @@
 
 #include <cstdio>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <cmath>
 
@@ -121,6 +122,100 @@ void fvec_L2sqr_ny_ref (float * dis,
 }
 
 
+void fvec_L2sqr_batch_ref (float * dis,
+                           const float * x,
+                           const float * y,
+                           size_t d, size_t ny)
+{
+    fvec_L2sqr_ny_ref (dis, x, y, d, ny);
+}
+
+void fvec_inner_product_batch_ref (float * dis,
+                                   const float * x,
+                                   const float * y,
+                                   size_t d, size_t ny)
+{
+    for (size_t i = 0; i < ny; i++) {
+        dis[i] = fvec_inner_product_ref (x, y, d);
+        y += d;
+    }
+}
+
+static inline float fp16_to_float_ref (uint16_t h)
+{
+    uint32_t sign = (uint32_t) (h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1f;
+    uint32_t mant = h & 0x3ff;
+    uint32_t bits;
+    if (exp == 0x1f) {
+        bits = sign | 0x7f800000 | (mant << 13);
+    } else if (exp != 0) {
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    } else {
+        // zero or subnormal: mant * 2^-24
+        float f = mant * (1.0f / 16777216.0f);
+        return sign ? -f : f;
+    }
+    float f;
+    memcpy (&f, &bits, sizeof (f));
+    return f;
+}
+
+// eight partial sums so that the compiler can vectorize the decode and the accumulation
+template <bool IP, typename Decode>
+static inline float fvec_code_ref (const float * x, size_t d, Decode decode)
+{
+    float acc[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 8 <= d; i += 8) {
+        for (size_t j = 0; j < 8; j++) {
+            float y = decode (i + j);
+            acc[j] += IP ? x[i + j] * y : (x[i + j] - y) * (x[i + j] - y);
+        }
+    }
+    float res = 0;
+    for (; i < d; i++) {
+        float y = decode (i);
+        res += IP ? x[i] * y : (x[i] - y) * (x[i] - y);
+    }
+    for (size_t j = 0; j < 8; j++)
+        res += acc[j];
+    return res;
+}
+
+float fvec_L2sqr_sq8_ref (const float * x,
+                          const uint8_t * code,
+                          const float * vmin,
+                          const float * step,
+                          size_t d)
+{
+    return fvec_code_ref<false> (x, d, [=](size_t i) { return vmin[i] + code[i] * step[i]; });
+}
+
+float fvec_inner_product_sq8_ref (const float * x,
+                                  const uint8_t * code,
+                                  const float * vmin,
+                                  const float * step,
+                                  size_t d)
+{
+    return fvec_code_ref<true> (x, d, [=](size_t i) { return vmin[i] + code[i] * step[i]; });
+}
+
+float fvec_L2sqr_fp16_ref (const float * x,
+                           const uint16_t * code,
+                           size_t d)
+{
+    return fvec_code_ref<false> (x, d, [=](size_t i) { return fp16_to_float_ref (code[i]); });
+}
+
+float fvec_inner_product_fp16_ref (const float * x,
+                                   const uint16_t * code,
+                                   size_t d)
+{
+    return fvec_code_ref<true> (x, d, [=](size_t i) { return fp16_to_float_ref (code[i]); });
+}
+
+
 /*********************************************************
  * SSE and AVX implementations
  */
@@ -371,6 +466,28 @@ float fvec_inner_product_sse (const float * x,
     return  _mm_cvtss_f32 (msum1);
 }
 
+void fvec_L2sqr_batch_sse (float * dis,
+                           const float * x,
+                           const float * y,
+                           size_t d, size_t ny)
+{
+    for (size_t i = 0; i < ny; i++) {
+        dis[i] = fvec_L2sqr_sse (x, y, d);
+        y += d;
+    }
+}
+
+void fvec_inner_product_batch_sse (float * dis,
+                                   const float * x,
+                                   const float * y,
+                                   size_t d, size_t ny)
+{
+    for (size_t i = 0; i < ny; i++) {
+        dis[i] = fvec_inner_product_sse (x, y, d);
+        y += d;
+    }
+}
+
 #endif /* defined(__SSE__) */
 
 //#elif defined(__aarch64__)
@@ -59,6 +59,61 @@ float fvec_Linf_sse (
         size_t d);
 #endif
 
+/* distances between x and a set of contiguous y vectors, one vector at a time. The
+ * SIMD versions behind the fvec_L2sqr_batch / fvec_inner_product_batch hooks
+ * handle several y vectors per pass, unrolled for common dimensions */
+void fvec_L2sqr_batch_ref (
+        float * dis,
+        const float * x,
+        const float * y,
+        size_t d, size_t ny);
+
+void fvec_inner_product_batch_ref (
+        float * dis,
+        const float * x,
+        const float * y,
+        size_t d, size_t ny);
+
+/* distances between x and a quantized vector: SQ8 components decode to
+ * vmin[i] + code[i] * step[i], FP16 components are IEEE half floats */
+float fvec_L2sqr_sq8_ref (
+        const float * x,
+        const uint8_t * code,
+        const float * vmin,
+        const float * step,
+        size_t d);
+
+float fvec_inner_product_sq8_ref (
+        const float * x,
+        const uint8_t * code,
+        const float * vmin,
+        const float * step,
+        size_t d);
+
+float fvec_L2sqr_fp16_ref (
+        const float * x,
+        const uint16_t * code,
+        size_t d);
+
+float fvec_inner_product_fp16_ref (
+        const float * x,
+        const uint16_t * code,
+        size_t d);
+
+#ifdef __SSE__
+void fvec_L2sqr_batch_sse (
+        float * dis,
+        const float * x,
+        const float * y,
+        size_t d, size_t ny);
+
+void fvec_inner_product_batch_sse (
+        float * dis,
+        const float * x,
+        const float * y,
+        size_t d, size_t ny);
+#endif
+
 /* compute ny square L2 distance bewteen x and a set of contiguous y vectors */
 void fvec_L2sqr_ny (
         float * dis,
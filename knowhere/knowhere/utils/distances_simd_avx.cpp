@@ -248,6 +248,165 @@ float fvec_Linf_avx (const float* x, const float* y, size_t d) {
     return  _mm_cvtss_f32 (msum2);
 }
 
+/*********************************************************
+ * Distances from one vector to a block of contiguous vectors
+ */
+
+// distances of x to y, y + d, y + 2 * d and y + 3 * d, d being a multiple of 8. x is loaded once for
+// the four of them. Always inlined, so that d is a constant in fvec_batch_avx_d<IP, D> and the loop unrolls.
+template <bool IP>
+static inline __attribute__((always_inline)) __m128
+fvec_4_avx (const float* x, const float* y, size_t d) {
+    const float* y1 = y + d;
+    const float* y2 = y1 + d;
+    const float* y3 = y2 + d;
+    __m256 msum0 = _mm256_setzero_ps();
+    __m256 msum1 = _mm256_setzero_ps();
+    __m256 msum2 = _mm256_setzero_ps();
+    __m256 msum3 = _mm256_setzero_ps();
+
+    for (size_t i = 0; i < d; i += 8) {
+        __m256 mx = _mm256_loadu_ps (x + i);
+        __m256 my0 = _mm256_loadu_ps (y + i);
+        __m256 my1 = _mm256_loadu_ps (y1 + i);
+        __m256 my2 = _mm256_loadu_ps (y2 + i);
+        __m256 my3 = _mm256_loadu_ps (y3 + i);
+        if (IP) {
+            msum0 += mx * my0;
+            msum1 += mx * my1;
+            msum2 += mx * my2;
+            msum3 += mx * my3;
+        } else {
+            my0 = mx - my0;
+            my1 = mx - my1;
+            my2 = mx - my2;
+            my3 = mx - my3;
+            msum0 += my0 * my0;
+            msum1 += my1 * my1;
+            msum2 += my2 * my2;
+            msum3 += my3 * my3;
+        }
+    }
+
+    // per 128-bit lane, the partial sums of the four vectors in order
+    __m256 msum = _mm256_hadd_ps (_mm256_hadd_ps (msum0, msum1), _mm256_hadd_ps (msum2, msum3));
+    return _mm256_extractf128_ps(msum, 1) + _mm256_extractf128_ps(msum, 0);
+}
+
+// D is the dimension when known at compile time, 0 otherwise
+template <bool IP, size_t D>
+static void fvec_batch_avx_d (float* dis, const float* x, const float* y, size_t d, size_t ny) {
+    const size_t dim = D ? D : d;
+    size_t j = 0;
+    for (; j + 4 <= ny; j += 4) {
+        _mm_storeu_ps (dis + j, fvec_4_avx<IP> (x, y + j * dim, dim));
+    }
+    for (; j < ny; j++) {
+        dis[j] = IP ? fvec_inner_product_avx (x, y + j * dim, dim) : fvec_L2sqr_avx (x, y + j * dim, dim);
+    }
+}
+
+template <bool IP>
+static void fvec_batch_avx (float* dis, const float* x, const float* y, size_t d, size_t ny) {
+    switch (d) {
+    case 64:
+        return fvec_batch_avx_d<IP, 64> (dis, x, y, d, ny);
+    case 96:
+        return fvec_batch_avx_d<IP, 96> (dis, x, y, d, ny);
+    case 128:
+        return fvec_batch_avx_d<IP, 128> (dis, x, y, d, ny);
+    case 256:
+        return fvec_batch_avx_d<IP, 256> (dis, x, y, d, ny);
+    case 384:
+        return fvec_batch_avx_d<IP, 384> (dis, x, y, d, ny);
+    case 512:
+        return fvec_batch_avx_d<IP, 512> (dis, x, y, d, ny);
+    case 768:
+        return fvec_batch_avx_d<IP, 768> (dis, x, y, d, ny);
+    case 1024:
+        return fvec_batch_avx_d<IP, 1024> (dis, x, y, d, ny);
+    default:
+        if (d % 8 == 0) {
+            return fvec_batch_avx_d<IP, 0> (dis, x, y, d, ny);
+        }
+        for (size_t j = 0; j < ny; j++) {
+            dis[j] = IP ? fvec_inner_product_avx (x, y + j * d, d) : fvec_L2sqr_avx (x, y + j * d, d);
+        }
+    }
+}
+
+void fvec_L2sqr_batch_avx (float* dis, const float* x, const float* y, size_t d, size_t ny) {
+    fvec_batch_avx<false> (dis, x, y, d, ny);
+}
+
+void fvec_inner_product_batch_avx (float* dis, const float* x, const float* y, size_t d, size_t ny) {
+    fvec_batch_avx<true> (dis, x, y, d, ny);
+}
+
+static inline float hsum_avx (__m256 v) {
+    __m128 msum = _mm256_extractf128_ps(v, 1);
+    msum +=       _mm256_extractf128_ps(v, 0);
+    msum = _mm_hadd_ps (msum, msum);
+    msum = _mm_hadd_ps (msum, msum);
+    return _mm_cvtss_f32 (msum);
+}
+
+// 8 components of a SQ8 code: vmin + code * step
+static inline __m256 sq8_decode_8 (const uint8_t* code, const float* vmin, const float* step) {
+    __m256i c = _mm256_cvtepu8_epi32 (_mm_loadl_epi64 ((const __m128i*)code));
+    return _mm256_add_ps (_mm256_loadu_ps (vmin), _mm256_mul_ps (_mm256_cvtepi32_ps (c), _mm256_loadu_ps (step)));
+}
+
+template <bool IP>
+static inline float fvec_sq8_avx (const float* x, const uint8_t* code, const float* vmin, const float* step, size_t d) {
+    __m256 msum = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= d; i += 8) {
+        __m256 mx = _mm256_loadu_ps (x + i);
+        __m256 my = sq8_decode_8 (code + i, vmin + i, step + i);
+        msum += IP ? mx * my : (mx - my) * (mx - my);
+    }
+    float res = hsum_avx (msum);
+    for (; i < d; i++) {
+        float y = vmin[i] + code[i] * step[i];
+        res += IP ? x[i] * y : (x[i] - y) * (x[i] - y);
+    }
+    return res;
+}
+
+template <bool IP>
+static inline float fvec_fp16_avx (const float* x, const uint16_t* code, size_t d) {
+    __m256 msum = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= d; i += 8) {
+        __m256 mx = _mm256_loadu_ps (x + i);
+        __m256 my = _mm256_cvtph_ps (_mm_loadu_si128 ((const __m128i*)(code + i)));
+        msum += IP ? mx * my : (mx - my) * (mx - my);
+    }
+    float res = hsum_avx (msum);
+    for (; i < d; i++) {
+        float y = _cvtsh_ss (code[i]);
+        res += IP ? x[i] * y : (x[i] - y) * (x[i] - y);
+    }
+    return res;
+}
+
+float fvec_L2sqr_sq8_avx (const float* x, const uint8_t* code, const float* vmin, const float* step, size_t d) {
+    return fvec_sq8_avx<false> (x, code, vmin, step, d);
+}
+
+float fvec_inner_product_sq8_avx (const float* x, const uint8_t* code, const float* vmin, const float* step, size_t d) {
+    return fvec_sq8_avx<true> (x, code, vmin, step, d);
+}
+
+float fvec_L2sqr_fp16_avx (const float* x, const uint16_t* code, size_t d) {
+    return fvec_fp16_avx<false> (x, code, d);
+}
+
+float fvec_inner_product_fp16_avx (const float* x, const uint16_t* code, size_t d) {
+    return fvec_fp16_avx<true> (x, code, d);
+}
+
 #define DECLARE_LOOKUP \
 const __m256i lookup = _mm256_setr_epi8( \
                 /* 0 */ 0, /* 1 */ 1, /* 2 */ 1, /* 3 */ 2, \
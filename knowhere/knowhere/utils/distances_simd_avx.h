@@ -31,6 +31,26 @@ fvec_L1_avx(const float* x, const float* y, size_t d);
 float
 fvec_Linf_avx(const float* x, const float* y, size_t d);
 
+/// squared L2 distances / inner products between x and ny contiguous vectors y
+void
+fvec_L2sqr_batch_avx(float* dis, const float* x, const float* y, size_t d, size_t ny);
+
+void
+fvec_inner_product_batch_avx(float* dis, const float* x, const float* y, size_t d, size_t ny);
+
+/// squared L2 distance / inner product between x and a SQ8 or FP16 code, see fvec_L2sqr_sq8_ref
+float
+fvec_L2sqr_sq8_avx(const float* x, const uint8_t* code, const float* vmin, const float* step, size_t d);
+
+float
+fvec_inner_product_sq8_avx(const float* x, const uint8_t* code, const float* vmin, const float* step, size_t d);
+
+float
+fvec_L2sqr_fp16_avx(const float* x, const uint16_t* code, size_t d);
+
+float
+fvec_inner_product_fp16_avx(const float* x, const uint16_t* code, size_t d);
+
 /// binary distance
 int
 xor_popcnt_AVX2_lookup(const uint8_t* data1, const uint8_t* data2, const size_t n);
@@ -215,6 +215,166 @@ fvec_Linf_avx512(const float* x, const float* y, size_t d) {
     return  _mm_cvtss_f32 (msum2);
 }
 
+/*********************************************************
+ * Distances from one vector to a block of contiguous vectors
+ */
+
+static inline __m256
+fold_avx512 (__m512 v) {
+    return _mm512_extractf32x8_ps(v, 1) + _mm512_extractf32x8_ps(v, 0);
+}
+
+// distances of x to y, y + d, y + 2 * d and y + 3 * d, d being a multiple of 16. x is loaded once for
+// the four of them. Always inlined, so that d is a constant in fvec_batch_avx512_d<IP, D> and the loop unrolls.
+template <bool IP>
+static inline __attribute__((always_inline)) __m128
+fvec_4_avx512 (const float* x, const float* y, size_t d) {
+    const float* y1 = y + d;
+    const float* y2 = y1 + d;
+    const float* y3 = y2 + d;
+    __m512 msum0 = _mm512_setzero_ps();
+    __m512 msum1 = _mm512_setzero_ps();
+    __m512 msum2 = _mm512_setzero_ps();
+    __m512 msum3 = _mm512_setzero_ps();
+
+    for (size_t i = 0; i < d; i += 16) {
+        __m512 mx = _mm512_loadu_ps (x + i);
+        __m512 my0 = _mm512_loadu_ps (y + i);
+        __m512 my1 = _mm512_loadu_ps (y1 + i);
+        __m512 my2 = _mm512_loadu_ps (y2 + i);
+        __m512 my3 = _mm512_loadu_ps (y3 + i);
+        if (IP) {
+            msum0 += mx * my0;
+            msum1 += mx * my1;
+            msum2 += mx * my2;
+            msum3 += mx * my3;
+        } else {
+            my0 = mx - my0;
+            my1 = mx - my1;
+            my2 = mx - my2;
+            my3 = mx - my3;
+            msum0 += my0 * my0;
+            msum1 += my1 * my1;
+            msum2 += my2 * my2;
+            msum3 += my3 * my3;
+        }
+    }
+
+    // per 128-bit lane, the partial sums of the four vectors in order
+    __m256 msum = _mm256_hadd_ps (_mm256_hadd_ps (fold_avx512 (msum0), fold_avx512 (msum1)),
+                                  _mm256_hadd_ps (fold_avx512 (msum2), fold_avx512 (msum3)));
+    return _mm256_extractf128_ps(msum, 1) + _mm256_extractf128_ps(msum, 0);
+}
+
+// D is the dimension when known at compile time, 0 otherwise
+template <bool IP, size_t D>
+static void fvec_batch_avx512_d (float* dis, const float* x, const float* y, size_t d, size_t ny) {
+    const size_t dim = D ? D : d;
+    size_t j = 0;
+    for (; j + 4 <= ny; j += 4) {
+        _mm_storeu_ps (dis + j, fvec_4_avx512<IP> (x, y + j * dim, dim));
+    }
+    for (; j < ny; j++) {
+        dis[j] = IP ? fvec_inner_product_avx512 (x, y + j * dim, dim) : fvec_L2sqr_avx512 (x, y + j * dim, dim);
+    }
+}
+
+template <bool IP>
+static void fvec_batch_avx512 (float* dis, const float* x, const float* y, size_t d, size_t ny) {
+    switch (d) {
+    case 64:
+        return fvec_batch_avx512_d<IP, 64> (dis, x, y, d, ny);
+    case 96:
+        return fvec_batch_avx512_d<IP, 96> (dis, x, y, d, ny);
+    case 128:
+        return fvec_batch_avx512_d<IP, 128> (dis, x, y, d, ny);
+    case 256:
+        return fvec_batch_avx512_d<IP, 256> (dis, x, y, d, ny);
+    case 384:
+        return fvec_batch_avx512_d<IP, 384> (dis, x, y, d, ny);
+    case 512:
+        return fvec_batch_avx512_d<IP, 512> (dis, x, y, d, ny);
+    case 768:
+        return fvec_batch_avx512_d<IP, 768> (dis, x, y, d, ny);
+    case 1024:
+        return fvec_batch_avx512_d<IP, 1024> (dis, x, y, d, ny);
+    default:
+        if (d % 16 == 0) {
+            return fvec_batch_avx512_d<IP, 0> (dis, x, y, d, ny);
+        }
+        for (size_t j = 0; j < ny; j++) {
+            dis[j] = IP ? fvec_inner_product_avx512 (x, y + j * d, d) : fvec_L2sqr_avx512 (x, y + j * d, d);
+        }
+    }
+}
+
+void
+fvec_L2sqr_batch_avx512(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+    fvec_batch_avx512<false> (dis, x, y, d, ny);
+}
+
+void
+fvec_inner_product_batch_avx512(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+    fvec_batch_avx512<true> (dis, x, y, d, ny);
+}
+
+template <bool IP>
+static inline float
+fvec_sq8_avx512(const float* x, const uint8_t* code, const float* vmin, const float* step, size_t d) {
+    __m512 msum = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= d; i += 16) {
+        __m512 mx = _mm512_loadu_ps (x + i);
+        __m512 mc = _mm512_cvtepi32_ps (_mm512_cvtepu8_epi32 (_mm_loadu_si128 ((const __m128i*)(code + i))));
+        __m512 my = _mm512_add_ps (_mm512_loadu_ps (vmin + i), _mm512_mul_ps (mc, _mm512_loadu_ps (step + i)));
+        msum += IP ? mx * my : (mx - my) * (mx - my);
+    }
+    float res = _mm512_reduce_add_ps (msum);
+    for (; i < d; i++) {
+        float y = vmin[i] + code[i] * step[i];
+        res += IP ? x[i] * y : (x[i] - y) * (x[i] - y);
+    }
+    return res;
+}
+
+template <bool IP>
+static inline float
+fvec_fp16_avx512(const float* x, const uint16_t* code, size_t d) {
+    __m512 msum = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= d; i += 16) {
+        __m512 mx = _mm512_loadu_ps (x + i);
+        __m512 my = _mm512_cvtph_ps (_mm256_loadu_si256 ((const __m256i*)(code + i)));
+        msum += IP ? mx * my : (mx - my) * (mx - my);
+    }
+    float res = _mm512_reduce_add_ps (msum);
+    for (; i < d; i++) {
+        float y = _cvtsh_ss (code[i]);
+        res += IP ? x[i] * y : (x[i] - y) * (x[i] - y);
+    }
+    return res;
+}
+
+float
+fvec_L2sqr_sq8_avx512(const float* x, const uint8_t* code, const float* vmin, const float* step, size_t d) {
+    return fvec_sq8_avx512<false> (x, code, vmin, step, d);
+}
+
+float
+fvec_inner_product_sq8_avx512(const float* x, const uint8_t* code, const float* vmin, const float* step, size_t d) {
+    return fvec_sq8_avx512<true> (x, code, vmin, step, d);
+}
+
+float
+fvec_L2sqr_fp16_avx512(const float* x, const uint16_t* code, size_t d) {
+    return fvec_fp16_avx512<false> (x, code, d);
+}
+
+float
+fvec_inner_product_fp16_avx512(const float* x, const uint16_t* code, size_t d) {
+    return fvec_fp16_avx512<true> (x, code, d);
+}
+
 std::uint64_t
 _mm256_hsum_epi64(__m256i v) {
     return _mm256_extract_epi64(v, 0)
@@ -834,7 +834,8 @@ class AnnoyIndexInterface {
   virtual bool save(const char* filename, bool prefault=false, char** error=nullptr) = 0;
   virtual void unload() = 0;
   virtual bool load(const char* filename, bool prefault=false, char** error=nullptr) = 0;
-  virtual bool load_index(void* index_data, const int64_t& index_size, char** error = nullptr) = 0;
+  virtual bool load_index(void* index_data, const int64_t& index_size, char** error = nullptr,
+                          bool in_place = false) = 0;
   virtual T get_distance(S i, S j) const = 0;
   virtual void get_nns_by_item(S item, size_t n, int64_t search_k, vector<S>* result, vector<T>* distances,
                                const faiss::BitsetView bitset = nullptr) const = 0;
@@ -880,6 +881,7 @@ protected:
   int _fd;
   bool _on_disk;
   bool _built;
+  bool _borrowed; // _nodes references a buffer owned by the caller of load_index
 public:
 
    AnnoyIndex(int f) : _f(f), _random() {
@@ -1053,6 +1055,7 @@ public:
     _n_nodes = 0;
     _nodes_size = 0;
     _on_disk = false;
+    _borrowed = false;
     _roots.clear();
   }
 
@@ -1065,7 +1068,7 @@ public:
         // we have mmapped data
         close(_fd);
         munmap(_nodes, _n_nodes * _s);
-      } else if (_nodes) {
+      } else if (_nodes && !_borrowed) {
         // We have heap allocated data
         free(_nodes);
       }
@@ -1127,7 +1130,8 @@ public:
     return true;
   }
 
-  bool load_index(void* index_data, const int64_t& index_size, char** error) {
+  // in_place: reference index_data instead of copying it, the caller keeps it alive until unload()
+  bool load_index(void* index_data, const int64_t& index_size, char** error, bool in_place) {
     if (index_size == -1) {
       set_error_from_errno(error, "Unable to get size");
       return false;
@@ -1141,13 +1145,18 @@ public:
     }
 
     _n_nodes = (S)(index_size / _s);
+    if (in_place) {
+      _nodes = index_data;
+      _borrowed = true;
+    } else {
 //    _nodes = (Node*)malloc(_s * _n_nodes);
-    _nodes = (Node*)malloc((size_t)index_size);
-    if (_nodes == nullptr) {
-        set_error_from_errno(error, "alloc failed when load_index 4 annoy");
-        return false;
+      _nodes = (Node*)malloc((size_t)index_size);
+      if (_nodes == nullptr) {
+          set_error_from_errno(error, "alloc failed when load_index 4 annoy");
+          return false;
+      }
+      memcpy(_nodes, index_data, (size_t)index_size);
     }
-    memcpy(_nodes, index_data, (size_t)index_size);
 
     // Find the roots by scanning the end of the file and taking the nodes with most descendants
     _roots.clear();
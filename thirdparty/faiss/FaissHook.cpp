@@ -5,6 +5,8 @@
 #include <mutex>
 
 #include <faiss/FaissHook.h>
+#include <faiss/impl/PQ4FastScan.h>
+#include <faiss/impl/PQ4FastScan_avx.h>
 #include <faiss/impl/ScalarQuantizerDC.h>
 #include <faiss/impl/ScalarQuantizerDC_avx.h>
 #include <faiss/impl/ScalarQuantizerDC_avx512.h>
@@ -30,6 +32,9 @@ void hook_init(std::string& simd_type) {
         sq_sel_quantizer = sq_select_quantizer_avx512;
         sq_sel_inv_list_scanner = sq_select_inverted_list_scanner_avx512;
 
+        /* for IVFPQ fast scan */
+        pq4_accumulate = pq4_accumulate_avx;
+
         type = "AVX512";
     } else if (faiss_use_avx2 && cpu_support_avx2()) {
         /* for IVFSQ */
@@ -37,6 +42,9 @@ void hook_init(std::string& simd_type) {
         sq_sel_quantizer = sq_select_quantizer_avx;
         sq_sel_inv_list_scanner = sq_select_inverted_list_scanner_avx;
 
+        /* for IVFPQ fast scan */
+        pq4_accumulate = pq4_accumulate_avx;
+
         type = "AVX2";
     } else if (faiss_use_sse4_2 && cpu_support_sse4_2()) {
         /* for IVFSQ */
@@ -44,6 +52,9 @@ void hook_init(std::string& simd_type) {
         sq_sel_quantizer = sq_select_quantizer_ref;
         sq_sel_inv_list_scanner = sq_select_inverted_list_scanner_ref;
 
+        /* for IVFPQ fast scan */
+        pq4_accumulate = pq4_accumulate_ref;
+
         type = "SSE4_2";
     } else {
         /* for IVFSQ */
@@ -51,6 +62,9 @@ void hook_init(std::string& simd_type) {
         sq_sel_quantizer = sq_select_quantizer_ref;
         sq_sel_inv_list_scanner = sq_select_inverted_list_scanner_ref;
 
+        /* for IVFPQ fast scan */
+        pq4_accumulate = pq4_accumulate_ref;
+
         type = "REF";
     }
     std::cout << "FAISS SQ8 hook " << type << std::endl;
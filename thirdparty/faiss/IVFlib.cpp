@@ -186,10 +186,10 @@ SlidingIndexWindow::SlidingIndexWindow (Index *index): index (index) {
     sizes.resize(nlist);
 }
 
-template<class T>
-static void shift_and_add (std::vector<T> & dst,
+template<class T, class A>
+static void shift_and_add (std::vector<T, A> & dst,
                            size_t remove,
-                           const std::vector<T> & src)
+                           const std::vector<T, A> & src)
 {
     if (remove > 0)
         memmove (dst.data(), dst.data() + remove,
@@ -199,8 +199,8 @@ static void shift_and_add (std::vector<T> & dst,
     memcpy (dst.data() + insert_point, src.data (), src.size() * sizeof(T));
 }
 
-template<class T>
-static void remove_from_begin (std::vector<T> & v,
+template<class T, class A>
+static void remove_from_begin (std::vector<T, A> & v,
                                size_t remove)
 {
     if (remove > 0)
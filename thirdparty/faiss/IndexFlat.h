@@ -14,6 +14,7 @@
 
 #include <faiss/Index.h>
 #include <faiss/impl/AuxIndexStructures.h>
+#include <faiss/utils/PayloadMemory.h>
 
 
 namespace faiss {
@@ -21,8 +22,8 @@ namespace faiss {
 /** Index that stores the full vectors and performs exhaustive search */
 struct IndexFlat: Index {
 
-    /// database vectors, size ntotal * d
-    std::vector<float> xb;
+    /// database vectors, size ntotal * d, placed following the payload memory policy
+    PayloadVector<float> xb;
 
     explicit IndexFlat (idx_t d, MetricType metric = METRIC_L2);
 
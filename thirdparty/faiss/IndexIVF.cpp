@@ -12,7 +12,9 @@
 
 #include <omp.h>
 
+#include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <memory>
 #include <iostream>
 
@@ -28,6 +30,39 @@ namespace faiss {
 using ScopedIds = InvertedLists::ScopedIds;
 using ScopedCodes = InvertedLists::ScopedCodes;
 
+namespace {
+
+/* list-major order of parallel_mode 2: the (query, probe) pairs
+ * i * nprobe + ik grouped by list, those of list l are
+ * list_probes[list_begin[l] .. list_begin[l + 1]) */
+void group_probes_by_list (size_t n, size_t nprobe, size_t nlist,
+                           const Index::idx_t *keys,
+                           std::vector<size_t> & list_begin,
+                           std::vector<Index::idx_t> & list_probes)
+{
+    list_begin.assign (nlist + 1, 0);
+    for (size_t i = 0; i < n * nprobe; i++) {
+        if (keys[i] >= 0) {
+            FAISS_THROW_IF_NOT_FMT (keys[i] < (Index::idx_t) nlist,
+                                    "Invalid key=%ld nlist=%ld\n",
+                                    keys[i], nlist);
+            list_begin[keys[i] + 1]++;
+        }
+    }
+    for (size_t l = 0; l < nlist; l++) {
+        list_begin[l + 1] += list_begin[l];
+    }
+    list_probes.resize (list_begin[nlist]);
+    std::vector<size_t> fill (list_begin.begin(), list_begin.end() - 1);
+    for (size_t i = 0; i < n * nprobe; i++) {
+        if (keys[i] >= 0) {
+            list_probes[fill[keys[i]]++] = i;
+        }
+    }
+}
+
+} // namespace
+
 /*****************************************
  * Level1Quantizer implementation
  ******************************************/
@@ -320,6 +355,15 @@ void IndexIVF::search (idx_t n, const float *x, idx_t k,
                        float *distances, idx_t *labels,
                        const BitsetView bitset) const
 {
+    search_with_params (n, x, k, distances, labels, nullptr, bitset);
+}
+
+void IndexIVF::search_with_params (idx_t n, const float *x, idx_t k,
+                                   float *distances, idx_t *labels,
+                                   const IVFSearchParameters *params,
+                                   const BitsetView bitset) const
+{
+    size_t nprobe = params ? params->nprobe : this->nprobe;
     std::unique_ptr<idx_t[]> idx(new idx_t[n * nprobe]);
     std::unique_ptr<float[]> coarse_dis(new float[n * nprobe]);
 
@@ -338,7 +382,7 @@ void IndexIVF::search (idx_t n, const float *x, idx_t k,
     invlists->prefetch_lists (idx.get(), n * nprobe);
 
     search_preassigned (n, x, k, idx.get(), coarse_dis.get(),
-                        distances, labels, false, nullptr, bitset);
+                        distances, labels, false, params, bitset);
     index_ivf_stats.search_time += getmillisecs() - t0;
 
 }
@@ -421,12 +465,40 @@ void IndexIVF::search_preassigned (idx_t n, const float *x, idx_t k,
     int pmode = this->parallel_mode & ~PARALLEL_MODE_NO_HEAP_INIT;
     bool do_heap_init = !(this->parallel_mode & PARALLEL_MODE_NO_HEAP_INIT);
 
+    // skipping a list needs the current k-th result of the query, which
+    // parallel_mode 1 splits over the threads
+    bool prune = params && params->list_radius && pmode != 1;
+
     // don't start parallel section if single query
     bool do_parallel =
         pmode == 0 ? n > 1 :
         pmode == 1 ? nprobe > 1 :
         nprobe * n > 1;
 
+    // list-major order: the (query, probe) pairs grouped by list
+    std::vector<size_t> list_begin;
+    std::vector<idx_t> list_probes;
+    std::vector<omp_lock_t> query_locks;
+    std::vector<float> qnorms;
+    if (pmode == 2) {
+        group_probes_by_list (n, nprobe, nlist, keys, list_begin, list_probes);
+        if (prune) {
+            qnorms.resize (n);
+            for (size_t i = 0; i < n; i++) {
+                const float *xi = x + i * d;
+                for (size_t j = 0; j < d; j++) {
+                    qnorms[i] += xi[j] * xi[j];
+                }
+                qnorms[i] = std::sqrt (qnorms[i]);
+            }
+        }
+        // results of a query are merged from several threads
+        query_locks.resize (std::min ((size_t)n, (size_t)4096));
+        for (auto & lock : query_locks) {
+            omp_init_lock (&lock);
+        }
+    }
+
 #pragma omp parallel if(do_parallel) reduction(+: nlistv, ndis, nheap)
     {
         InvertedListScanner *scanner = get_InvertedListScanner(store_pairs);
@@ -458,6 +530,15 @@ void IndexIVF::search_preassigned (idx_t n, const float *x, idx_t k,
             }
         };
 
+        // thread-local heaps merged into the results, always initialized
+        auto init_local = [&](float *simi, idx_t *idxi) {
+            if (metric_type == METRIC_INNER_PRODUCT) {
+                heap_heapify<HeapForIP> (k, simi, idxi);
+            } else {
+                heap_heapify<HeapForL2> (k, simi, idxi);
+            }
+        };
+
         // single list scan using the current scanner (with query
         // set porperly) and storing results in simi and idxi
         auto scan_one_list = [&] (idx_t key, float coarse_dis_i,
@@ -499,6 +580,21 @@ void IndexIVF::search_preassigned (idx_t n, const float *x, idx_t k,
             return list_size;
         };
 
+        // whether the entries of a list can beat the k-th result so far,
+        // from the triangle inequality on the list radius
+        auto may_improve = [&] (idx_t key, float coarse_dis_i,
+                                float qnorm, const float *simi) {
+            if (key < 0) {
+                return true;
+            }
+            float r = params->radius_ratio * params->list_radius[key];
+            if (metric_type == METRIC_INNER_PRODUCT) {
+                return coarse_dis_i + qnorm * r > simi[0];
+            }
+            float lb = std::sqrt (std::max (coarse_dis_i, 0.0f)) - r;
+            return lb <= 0 || lb * lb < simi[0];
+        };
+
         /****************************************************
          * Actual loops, depending on parallel_mode
          ****************************************************/
@@ -521,8 +617,22 @@ void IndexIVF::search_preassigned (idx_t n, const float *x, idx_t k,
 
                 long nscan = 0;
 
+                float qnorm = 0;
+                if (prune) {
+                    const float *xi = x + i * d;
+                    for (size_t j = 0; j < d; j++) {
+                        qnorm += xi[j] * xi[j];
+                    }
+                    qnorm = std::sqrt (qnorm);
+                }
+
                 // loop over probes
                 for (size_t ik = 0; ik < nprobe; ik++) {
+                    if (prune && !may_improve (keys [i * nprobe + ik],
+                                               coarse_dis[i * nprobe + ik],
+                                               qnorm, simi)) {
+                        continue;
+                    }
                     nscan += scan_one_list (
                          keys [i * nprobe + ik],
                          coarse_dis[i * nprobe + ik],
@@ -548,7 +658,7 @@ void IndexIVF::search_preassigned (idx_t n, const float *x, idx_t k,
 
             for (size_t i = 0; i < n; i++) {
                 scanner->set_query (x + i * d);
-                init_result (local_dis.data(), local_idx.data());
+                init_local (local_dis.data(), local_idx.data());
 
 #pragma omp for schedule(dynamic)
                 for (size_t ik = 0; ik < nprobe; ik++) {
@@ -583,12 +693,93 @@ void IndexIVF::search_preassigned (idx_t n, const float *x, idx_t k,
 #pragma omp single
                 reorder_result (simi, idxi);
             }
+        } else if (pmode == 2) {
+            std::vector <idx_t> local_idx (k);
+            std::vector <float> local_dis (k);
+
+#pragma omp for
+            for (size_t i = 0; i < n; i++) {
+                init_result (distances + i * k, labels + i * k);
+            }
+
+#pragma omp for schedule(dynamic)
+            for (size_t l = 0; l < nlist; l++) {
+                if (interrupt) {
+                    continue;
+                }
+                size_t list_size = invlists->list_size (l);
+                if (list_size == 0 || list_begin[l] == list_begin[l + 1]) {
+                    continue;
+                }
+
+                // the codes stay in cache while all their queries are scanned
+                InvertedLists::ScopedCodes scodes (invlists, l);
+                std::unique_ptr<InvertedLists::ScopedIds> sids;
+                const Index::idx_t * ids = nullptr;
+                if (!store_pairs)  {
+                    sids.reset (new InvertedLists::ScopedIds (invlists, l));
+                    ids = sids->get();
+                }
+
+                for (size_t p = list_begin[l]; p < list_begin[l + 1]; p++) {
+                    size_t i = list_probes[p] / nprobe;
+                    float * simi = distances + i * k;
+                    idx_t * idxi = labels + i * k;
+                    omp_lock_t * lock = &query_locks[i % query_locks.size()];
+
+                    // the lists are not visited in probe order, the bound
+                    // is the k-th result merged so far
+                    if (prune) {
+                        omp_set_lock (lock);
+                        bool skip = !may_improve (l, coarse_dis[list_probes[p]],
+                                                  qnorms[i], simi);
+                        omp_unset_lock (lock);
+                        if (skip) {
+                            continue;
+                        }
+                    }
+
+                    scanner->set_query (x + i * d);
+                    scanner->set_list (l, coarse_dis[list_probes[p]]);
+                    init_local (local_dis.data(), local_idx.data());
+                    nheap += scanner->scan_codes (list_size, scodes.get(), ids,
+                                                  local_dis.data(), local_idx.data(),
+                                                  k, bitset);
+                    nlistv++;
+                    ndis += list_size;
+
+                    omp_set_lock (lock);
+                    if (metric_type == METRIC_INNER_PRODUCT) {
+                        heap_addn<HeapForIP>
+                            (k, simi, idxi,
+                             local_dis.data(), local_idx.data(), k);
+                    } else {
+                        heap_addn<HeapForL2>
+                            (k, simi, idxi,
+                             local_dis.data(), local_idx.data(), k);
+                    }
+                    omp_unset_lock (lock);
+                }
+
+                if (InterruptCallback::is_interrupted ()) {
+                    interrupt = true;
+                }
+            }
+
+#pragma omp for
+            for (size_t i = 0; i < n; i++) {
+                reorder_result (distances + i * k, labels + i * k);
+            }
         } else {
             FAISS_THROW_FMT ("parallel_mode %d not supported\n",
                              pmode);
         }
     } // parallel section
 
+    for (auto & lock : query_locks) {
+        omp_destroy_lock (&lock);
+    }
+
     if (interrupt) {
         FAISS_THROW_MSG ("computation interrupted");
     }
@@ -839,6 +1030,13 @@ void IndexIVF::range_search_preassigned (
 
     size_t nlistv = 0, ndis = 0;
     bool store_pairs = false;
+    int pmode = this->parallel_mode & ~PARALLEL_MODE_NO_HEAP_INIT;
+
+    std::vector<size_t> list_begin;
+    std::vector<idx_t> list_probes;
+    if (pmode == 2) {
+        group_probes_by_list (nx, nprobe, nlist, keys, list_begin, list_probes);
+    }
 
     std::vector<RangeSearchPartialResult *> all_pres (omp_get_max_threads());
 
@@ -874,7 +1072,7 @@ void IndexIVF::range_search_preassigned (
                                        ids.get(), radius, qres, bitset);
         };
 
-        if (parallel_mode == 0) {
+        if (pmode == 0) {
 
 #pragma omp for
             for (size_t i = 0; i < nx; i++) {
@@ -888,7 +1086,7 @@ void IndexIVF::range_search_preassigned (
 
             }
 
-        } else if (parallel_mode == 1) {
+        } else if (pmode == 1) {
 
             for (size_t i = 0; i < nx; i++) {
                 scanner->set_query (x + i * d);
@@ -900,25 +1098,23 @@ void IndexIVF::range_search_preassigned (
                     scan_list_func (i, ik, qres);
                 }
             }
-        } else if (parallel_mode == 2) {
-            std::vector<RangeQueryResult *> all_qres (nx);
-            RangeQueryResult *qres = nullptr;
+        } else if (pmode == 2) {
 
+            // list-major as in search_preassigned, a query gets one partial
+            // result per list, the merge adds them up
 #pragma omp for schedule(dynamic)
-            for (size_t iik = 0; iik < nx * nprobe; iik++) {
-                size_t i = iik / nprobe;
-                size_t ik = iik % nprobe;
-                if (qres == nullptr || qres->qno != i) {
-                    FAISS_ASSERT (!qres || i > qres->qno);
-                    qres = &pres.new_result (i);
+            for (size_t l = 0; l < nlist; l++) {
+                for (size_t p = list_begin[l]; p < list_begin[l + 1]; p++) {
+                    size_t i = list_probes[p] / nprobe;
                     scanner->set_query (x + i * d);
+                    scan_list_func (i, list_probes[p] % nprobe,
+                                    pres.new_result (i));
                 }
-                scan_list_func (i, ik, *qres);
             }
         } else {
-            FAISS_THROW_FMT ("parallel_mode %d not supported\n", parallel_mode);
+            FAISS_THROW_FMT ("parallel_mode %d not supported\n", pmode);
         }
-        if (parallel_mode == 0) {
+        if (pmode == 0) {
             pres.finalize ();
         } else {
 #pragma omp barrier
@@ -1049,6 +1245,55 @@ size_t IndexIVF::remove_ids (const IDSelector & sel)
 }
 
 
+size_t IndexIVF::compact_ids (const idx_t *new_ids)
+{
+    FAISS_THROW_IF_NOT_MSG (direct_map.no(),
+                            "compact_ids not supported with a direct map");
+    auto ails = dynamic_cast<ArrayInvertedLists *> (invlists);
+
+    size_t nremove = 0;
+#pragma omp parallel for reduction(+: nremove)
+    for (size_t list_no = 0; list_no < nlist; list_no++) {
+        size_t list_size = invlists->list_size (list_no);
+        bool has_codes = !ails ||
+            ails->codes[list_no].size() == list_size * code_size;
+        size_t w = 0;
+        for (size_t j = 0; j < list_size; j++) {
+            idx_t id = invlists->get_single_id (list_no, j);
+            idx_t new_id = new_ids[id];
+            if (new_id < 0) {
+                continue;
+            }
+            if (ails) {
+                ails->ids[list_no][w] = new_id;
+                if (has_codes && w != j) {
+                    memmove (ails->codes[list_no].data() + w * code_size,
+                             ails->codes[list_no].data() + j * code_size,
+                             code_size);
+                }
+            } else {
+                InvertedLists::ScopedCodes code (invlists, list_no, j);
+                invlists->update_entry (list_no, w, new_id, code.get());
+            }
+            w++;
+        }
+        nremove += list_size - w;
+        if (w == list_size) {
+            continue;
+        }
+        if (ails) {
+            ails->ids[list_no].resize (w);
+            if (has_codes) {
+                ails->codes[list_no].resize (w * code_size);
+            }
+        } else {
+            invlists->resize (list_no, w);
+        }
+    }
+    ntotal -= nremove;
+    return nremove;
+}
+
 void IndexIVF::update_vectors (int n, const idx_t *new_ids, const float *x)
 {
 
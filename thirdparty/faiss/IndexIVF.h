@@ -72,6 +72,15 @@ struct Level1Quantizer {
 struct IVFSearchParameters {
     size_t nprobe;            ///< number of probes at query time
     size_t max_codes;         ///< max nb of codes to visit to do a query
+
+    /// per-list max distance of an entry to its centroid, size nlist. When
+    /// set, a probe whose entries cannot beat the current k-th result is
+    /// skipped (not with parallel_mode 1)
+    const float *list_radius = nullptr;
+    /// scale of list_radius in that bound: 1 keeps the result of scanning
+    /// all nprobe lists, smaller values skip more lists
+    float radius_ratio = 1.0f;
+
     virtual ~IVFSearchParameters () {}
 };
 
@@ -125,7 +134,10 @@ struct IndexIVF: Index, Level1Quantizer {
      *
      * 0 (default): parallelize over queries
      * 1: parallelize over inverted lists
-     * 2: parallelize over both
+     * 2: parallelize over inverted lists, each list is scanned once
+     *    for all the queries that probe it (for large batches), in
+     *    search and range_search; search_preassigned_without_codes
+     *    supports 0 and 1 only
      *
      * PARALLEL_MODE_NO_HEAP_INIT: binary or with the previous to
      * prevent the heap to be initialized and finalized
@@ -227,6 +239,12 @@ struct IndexIVF: Index, Level1Quantizer {
                  float *distances, idx_t *labels,
                  const BitsetView bitset = nullptr) const override;
 
+    /** search with parameters that override the object's ones */
+    void search_with_params (idx_t n, const float *x, idx_t k,
+                             float *distances, idx_t *labels,
+                             const IVFSearchParameters *params,
+                             const BitsetView bitset = nullptr) const;
+
 
     /** Similar to search, but does not store codes **/
     void search_without_codes (idx_t n, const float *x, 
@@ -307,6 +325,12 @@ struct IndexIVF: Index, Level1Quantizer {
 
     size_t remove_ids(const IDSelector& sel) override;
 
+    /** drops the entries with new_ids[id] < 0 and renumbers the others
+     * to new_ids[id], so that sequential ids stay sequential. new_ids has
+     * one slot per id, only without direct map. Lists added without codes
+     * keep having none. Returns the nb of entries removed */
+    size_t compact_ids (const idx_t *new_ids);
+
     /** check that the two indexes are compatible (ie, they are
      * trained in the same way and have the same
      * parameters). Otherwise throw. */
@@ -10,6 +10,7 @@
 #include <faiss/IndexIVFFlat.h>
 
 #include <cstdio>
+#include <algorithm>
 
 #include <faiss/IndexFlat.h>
 
@@ -153,6 +154,8 @@ void IndexIVFFlat::sa_decode (idx_t n, const uint8_t *bytes,
 
 namespace {
 
+// list entries whose distances are computed in one call
+const size_t scan_block_size = 64;
 
 template<MetricType metric, class C>
 struct IVFFlatScanner: InvertedListScanner {
@@ -172,6 +175,16 @@ struct IVFFlatScanner: InvertedListScanner {
         this->list_no = list_no;
     }
 
+    /// distances to the ny contiguous vectors yj, computed together by the
+    /// dimension-specialized kernels behind the fvec_*_batch hooks
+    void distances_to_block (const float *yj, size_t ny, float *dis) const {
+        if (metric == METRIC_INNER_PRODUCT) {
+            fvec_inner_product_batch (dis, xi, yj, d, ny);
+        } else {
+            fvec_L2sqr_batch (dis, xi, yj, d, ny);
+        }
+    }
+
     float distance_to_code (const uint8_t *code) const override {
         const float *yj = (float*)code;
         float dis = metric == METRIC_INNER_PRODUCT ?
@@ -188,8 +201,23 @@ struct IVFFlatScanner: InvertedListScanner {
     {
         const float *list_vecs = (const float*)codes;
         size_t nup = 0;
+        if (!bitset) {
+            float dis[scan_block_size];
+            for (size_t j0 = 0; j0 < list_size; j0 += scan_block_size) {
+                size_t nblock = std::min(list_size - j0, scan_block_size);
+                distances_to_block (list_vecs + d * j0, nblock, dis);
+                for (size_t j = j0; j < j0 + nblock; j++) {
+                    if (C::cmp (simi[0], dis[j - j0])) {
+                        int64_t id = store_pairs ? (list_no << 32 | j) : ids[j];
+                        heap_swap_top<C> (k, simi, idxi, dis[j - j0], id);
+                        nup++;
+                    }
+                }
+            }
+            return nup;
+        }
         for (size_t j = 0; j < list_size; j++) {
-            if (!bitset || !bitset.test(ids[j])) {
+            if (!bitset.test(ids[j])) {
                 const float * yj = list_vecs + d * j;
                 float dis = metric == METRIC_INNER_PRODUCT ?
                             fvec_inner_product (xi, yj, d) : fvec_L2sqr (xi, yj, d);
@@ -211,13 +239,15 @@ struct IVFFlatScanner: InvertedListScanner {
                            const BitsetView bitset = nullptr) const override
     {
         const float *list_vecs = (const float*)codes;
-        for (size_t j = 0; j < list_size; j++) {
-            const float * yj = list_vecs + d * j;
-            float dis = metric == METRIC_INNER_PRODUCT ?
-                fvec_inner_product (xi, yj, d) : fvec_L2sqr (xi, yj, d);
-            if (C::cmp (radius, dis)) {
-                int64_t id = store_pairs ? lo_build (list_no, j) : ids[j];
-                res.add (dis, id);
+        float dis[scan_block_size];
+        for (size_t j0 = 0; j0 < list_size; j0 += scan_block_size) {
+            size_t nblock = std::min(list_size - j0, scan_block_size);
+            distances_to_block (list_vecs + d * j0, nblock, dis);
+            for (size_t j = j0; j < j0 + nblock; j++) {
+                if (C::cmp (radius, dis[j - j0])) {
+                    int64_t id = store_pairs ? lo_build (list_no, j) : ids[j];
+                    res.add (dis[j - j0], id);
+                }
             }
         }
     }
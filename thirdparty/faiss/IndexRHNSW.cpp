@@ -238,7 +238,13 @@ void IndexRHNSW::train(idx_t n, const float* x)
 
 void IndexRHNSW::search (idx_t n, const float *x, idx_t k,
                         float *distances, idx_t *labels, const BitsetView bitset) const
+{
+    search (n, x, k, distances, labels, bitset, RHNSW::FILTER_WALK);
+}
 
+void IndexRHNSW::search (idx_t n, const float *x, idx_t k,
+                        float *distances, idx_t *labels, const BitsetView bitset,
+                        RHNSW::FilterMode filter_mode) const
 {
     FAISS_THROW_IF_NOT_MSG(storage,
        "Please use IndexRHNSWFlat (or variants) instead of IndexRHNSW directly");
@@ -267,10 +273,10 @@ void IndexRHNSW::search (idx_t n, const float *x, idx_t k,
                 dis->set_query(x + i * d);
 
                 if (STATISTICS_LEVEL == 3)
-                    hnsw.searchKnn(*dis, k, idxi, simi, query_stats[i], bitset);
+                    hnsw.searchKnn(*dis, k, idxi, simi, query_stats[i], bitset, filter_mode);
                 else {
                     auto dummy_stat = RHNSWStatInfo();
-                    hnsw.searchKnn(*dis, k, idxi, simi, dummy_stat, bitset);
+                    hnsw.searchKnn(*dis, k, idxi, simi, dummy_stat, bitset, filter_mode);
                 }
 
                 if (reconstruct_from_neighbors &&
@@ -95,6 +95,11 @@ struct IndexRHNSW : Index {
                  float *distances, idx_t *labels,
                  const BitsetView bitset = nullptr) const override;
 
+    /// search with the given walk around the entries filtered out by the bitset
+    void search (idx_t n, const float *x, idx_t k,
+                 float *distances, idx_t *labels,
+                 const BitsetView bitset, RHNSW::FilterMode filter_mode) const;
+
     void reconstruct(idx_t key, float* recons) const override;
 
     void reset () override;
@@ -517,6 +517,31 @@ void ReadOnlyInvertedLists::resize (size_t , size_t )
 
 
 
+/*****************************************
+ * ViewInvertedLists implementation
+ ******************************************/
+
+ViewInvertedLists::ViewInvertedLists (size_t nlist, size_t code_size):
+    ReadOnlyInvertedLists (nlist, code_size),
+    sizes (nlist, 0), codes (nlist, nullptr), ids (nlist, nullptr)
+{}
+
+size_t ViewInvertedLists::list_size(size_t list_no) const
+{
+    return sizes[list_no];
+}
+
+const uint8_t * ViewInvertedLists::get_codes (size_t list_no) const
+{
+    return codes[list_no];
+}
+
+const InvertedLists::idx_t * ViewInvertedLists::get_ids (size_t list_no) const
+{
+    return ids[list_no];
+}
+
+
 /*****************************************
  * HStackInvertedLists implementation
  ******************************************/
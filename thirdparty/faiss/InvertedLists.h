@@ -18,6 +18,7 @@
 #include <memory>
 #include <vector>
 #include <faiss/Index.h>
+#include <faiss/utils/PayloadMemory.h>
 
 #ifndef USE_CPU
 namespace faiss {
@@ -223,7 +224,7 @@ struct InvertedLists {
 
 /// simple (default) implementation as an array of inverted lists
 struct ArrayInvertedLists: InvertedLists {
-    std::vector < std::vector<uint8_t> > codes; // binary codes, size nlist
+    std::vector < PayloadVector<uint8_t> > codes; // binary codes, size nlist
     std::vector < std::vector<idx_t> > ids;  ///< Inverted lists for indexes
 
     ArrayInvertedLists (size_t nlist, size_t code_size);
@@ -328,6 +329,25 @@ struct ReadOnlyInvertedLists: InvertedLists {
 };
 
 
+/** Inverted lists whose codes and ids are referenced in place inside an
+ * externally owned buffer (typically a memory-mapped index file).
+ *
+ * Nothing is copied or freed, the owner of the buffer must keep it alive
+ * as long as this object is used.
+ */
+struct ViewInvertedLists: ReadOnlyInvertedLists {
+    std::vector <size_t> sizes;
+    std::vector <const uint8_t*> codes;
+    std::vector <const idx_t*> ids;
+
+    ViewInvertedLists (size_t nlist, size_t code_size);
+
+    size_t list_size(size_t list_no) const override;
+    const uint8_t * get_codes (size_t list_no) const override;
+    const idx_t * get_ids (size_t list_no) const override;
+};
+
+
 /// Horizontal stack of inverted lists
 struct HStackInvertedLists: ReadOnlyInvertedLists {
 
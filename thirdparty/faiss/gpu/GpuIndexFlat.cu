@@ -89,7 +89,7 @@ GpuIndexFlat::copyFrom(const faiss::IndexFlat* index) {
   xb_.clear();
 
   if (config_.storeInCpu) {
-    xb_ = index->xb;
+    xb_.assign(index->xb.begin(), index->xb.end());
   }
 }
 
@@ -0,0 +1,84 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <faiss/impl/PQ4FastScan.h>
+
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+
+namespace faiss {
+
+pq4_accumulate_func_ptr pq4_accumulate = pq4_accumulate_ref;
+
+void pq4_pack_codes(const uint8_t* codes, size_t n, size_t M, uint8_t* packed) {
+    size_t M2 = pq4_padded_M(M);
+    size_t code_size = (M + 1) / 2;
+    memset(packed, 0, pq4_packed_size(n, M));
+    for (size_t i = 0; i < n; i++) {
+        uint8_t* block = packed + (i / pq4_block_size) * M2 * 16;
+        size_t j = i % pq4_block_size;
+        const uint8_t* code = codes + i * code_size;
+        for (size_t m = 0; m < M; m++) {
+            uint8_t c = (code[m / 2] >> ((m & 1) * 4)) & 15;
+            block[m * 16 + (j & 15)] |= (j < 16) ? c : (uint8_t)(c << 4);
+        }
+    }
+}
+
+void pq4_quantize_lut(const float* lut, size_t M, uint8_t* lut_q, float& scale, float& bias) {
+    size_t M2 = pq4_padded_M(M);
+    bias = 0;
+    float max_span = 0;
+    for (size_t m = 0; m < M; m++) {
+        const float* t = lut + m * 16;
+        float lo = *std::min_element(t, t + 16);
+        float hi = *std::max_element(t, t + 16);
+        bias += lo;
+        max_span = std::max(max_span, hi - lo);
+    }
+    // the M2 entries of a code must add up to at most 65535
+    float max_entry = std::min(255.0f, std::floor(65535.0f / M2));
+    scale = max_span > 0 ? max_entry / max_span : 1.0f;
+
+    for (size_t m = 0; m < M; m++) {
+        const float* t = lut + m * 16;
+        float lo = *std::min_element(t, t + 16);
+        for (size_t j = 0; j < 16; j++) {
+            float q = std::round((t[j] - lo) * scale);
+            lut_q[m * 16 + j] = (uint8_t)std::min(q, max_entry);
+        }
+    }
+    if (M2 > M) {
+        memset(lut_q + M * 16, 0, 16);
+    }
+}
+
+void pq4_accumulate_ref(const uint8_t* packed, size_t nblocks, size_t M, const uint8_t* lut_q, uint16_t* out) {
+    size_t M2 = pq4_padded_M(M);
+    for (size_t b = 0; b < nblocks; b++) {
+        const uint8_t* block = packed + b * M2 * 16;
+        uint16_t* dis = out + b * pq4_block_size;
+        for (size_t j = 0; j < pq4_block_size; j++) {
+            dis[j] = 0;
+        }
+        for (size_t m = 0; m < M2; m++) {
+            const uint8_t* codes = block + m * 16;
+            const uint8_t* t = lut_q + m * 16;
+            for (size_t j = 0; j < 16; j++) {
+                dis[j] += t[codes[j] & 15];
+                dis[j + 16] += t[codes[j] >> 4];
+            }
+        }
+    }
+}
+
+} // namespace faiss
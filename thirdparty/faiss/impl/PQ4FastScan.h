@@ -0,0 +1,68 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Scan of 4-bit PQ codes with 8-bit lookup tables held in SIMD registers.
+ *
+ * Codes are packed in blocks of pq4_block_size vectors. Inside a block,
+ * sub-quantizer m occupies 16 bytes: byte j holds the code of vector j in
+ * its low nibble and the code of vector j + 16 in its high nibble. The
+ * number of sub-quantizers is rounded up to an even number M2, so a block
+ * is M2 * 16 bytes and two sub-quantizers fill a 256-bit register. */
+
+namespace faiss {
+
+constexpr size_t pq4_block_size = 32;
+
+/// number of sub-quantizers once padded, M rounded up to an even number
+inline size_t pq4_padded_M(size_t M) {
+    return (M + 1) & ~(size_t)1;
+}
+
+/// bytes taken by n packed codes of M sub-quantizers
+inline size_t pq4_packed_size(size_t n, size_t M) {
+    return (n + pq4_block_size - 1) / pq4_block_size * pq4_padded_M(M) * 16;
+}
+
+/** pack n codes as produced by ProductQuantizer::compute_codes with nbits = 4
+ * (sub-quantizer 2i in the low nibble of byte i, 2i + 1 in the high one),
+ * packed must hold pq4_packed_size(n, M) bytes */
+void pq4_pack_codes(const uint8_t* codes, size_t n, size_t M, uint8_t* packed);
+
+/// code of sub-quantizer m of vector i in packed codes
+inline uint8_t pq4_get_code(const uint8_t* packed, size_t i, size_t m, size_t M) {
+    const uint8_t* block = packed + (i / pq4_block_size) * pq4_padded_M(M) * 16;
+    size_t j = i % pq4_block_size;
+    uint8_t byte = block[m * 16 + (j & 15)];
+    return j < 16 ? (byte & 15) : (byte >> 4);
+}
+
+/** quantize the float table of M x 16 distances to 8 bits, padded to
+ * pq4_padded_M(M) x 16 entries. The distance of a code is then
+ * approximately bias + sum(lut_q) / scale. Entries are bounded so that
+ * the sum over all sub-quantizers fits in 16 bits. */
+void pq4_quantize_lut(const float* lut, size_t M, uint8_t* lut_q, float& scale, float& bias);
+
+/** sum the quantized table entries selected by the codes of nblocks blocks,
+ * out[32 * b + j] is the distance of vector j of block b */
+typedef void (*pq4_accumulate_func_ptr)(
+        const uint8_t* packed, size_t nblocks, size_t M, const uint8_t* lut_q, uint16_t* out);
+
+void pq4_accumulate_ref(const uint8_t* packed, size_t nblocks, size_t M, const uint8_t* lut_q, uint16_t* out);
+
+/// set by hook_init to the best kernel of the cpu
+extern pq4_accumulate_func_ptr pq4_accumulate;
+
+} // namespace faiss
@@ -0,0 +1,57 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <faiss/impl/PQ4FastScan_avx.h>
+
+#include <immintrin.h>
+
+#include <faiss/impl/PQ4FastScan.h>
+
+namespace faiss {
+
+void pq4_accumulate_avx(const uint8_t* packed, size_t nblocks, size_t M, const uint8_t* lut_q, uint16_t* out) {
+    size_t M2 = pq4_padded_M(M);
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (size_t b = 0; b < nblocks; b++) {
+        const uint8_t* block = packed + b * M2 * 16;
+        // lane 0 accumulates even sub-quantizers, lane 1 odd ones
+        __m256i acc0 = zero; // vectors 0..7
+        __m256i acc1 = zero; // vectors 8..15
+        __m256i acc2 = zero; // vectors 16..23
+        __m256i acc3 = zero; // vectors 24..31
+
+        for (size_t m = 0; m < M2; m += 2) {
+            __m256i codes = _mm256_loadu_si256((const __m256i*)(block + m * 16));
+            __m256i lut = _mm256_loadu_si256((const __m256i*)(lut_q + m * 16));
+
+            __m256i lo = _mm256_and_si256(codes, mask);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(codes, 4), mask);
+            __m256i dis_lo = _mm256_shuffle_epi8(lut, lo);
+            __m256i dis_hi = _mm256_shuffle_epi8(lut, hi);
+
+            acc0 = _mm256_add_epi16(acc0, _mm256_unpacklo_epi8(dis_lo, zero));
+            acc1 = _mm256_add_epi16(acc1, _mm256_unpackhi_epi8(dis_lo, zero));
+            acc2 = _mm256_add_epi16(acc2, _mm256_unpacklo_epi8(dis_hi, zero));
+            acc3 = _mm256_add_epi16(acc3, _mm256_unpackhi_epi8(dis_hi, zero));
+        }
+
+        // fold the two lanes
+        __m128i* dis = (__m128i*)(out + b * pq4_block_size);
+        _mm_storeu_si128(dis + 0, _mm_add_epi16(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1)));
+        _mm_storeu_si128(dis + 1, _mm_add_epi16(_mm256_castsi256_si128(acc1), _mm256_extracti128_si256(acc1, 1)));
+        _mm_storeu_si128(dis + 2, _mm_add_epi16(_mm256_castsi256_si128(acc2), _mm256_extracti128_si256(acc2, 1)));
+        _mm_storeu_si128(dis + 3, _mm_add_epi16(_mm256_castsi256_si128(acc3), _mm256_extracti128_si256(acc3, 1)));
+    }
+}
+
+} // namespace faiss
@@ -234,7 +234,8 @@ RHNSW::search_base_layer(DistanceComputer& ptdis,
                          storage_idx_t nearest,
                          storage_idx_t ef,
                          float d_nearest,
-                         const BitsetView bitset) const {
+                         const BitsetView bitset,
+                         bool two_hop) const {
   VisitedList *vl = visited_list_pool->getFreeVisitedList();
   vl_type *visited_array = vl->mass;
   vl_type visited_array_tag = vl->curV;
@@ -265,6 +266,26 @@ RHNSW::search_base_layer(DistanceComputer& ptdis,
       int candidate_id = cur_link[i];
       if (visited_array[candidate_id] != visited_array_tag) {
         visited_array[candidate_id] = visited_array_tag;
+        if (two_hop && !bitset.empty() && bitset.test((int64_t)candidate_id)) {
+          // filtered out: not measured, its neighbors are
+          int *hop_link = get_neighbor_link(candidate_id, 0);
+          auto hop_neighbor_num = get_neighbors_num(hop_link);
+          for (auto h = 1; h <= hop_neighbor_num; ++ h) {
+            int hop_id = hop_link[h];
+            if (visited_array[hop_id] == visited_array_tag || bitset.test((int64_t)hop_id))
+              continue;
+            visited_array[hop_id] = visited_array_tag;
+            float dhop = ptdis(hop_id);
+            if (top_candidates.size() < ef || lb > dhop) {
+              candidate_set.emplace(-dhop, hop_id);
+              top_candidates.emplace(dhop, hop_id);
+              if (top_candidates.size() > ef)
+                top_candidates.pop();
+              lb = top_candidates.top().first;
+            }
+          }
+          continue;
+        }
         float dcand = ptdis(candidate_id);
         if (top_candidates.size() < ef || lb > dcand) {
           candidate_set.emplace(-dcand, candidate_id);
@@ -379,9 +400,33 @@ void RHNSW::prune_neighbors(DistanceComputer& ptdis,
 
 void RHNSW::searchKnn(DistanceComputer& qdis, int k,
             idx_t *I, float *D, RHNSWStatInfo &rsi,
-            const BitsetView bitset) const {
+            const BitsetView bitset, FilterMode filter_mode) const {
   if (levels.size() == 0)
     return;
+  if (filter_mode == FILTER_BRUTE_FORCE) {
+    std::priority_queue<Node, std::vector<Node>, CompareByFirst> top_candidates;
+    for (storage_idx_t id = 0; id < (storage_idx_t)levels.size(); ++ id) {
+      if (!bitset.empty() && bitset.test((int64_t)id))
+        continue;
+      float d = qdis(id);
+      if (top_candidates.size() < k || d < top_candidates.top().first) {
+        top_candidates.emplace(d, id);
+        if (top_candidates.size() > k)
+          top_candidates.pop();
+      }
+    }
+    int rst_num = top_candidates.size();
+    for (int i = rst_num - 1; i >= 0; -- i) {
+      I[i] = top_candidates.top().second;
+      D[i] = top_candidates.top().first;
+      top_candidates.pop();
+    }
+    for (; rst_num < k; rst_num++) {
+      I[rst_num] = -1;
+      D[rst_num] = 1.0/0.0;
+    }
+    return;
+  }
   int ep = entry_point;
   float dist = qdis(ep);
 
@@ -407,7 +452,8 @@ void RHNSW::searchKnn(DistanceComputer& qdis, int k,
       }
     }
   }
-  std::priority_queue<Node, std::vector<Node>, CompareByFirst> top_candidates = search_base_layer(qdis, ep, std::max(efSearch, k), dist, bitset);
+  std::priority_queue<Node, std::vector<Node>, CompareByFirst> top_candidates = search_base_layer(qdis, ep, std::max(efSearch, k), dist, bitset,
+                                                                                           filter_mode == FILTER_TWO_HOP);
   while (top_candidates.size() > k)
     top_candidates.pop();
   int rst_num = top_candidates.size();
@@ -188,6 +188,13 @@ struct RHNSW {
   /// expansion factor at search time
   int efSearch;
 
+  /// search of the base layer around the nodes filtered out by the bitset, chosen per query
+  enum FilterMode {
+    FILTER_WALK,         ///< through them, as through any node
+    FILTER_TWO_HOP,      ///< without their distances, on to their neighbors
+    FILTER_BRUTE_FORCE,  ///< no walk, the distances to all the nodes left
+  };
+
   /// range of entries in the neighbors table of vertex no at layer_no
   storage_idx_t* get_neighbor_link(idx_t no, int layer_no) const {
       return layer_no == 0 ? (int*)(level0_links + no * level0_link_size) : (int*)(linkLists[no] + (layer_no - 1) * link_size);
@@ -230,7 +237,8 @@ struct RHNSW {
                      storage_idx_t nearest,
                      storage_idx_t ef,
                      float d_nearest,
-                     const BitsetView bitset = nullptr) const;
+                     const BitsetView bitset = nullptr,
+                     bool two_hop = false) const;
 
   int make_connection(DistanceComputer& ptdis,
                       storage_idx_t pt_id,
@@ -244,7 +252,8 @@ struct RHNSW {
   /// search interface inspired by hnswlib
   void searchKnn(DistanceComputer& qdis, int k,
                  idx_t *I, float *D, RHNSWStatInfo &rsi,
-                 const BitsetView bitset = nullptr) const;
+                 const BitsetView bitset = nullptr,
+                 FilterMode filter_mode = FILTER_WALK) const;
 
   size_t cal_size();
 
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <cstdio>
+#include <cstring>
 #include <algorithm>
 #include <omp.h>
 #include <immintrin.h>
@@ -66,15 +67,24 @@ struct Codec4bit_avx : public Codec4bit {
 
 struct Codec6bit_avx : public Codec6bit {
     static __m256 decode_8_components (const uint8_t *code, int i) {
-        return _mm256_set_ps
-            (decode_component(code, i + 7),
-             decode_component(code, i + 6),
-             decode_component(code, i + 5),
-             decode_component(code, i + 4),
-             decode_component(code, i + 3),
-             decode_component(code, i + 2),
-             decode_component(code, i + 1),
-             decode_component(code, i + 0));
+        // 8 components are 6 bytes, the two 32-bit loads stay inside them
+        code += (i >> 2) * 3;
+        uint32_t c4lo, c4hi;
+        memcpy (&c4lo, code, 4);
+        memcpy (&c4hi, code + 2, 4);
+        c4hi >>= 8;
+
+        // lanes 0..3 and 4..7 extract 6 bits each from the two 24-bit groups
+        __m256i c8 = _mm256_setr_epi32 (c4lo, c4lo, c4lo, c4lo,
+                                        c4hi, c4hi, c4hi, c4hi);
+        __m256i shifts = _mm256_setr_epi32 (0, 6, 12, 18, 0, 6, 12, 18);
+        __m256i i8 = _mm256_and_si256 (_mm256_srlv_epi32 (c8, shifts),
+                                       _mm256_set1_epi32 (0x3f));
+        __m256 f8 = _mm256_cvtepi32_ps (i8);
+        __m256 half = _mm256_set1_ps (0.5f);
+        f8 += half;
+        __m256 one_63 = _mm256_set1_ps (1.f / 63.f);
+        return f8 * one_63;
     }
 };
 
@@ -147,6 +157,33 @@ struct QuantizerFP16_avx<8>: public QuantizerFP16<1> {
 };
 
 
+/*******************************************************************
+ * BF16 quantizer
+ *******************************************************************/
+
+template<int SIMDWIDTH>
+struct QuantizerBF16_avx {};
+
+template<>
+struct QuantizerBF16_avx<1> : public QuantizerBF16<1> {
+    QuantizerBF16_avx (size_t d, const std::vector<float> &unused) :
+        QuantizerBF16<1> (d, unused) {}
+};
+
+template<>
+struct QuantizerBF16_avx<8>: public QuantizerBF16<1> {
+    QuantizerBF16_avx (size_t d, const std::vector<float> &trained):
+        QuantizerBF16<1> (d, trained) {}
+
+    __m256 reconstruct_8_components (const uint8_t * code, int i) const {
+        // a bf16 is the upper half of the float32
+        __m128i codei = _mm_loadu_si128 ((const __m128i*)(code + 2 * i));
+        __m256i x8 = _mm256_slli_epi32 (_mm256_cvtepu16_epi32 (codei), 16);
+        return _mm256_castsi256_ps (x8);
+    }
+};
+
+
 /*******************************************************************
  * 8bit_direct quantizer
  *******************************************************************/
@@ -188,6 +225,8 @@ Quantizer *select_quantizer_1_avx (QuantizerType qtype, size_t d,
             return new QuantizerTemplate_avx<Codec4bit_avx, true, SIMDWIDTH>(d, trained);
         case QuantizerType::QT_fp16:
             return new QuantizerFP16_avx<SIMDWIDTH>(d, trained);
+        case QuantizerType::QT_bf16:
+            return new QuantizerBF16_avx<SIMDWIDTH>(d, trained);
         case QuantizerType::QT_8bit_direct:
             return new Quantizer8bitDirect_avx<SIMDWIDTH>(d, trained);
     }
@@ -480,6 +519,10 @@ SQDistanceComputer *select_distance_computer_avx (
             return new DCTemplate_avx
                     <QuantizerFP16_avx<SIMDWIDTH>, Sim, SIMDWIDTH>(d, trained);
 
+        case QuantizerType::QT_bf16:
+            return new DCTemplate_avx
+                    <QuantizerBF16_avx<SIMDWIDTH>, Sim, SIMDWIDTH>(d, trained);
+
         case QuantizerType::QT_8bit_direct:
             if (d % 16 == 0) {
                 return new DistanceComputerByte_avx<Sim, SIMDWIDTH>(d, trained);
@@ -538,6 +581,10 @@ InvertedListScanner* sel1_InvertedListScanner_avx (
         return sel2_InvertedListScanner_avx
             <DCTemplate_avx<QuantizerFP16_avx<SIMDWIDTH>, Similarity, SIMDWIDTH> >
             (sq, quantizer, store_pairs, r);
+    case QuantizerType::QT_bf16:
+        return sel2_InvertedListScanner_avx
+            <DCTemplate_avx<QuantizerBF16_avx<SIMDWIDTH>, Similarity, SIMDWIDTH> >
+            (sq, quantizer, store_pairs, r);
     case QuantizerType::QT_8bit_direct:
         if (sq->d % 16 == 0) {
             return sel2_InvertedListScanner_avx
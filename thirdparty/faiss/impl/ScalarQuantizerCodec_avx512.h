@@ -70,7 +70,7 @@ struct Codec4bit_avx512 : public Codec4bit_avx {
         __m128i c16 = _mm_unpacklo_epi8 (_mm_set1_epi64x(c8ev),
                                          _mm_set1_epi64x(c8od));
         __m256i c8lo = _mm256_cvtepu8_epi32 (c16);
-        __m256i c8hi = _mm256_cvtepu8_epi32 (_mm_srli_si128(c16, 4));
+        __m256i c8hi = _mm256_cvtepu8_epi32 (_mm_srli_si128(c16, 8));
         __m512i i16 = _mm512_castsi256_si512 (c8lo);
         i16 = _mm512_inserti32x8 (i16, c8hi, 1);
         __m512 f16 = _mm512_cvtepi32_ps (i16);
@@ -83,23 +83,9 @@ struct Codec4bit_avx512 : public Codec4bit_avx {
 
 struct Codec6bit_avx512 : public Codec6bit_avx {
     static __m512 decode_16_components (const uint8_t *code, int i) {
-        return _mm512_set_ps
-            (decode_component(code, i + 15),
-             decode_component(code, i + 14),
-             decode_component(code, i + 13),
-             decode_component(code, i + 12),
-             decode_component(code, i + 11),
-             decode_component(code, i + 10),
-             decode_component(code, i + 9),
-             decode_component(code, i + 8),
-             decode_component(code, i + 7),
-             decode_component(code, i + 6),
-             decode_component(code, i + 5),
-             decode_component(code, i + 4),
-             decode_component(code, i + 3),
-             decode_component(code, i + 2),
-             decode_component(code, i + 1),
-             decode_component(code, i + 0));
+        __m256 f8lo = decode_8_components (code, i);
+        __m256 f8hi = decode_8_components (code, i + 8);
+        return _mm512_insertf32x8 (_mm512_castps256_ps512 (f8lo), f8hi, 1);
     }
 };
 
@@ -189,6 +175,37 @@ struct QuantizerFP16_avx512<16>: public QuantizerFP16_avx<8> {
     }
 };
 
+/*******************************************************************
+ * BF16 quantizer
+ *******************************************************************/
+
+template<int SIMDWIDTH>
+struct QuantizerBF16_avx512 {};
+
+template<>
+struct QuantizerBF16_avx512<1> : public QuantizerBF16_avx<1> {
+    QuantizerBF16_avx512(size_t d, const std::vector<float> &unused) :
+        QuantizerBF16_avx<1> (d, unused) {}
+};
+
+template<>
+struct QuantizerBF16_avx512<8> : public QuantizerBF16_avx<8> {
+    QuantizerBF16_avx512 (size_t d, const std::vector<float> &trained) :
+        QuantizerBF16_avx<8> (d, trained) {}
+};
+
+template<>
+struct QuantizerBF16_avx512<16>: public QuantizerBF16_avx<8> {
+    QuantizerBF16_avx512 (size_t d, const std::vector<float> &trained):
+        QuantizerBF16_avx<8> (d, trained) {}
+
+    __m512 reconstruct_16_components (const uint8_t * code, int i) const {
+        __m256i codei = _mm256_loadu_si256 ((const __m256i*)(code + 2 * i));
+        __m512i x16 = _mm512_slli_epi32 (_mm512_cvtepu16_epi32 (codei), 16);
+        return _mm512_castsi512_ps (x16);
+    }
+};
+
 /*******************************************************************
  * 8bit_direct quantizer
  *******************************************************************/
@@ -238,6 +255,8 @@ Quantizer *select_quantizer_1_avx512 (QuantizerType qtype, size_t d,
             return new QuantizerTemplate_avx512<Codec4bit_avx512, true, SIMDWIDTH>(d, trained);
         case QuantizerType::QT_fp16:
             return new QuantizerFP16_avx512<SIMDWIDTH>(d, trained);
+        case QuantizerType::QT_bf16:
+            return new QuantizerBF16_avx512<SIMDWIDTH>(d, trained);
         case QuantizerType::QT_8bit_direct:
             return new Quantizer8bitDirect_avx512<SIMDWIDTH>(d, trained);
     }
@@ -564,6 +583,10 @@ SQDistanceComputer *select_distance_computer_avx512 (
             return new DCTemplate_avx512
                     <QuantizerFP16_avx512<SIMDWIDTH>, Sim, SIMDWIDTH>(d, trained);
 
+        case QuantizerType::QT_bf16:
+            return new DCTemplate_avx512
+                    <QuantizerBF16_avx512<SIMDWIDTH>, Sim, SIMDWIDTH>(d, trained);
+
         case QuantizerType::QT_8bit_direct:
             if (d % 16 == 0) {
                 return new DistanceComputerByte_avx512<Sim, SIMDWIDTH>(d, trained);
@@ -623,6 +646,10 @@ InvertedListScanner* sel1_InvertedListScanner_avx512 (
         return sel2_InvertedListScanner_avx512
             <DCTemplate_avx512<QuantizerFP16_avx512<SIMDWIDTH>, Similarity, SIMDWIDTH> >
             (sq, quantizer, store_pairs, r);
+    case QuantizerType::QT_bf16:
+        return sel2_InvertedListScanner_avx512
+            <DCTemplate_avx512<QuantizerBF16_avx512<SIMDWIDTH>, Similarity, SIMDWIDTH> >
+            (sq, quantizer, store_pairs, r);
     case QuantizerType::QT_8bit_direct:
         if (sq->d % 16 == 0) {
             return sel2_InvertedListScanner_avx512
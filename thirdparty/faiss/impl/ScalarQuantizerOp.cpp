@@ -8,6 +8,7 @@
 // -*- c++ -*-
 
 #include <cstdio>
+#include <cstring>
 #include <algorithm>
 
 #include <omp.h>
@@ -138,6 +139,26 @@ float decode_fp16 (uint16_t h) {
 #endif
 
 
+uint16_t encode_bf16 (float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        // keep NaN a NaN, rounding could carry it into infinity
+        return (bits >> 16) | 0x40;
+    }
+    // round to nearest even on the 16 dropped bits
+    bits += 0x7fffu + ((bits >> 16) & 1);
+    return bits >> 16;
+}
+
+float decode_bf16 (uint16_t x) {
+    uint32_t bits = (uint32_t)x << 16;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+
 /*******************************************************************
  * Quantizer range training
  */
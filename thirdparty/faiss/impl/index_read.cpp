@@ -246,6 +246,26 @@ InvertedLists *read_InvertedLists (IOReader *f, int io_flags) {
             }
         }
         return ails;
+    } else if (h == fourcc ("ilar") && (io_flags & IO_FLAG_MMAP) &&
+               !dynamic_cast<FileIOReader*>(f)) {
+        // the reader holds the whole buffer (eg. a mapped file): reference
+        // codes and ids in place instead of copying them
+        size_t nlist, code_size;
+        READ1 (nlist);
+        READ1 (code_size);
+        auto vils = new ViewInvertedLists (nlist, code_size);
+        read_ArrayInvertedLists_sizes (f, vils->sizes);
+        for (size_t i = 0; i < nlist; i++) {
+            size_t n = vils->sizes[i];
+            if (n > 0) {
+                vils->codes[i] = f->read_in_place (n * code_size);
+                vils->ids[i] = (const InvertedLists::idx_t*)
+                    f->read_in_place (n * sizeof(InvertedLists::idx_t));
+                FAISS_THROW_IF_NOT_MSG (vils->codes[i] && vils->ids[i],
+                    "reader does not support in place reading");
+            }
+        }
+        return vils;
     } else if (h == fourcc ("ilar") && (io_flags & IO_FLAG_MMAP)) {
         // then we load it as an OnDiskInvertedLists
 
@@ -359,6 +379,8 @@ InvertedLists *read_InvertedLists_nm (IOReader *f, int io_flags) {
         READ1 (ails->nlist);
         READ1 (ails->code_size);
         ails->ids.resize (ails->nlist);
+        // no codes, but one (empty) entry per list like any ArrayInvertedLists
+        ails->codes.resize (ails->nlist);
         std::vector<size_t> sizes (ails->nlist);
         read_ArrayInvertedLists_sizes (f, sizes);
         for (size_t i = 0; i < ails->nlist; i++) {
@@ -241,6 +241,23 @@ void write_InvertedLists (const InvertedLists *ils, IOWriter *f) {
                 WRITEANDCHECK (ails->ids[i].data(), n);
             }
         }
+    } else if (const auto & vils =
+               dynamic_cast<const ViewInvertedLists *>(ils)) {
+        // same layout as an ArrayInvertedLists so it can be read back either way
+        uint32_t h = fourcc ("ilar");
+        WRITE1 (h);
+        WRITE1 (vils->nlist);
+        WRITE1 (vils->code_size);
+        uint32_t list_type = fourcc("full");
+        WRITE1 (list_type);
+        WRITEVECTOR (vils->sizes);
+        for (size_t i = 0; i < vils->nlist; i++) {
+            size_t n = vils->sizes[i];
+            if (n > 0) {
+                WRITEANDCHECK (vils->codes[i], n * vils->code_size);
+                WRITEANDCHECK (vils->ids[i], n);
+            }
+        }
     } else if (const auto & oa =
             dynamic_cast<const ReadOnlyArrayInvertedLists *>(ils)) {
         uint32_t h = fourcc("iloa");
@@ -36,6 +36,10 @@ struct IOReader {
     // return a file number that can be memory-mapped
     virtual int fileno ();
 
+    // return a pointer to the next nbytes of the underlying buffer and
+    // skip them, or nullptr if the data can't be referenced in place
+    virtual const uint8_t * read_in_place (size_t nbytes);
+
     virtual ~IOReader() {}
 };
 
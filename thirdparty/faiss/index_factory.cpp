@@ -192,12 +192,13 @@ Index *index_factory (int d, const char *description_in, MetricType metric)
                 index_1 = new IndexFlat (d, metric);
             }
         } else if (!index && (stok == "SQ8" || stok == "SQ4" || stok == "SQ6" ||
-                              stok == "SQfp16")) {
+                              stok == "SQfp16" || stok == "SQbf16")) {
             QuantizerType qt =
                 stok == "SQ8" ? QuantizerType::QT_8bit :
                 stok == "SQ6" ? QuantizerType::QT_6bit :
                 stok == "SQ4" ? QuantizerType::QT_4bit :
                 stok == "SQfp16" ? QuantizerType::QT_fp16 :
+                stok == "SQbf16" ? QuantizerType::QT_bf16 :
                 QuantizerType::QT_4bit;
             if (coarse_quantizer) {
                 FAISS_THROW_IF_NOT (!use_2layer);
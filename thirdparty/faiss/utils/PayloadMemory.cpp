@@ -0,0 +1,309 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <faiss/utils/PayloadMemory.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace faiss {
+
+namespace {
+
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+constexpr size_t kMaxSampledPages = 256;
+
+struct MappedRegion {
+    void* base;       // start of the mapping, may precede the returned pointer
+    size_t length;    // length of the mapping
+    bool hugetlb;
+};
+
+std::mutex regions_mutex;
+std::unordered_map<void*, MappedRegion> regions;
+
+std::mutex policy_mutex;
+PayloadMemoryPolicy global_policy;
+
+constexpr int kNoNumaOverride = -2;
+thread_local int numa_override = kNoNumaOverride;
+
+/// the policy for the calling thread, taken once per call
+PayloadMemoryPolicy current_policy() {
+    PayloadMemoryPolicy policy = get_payload_memory_policy();
+    if (numa_override != kNoNumaOverride) {
+        policy.numa_node = numa_override;
+    }
+    return policy;
+}
+
+bool policy_active(const PayloadMemoryPolicy& policy) {
+    return policy.huge_pages != HugePageMode::NONE || policy.numa_node >= 0;
+}
+
+#ifdef __linux__
+
+constexpr int kMpolBind = 2;
+constexpr size_t kNodeMaskWords = 16;
+
+size_t page_size() {
+    static size_t size = sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+bool bind_to_node(void* ptr, size_t nbytes, int node) {
+    if (node < 0 || node >= (int)(kNodeMaskWords * 64)) {
+        return false;
+    }
+    unsigned long mask[kNodeMaskWords] = {0};
+    mask[node / 64] = 1UL << (node % 64);
+    return syscall(SYS_mbind, ptr, nbytes, kMpolBind, mask, kNodeMaskWords * 64, 0) == 0;
+}
+
+/// sum of AnonHugePages of the mappings overlapping the ranges, capped by the overlap with each mapping
+size_t transparent_huge_bytes(const std::vector<PayloadRange>& ranges) {
+    std::ifstream smaps("/proc/self/smaps");
+    if (!smaps.is_open()) {
+        return 0;
+    }
+    size_t total = 0, overlap = 0;
+    std::string line;
+    while (std::getline(smaps, line)) {
+        uintptr_t vma_lo, vma_hi;
+        char dash;
+        std::istringstream head(line);
+        if ((head >> std::hex >> vma_lo >> dash >> vma_hi) && dash == '-') {
+            overlap = 0;
+            for (auto& range : ranges) {
+                uintptr_t lo = (uintptr_t)range.first, hi = lo + range.second;
+                if (vma_hi > lo && vma_lo < hi) {
+                    overlap += std::min(vma_hi, hi) - std::max(vma_lo, lo);
+                }
+            }
+        } else if (overlap > 0 && line.compare(0, 14, "AnonHugePages:") == 0) {
+            size_t kb = strtoull(line.c_str() + 14, nullptr, 10);
+            total += std::min(kb * 1024, overlap);
+        }
+    }
+    return total;
+}
+
+void* map_payload(size_t nbytes, const PayloadMemoryPolicy& policy) {
+    void* ptr = MAP_FAILED;
+    MappedRegion region{nullptr, 0, false};
+
+    if (policy.huge_pages == HugePageMode::EXPLICIT) {
+        size_t length = (nbytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            region = MappedRegion{ptr, length, true};
+        }
+    }
+    if (ptr == MAP_FAILED) {
+        // over-map by one huge page so the payload starts 2MB aligned and THP can back all of it
+        size_t length = ((nbytes + page_size() - 1) & ~(page_size() - 1)) + kHugePageSize;
+        void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            return nullptr;
+        }
+        ptr = (void*)(((uintptr_t)base + kHugePageSize - 1) & ~(uintptr_t)(kHugePageSize - 1));
+        region = MappedRegion{base, length, false};
+        if (policy.huge_pages != HugePageMode::NONE) {
+            madvise(ptr, nbytes, MADV_HUGEPAGE);
+        }
+    }
+    if (policy.numa_node >= 0) {
+        // nothing is faulted in yet, so binding places every page on first touch
+        bind_to_node(region.base, region.length, policy.numa_node);
+    }
+
+    std::lock_guard<std::mutex> lock(regions_mutex);
+    regions[ptr] = region;
+    return ptr;
+}
+
+#endif
+
+} // namespace
+
+void PayloadPlacement::merge(const PayloadPlacement& other) {
+    bytes += other.bytes;
+    huge_page_bytes += other.huge_page_bytes;
+    for (auto& it : other.node_pages) {
+        node_pages[it.first] += it.second;
+    }
+}
+
+std::string PayloadPlacement::to_string() const {
+    std::stringstream ss;
+    ss << "bytes: " << bytes << ", huge_page_bytes: " << huge_page_bytes << ", node_pages: {";
+    bool first = true;
+    for (auto& it : node_pages) {
+        ss << (first ? "" : ", ") << it.first << ": " << it.second;
+        first = false;
+    }
+    ss << "}";
+    return ss.str();
+}
+
+void set_payload_memory_policy(const PayloadMemoryPolicy& policy) {
+    std::lock_guard<std::mutex> lock(policy_mutex);
+    global_policy = policy;
+}
+
+PayloadMemoryPolicy get_payload_memory_policy() {
+    std::lock_guard<std::mutex> lock(policy_mutex);
+    return global_policy;
+}
+
+PayloadNumaScope::PayloadNumaScope(int numa_node) : previous_(numa_override) {
+    numa_override = numa_node;
+}
+
+PayloadNumaScope::~PayloadNumaScope() {
+    numa_override = previous_;
+}
+
+void* payload_alloc(size_t nbytes) {
+#ifdef __linux__
+    auto policy = current_policy();
+    if (policy_active(policy) && nbytes >= policy.min_bytes) {
+        void* ptr = map_payload(nbytes, policy);
+        if (ptr != nullptr) {
+            return ptr;
+        }
+    }
+#endif
+    return malloc(nbytes);
+}
+
+void payload_free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+#ifdef __linux__
+    {
+        std::lock_guard<std::mutex> lock(regions_mutex);
+        auto it = regions.find(ptr);
+        if (it != regions.end()) {
+            munmap(it->second.base, it->second.length);
+            regions.erase(it);
+            return;
+        }
+    }
+#endif
+    free(ptr);
+}
+
+void* payload_realloc(void* ptr, size_t old_nbytes, size_t new_nbytes) {
+    bool mapped = false;
+    {
+        std::lock_guard<std::mutex> lock(regions_mutex);
+        mapped = regions.count(ptr) > 0;
+    }
+    auto policy = current_policy();
+    if (!mapped && !(policy_active(policy) && new_nbytes >= policy.min_bytes)) {
+        return realloc(ptr, new_nbytes);
+    }
+    void* new_ptr = payload_alloc(new_nbytes);
+    if (new_ptr == nullptr) {
+        return nullptr;
+    }
+    if (ptr != nullptr) {
+        memcpy(new_ptr, ptr, std::min(old_nbytes, new_nbytes));
+        payload_free(ptr);
+    }
+    return new_ptr;
+}
+
+void* payload_copy(const void* ptr, size_t nbytes) {
+#ifdef __linux__
+    auto policy = current_policy();
+    if (ptr == nullptr || !policy_active(policy) || nbytes < policy.min_bytes) {
+        return nullptr;
+    }
+    void* copy = map_payload(nbytes, policy);
+    if (copy != nullptr) {
+        memcpy(copy, ptr, nbytes);
+    }
+    return copy;
+#else
+    return nullptr;
+#endif
+}
+
+PayloadPlacement payload_query(const void* ptr, size_t nbytes) {
+    return payload_query(std::vector<PayloadRange>{PayloadRange(ptr, nbytes)});
+}
+
+PayloadPlacement payload_query(const std::vector<PayloadRange>& ranges) {
+    PayloadPlacement placement;
+    for (auto& range : ranges) {
+        placement.bytes += range.second;
+    }
+#ifdef __linux__
+    if (placement.bytes == 0) {
+        return placement;
+    }
+    std::vector<PayloadRange> thp_ranges;
+    {
+        std::lock_guard<std::mutex> lock(regions_mutex);
+        for (auto& range : ranges) {
+            auto it = regions.find(const_cast<void*>(range.first));
+            if (it != regions.end() && it->second.hugetlb) {
+                placement.huge_page_bytes += range.second;
+            } else if (range.second > 0) {
+                thp_ranges.push_back(range);
+            }
+        }
+    }
+    if (!thp_ranges.empty()) {
+        placement.huge_page_bytes += transparent_huge_bytes(thp_ranges);
+    }
+
+    // sample pages evenly over the ranges, at least one per non-empty range
+    std::vector<void*> pages;
+    for (auto& range : ranges) {
+        if (range.second == 0) {
+            continue;
+        }
+        uintptr_t first = (uintptr_t)range.first & ~(uintptr_t)(page_size() - 1);
+        size_t npages = ((uintptr_t)range.first + range.second - first + page_size() - 1) / page_size();
+        size_t nsample = std::max((size_t)1, std::min(npages, kMaxSampledPages * range.second / placement.bytes));
+        for (size_t i = 0; i < nsample; i++) {
+            pages.push_back((void*)(first + (npages * i / nsample) * page_size()));
+        }
+    }
+    std::vector<int> status(pages.size(), -1);
+    if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+        std::fill(status.begin(), status.end(), -1);
+    }
+    for (auto node : status) {
+        placement.node_pages[node >= 0 ? node : -1]++;
+    }
+#endif
+    return placement;
+}
+
+} // namespace faiss
@@ -0,0 +1,131 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <stddef.h>
+#include <map>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Placement of the large index payloads (vector data, codes, graphs):
+ * huge pages and NUMA binding, best effort and Linux only. The policy is only
+ * applied to the page-aligned mappings of payload_alloc (directly or through a
+ * PayloadVector); storage allocated elsewhere (std::vector, malloc) may share
+ * its pages with other objects and keeps the default policy, it is placed by
+ * first touch. */
+
+namespace faiss {
+
+enum class HugePageMode {
+    NONE = 0,     // plain pages
+    TRANSPARENT,  // madvise(MADV_HUGEPAGE), the kernel promotes when it can
+    EXPLICIT,     // mmap(MAP_HUGETLB) from the reserved pool, THP as fallback
+};
+
+struct PayloadMemoryPolicy {
+    HugePageMode huge_pages = HugePageMode::NONE;
+    int numa_node = -1;                 // bind to this node, -1: no binding
+    size_t min_bytes = 2 * 1024 * 1024; // smaller payloads are left to malloc
+};
+
+/// process-wide policy, set through KnowhereConfig::SetPayloadMemory; every payload call works on a
+/// snapshot taken when it starts, so the policy may change while other threads allocate
+void set_payload_memory_policy(const PayloadMemoryPolicy& policy);
+
+PayloadMemoryPolicy get_payload_memory_policy();
+
+/// binds the payloads that the calling thread allocates to numa_node while the scope lives, instead of
+/// the node of the process-wide policy; per-node loaders use it to leave the global policy alone
+class PayloadNumaScope {
+  public:
+    explicit PayloadNumaScope(int numa_node);
+    ~PayloadNumaScope();
+
+    PayloadNumaScope(const PayloadNumaScope&) = delete;
+    PayloadNumaScope& operator=(const PayloadNumaScope&) = delete;
+
+  private:
+    int previous_;
+};
+
+/// where a payload actually lives
+struct PayloadPlacement {
+    size_t bytes = 0;
+    size_t huge_page_bytes = 0;          // backed by explicit or transparent huge pages
+    std::map<int, size_t> node_pages;    // sampled resident pages per NUMA node, -1: not resident/unknown
+
+    void merge(const PayloadPlacement& other);
+
+    std::string to_string() const;
+};
+
+/// allocate nbytes following the policy, release with payload_free
+void* payload_alloc(size_t nbytes);
+
+void payload_free(void* ptr);
+
+/// realloc counterpart of payload_alloc, the content up to min(old, new) size is kept
+void* payload_realloc(void* ptr, size_t old_nbytes, size_t new_nbytes);
+
+/// copy of [ptr, ptr + nbytes) into memory from payload_alloc, release with payload_free; nullptr
+/// when the policy leaves buffers of this size to malloc, the caller then keeps its own buffer
+void* payload_copy(const void* ptr, size_t nbytes);
+
+/// std allocator over payload_alloc, for the payloads kept in a growing vector (IndexFlat vectors, IVF codes);
+/// each reallocation of the vector follows the policy current at that time
+template <typename T>
+struct PayloadAllocator {
+    using value_type = T;
+
+    PayloadAllocator() = default;
+
+    template <typename U>
+    PayloadAllocator(const PayloadAllocator<U>&) {
+    }
+
+    T* allocate(size_t n) {
+        void* ptr = payload_alloc(n * sizeof(T));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t) {
+        payload_free(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const PayloadAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PayloadAllocator<U>&) const {
+        return false;
+    }
+};
+
+template <typename T>
+using PayloadVector = std::vector<T, PayloadAllocator<T>>;
+
+using PayloadRange = std::pair<const void*, size_t>;
+
+/// inspect how [ptr, ptr + nbytes) is currently backed
+PayloadPlacement payload_query(const void* ptr, size_t nbytes);
+
+/// same for a payload spread over several buffers (inverted lists)
+PayloadPlacement payload_query(const std::vector<PayloadRange>& ranges);
+
+} // namespace faiss
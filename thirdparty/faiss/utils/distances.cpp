@@ -8,6 +8,7 @@
 // -*- c++ -*-
 
 #include <cstdio>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <cmath>
@@ -22,6 +23,13 @@
 #define FINTEGER long
 #endif
 
+namespace {
+
+// database vectors whose distances to a query are computed in one call
+const size_t knn_block_size = 64;
+
+} // namespace
+
 
 extern "C" {
 
@@ -228,14 +236,27 @@ static void knn_inner_product_sse (const float * x,
                 ids_[j] = -1;
             }
 
-            for (size_t j = 0; j < ny; j++) {
-                if (!bitset || !bitset.test(j)) {
-                    float disij = fvec_inner_product (x_i, y_j, d);
-                    if (disij > val_[0]) {
-                        minheap_swap_top (k, val_, ids_, disij, j);
+            if (!bitset) {
+                float dis[knn_block_size];
+                for (size_t j0 = 0; j0 < ny; j0 += knn_block_size) {
+                    size_t nblock = std::min(ny - j0, knn_block_size);
+                    fvec_inner_product_batch (dis, x_i, y + j0 * d, d, nblock);
+                    for (size_t j = j0; j < j0 + nblock; j++) {
+                        if (dis[j - j0] > val_[0]) {
+                            minheap_swap_top (k, val_, ids_, dis[j - j0], j);
+                        }
                     }
                 }
-                y_j += d;
+            } else {
+                for (size_t j = 0; j < ny; j++) {
+                    if (!bitset.test(j)) {
+                        float disij = fvec_inner_product (x_i, y_j, d);
+                        if (disij > val_[0]) {
+                            minheap_swap_top (k, val_, ids_, disij, j);
+                        }
+                    }
+                    y_j += d;
+                }
             }
 
             minheap_reorder (k, val_, ids_);
@@ -341,14 +362,27 @@ static void knn_L2sqr_sse (
                 ids_[j] = -1;
             }
 
-            for (size_t j = 0; j < ny; j++) {
-                if (!bitset || !bitset.test(j)) {
-                    float disij = fvec_L2sqr (x_i, y_j, d);
-                    if (disij < val_[0]) {
-                        maxheap_swap_top (k, val_, ids_, disij, j);
+            if (!bitset) {
+                float dis[knn_block_size];
+                for (size_t j0 = 0; j0 < ny; j0 += knn_block_size) {
+                    size_t nblock = std::min(ny - j0, knn_block_size);
+                    fvec_L2sqr_batch (dis, x_i, y + j0 * d, d, nblock);
+                    for (size_t j = j0; j < j0 + nblock; j++) {
+                        if (dis[j - j0] < val_[0]) {
+                            maxheap_swap_top (k, val_, ids_, dis[j - j0], j);
+                        }
+                    }
+                }
+            } else {
+                for (size_t j = 0; j < ny; j++) {
+                    if (!bitset.test(j)) {
+                        float disij = fvec_L2sqr (x_i, y_j, d);
+                        if (disij < val_[0]) {
+                            maxheap_swap_top (k, val_, ids_, disij, j);
+                        }
                     }
+                    y_j += d;
                 }
-                y_j += d;
             }
 
             maxheap_reorder (k, val_, ids_);
@@ -5,8 +5,12 @@
 #include <random>
 #include <stdlib.h>
 #include <unordered_set>
+#include <algorithm>
+#include <tuple>
 #include <list>
+#include <exception>
 
+#include "faiss/utils/PayloadMemory.h"
 #include "knowhere/index/vector_index/helpers/FaissIO.h"
 
 namespace hnswlib {
@@ -56,7 +60,7 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 //        label_offset_ = size_links_level0_ + data_size_;
         offsetLevel0_ = 0;
 
-        data_level0_memory_ = (char *) malloc(max_elements_ * size_data_per_element_);
+        data_level0_memory_ = (char *) faiss::payload_alloc(max_elements_ * size_data_per_element_);
         if (data_level0_memory_ == nullptr)
             throw std::runtime_error("Not enough memory");
 
@@ -89,7 +93,10 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 
     ~HierarchicalNSW() {
 
-        free(data_level0_memory_);
+        if (data_level0_owned_)
+            faiss::payload_free(data_level0_memory_);
+        if (raw_data_owned_)
+            faiss::payload_free(raw_data_);
         for (tableint i = 0; i < cur_element_count; i++) {
             if (element_levels_[i] > 0)
                 free(linkLists_[i]);
@@ -131,8 +138,12 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 
 
     char *data_level0_memory_;
+    // false when data_level0_memory_ references the loaded buffer in place, the index is read-only then
+    bool data_level0_owned_ = true;
     char **linkLists_;
     std::vector<int> element_levels_;
+    // label of each internal id after reorderLevel0(), empty while internal ids are the labels themselves
+    std::vector<labeltype> internal_labels_;
     std::vector<int> level_stats_;
     bool stats_enable = false;
 
@@ -142,20 +153,44 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
     DISTFUNC<dist_t> fstdistfunc_;
     void *dist_func_param_;
 
+    // after quantizeLevel0(), level0 holds codes and fstdistfunc_ compares a query to a code, the full
+    // vectors are kept in raw_data_ for the exact re-rank of the candidates. A graph-only index
+    // (LEVEL0_NONE) has links only in level0 and walks the vectors of raw_data_, see setRawData()
+    size_t level0_codec_ = LEVEL0_FLOAT;
+    char *raw_data_ = nullptr;
+    // false when raw_data_ references the loaded buffer in place
+    bool raw_data_owned_ = true;
+    size_t raw_size_ = 0;
+    DISTFUNC<dist_t> rawdistfunc_;
+    void *raw_dist_func_param_;
+    std::vector<float> code_trained_;  // SQ8: vmin, then step, of each dimension
+    CodeDistParam code_param_;
+
     std::default_random_engine level_generator_;
 
     inline char *getDataByInternalId(tableint internal_id) const {
+        if (level0_codec_ == LEVEL0_NONE)
+            return raw_data_ + internal_id * raw_size_;
         return (data_level0_memory_ + internal_id * size_data_per_element_ + offsetData_);
     }
 
+    inline char *getRawDataByInternalId(tableint internal_id) const {
+        return raw_data_ ? raw_data_ + internal_id * raw_size_ : getDataByInternalId(internal_id);
+    }
+
+    inline labeltype getExternalLabel(tableint internal_id) const {
+        return internal_labels_.empty() ? (labeltype)internal_id : internal_labels_[internal_id];
+    }
+
     int getRandomLevel(double reverse_size) {
         std::uniform_real_distribution<double> distribution(0.0, 1.0);
         double r = -log(distribution(level_generator_)) * reverse_size;
         return (int) r;
     }
 
+    // lock_lists: false when no link list can change during the search, as in the first phase of addPointsBatched
     std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst>
-    searchBaseLayer(tableint ep_id, const void *data_point, int layer) {
+    searchBaseLayer(tableint ep_id, const void *data_point, int layer, bool lock_lists = true) {
         VisitedList *vl = visited_list_pool_->getFreeVisitedList();
         vl_type *visited_array = vl->mass;
         vl_type visited_array_tag = vl->curV;
@@ -179,7 +214,10 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 
             tableint curNodeNum = curr_el_pair.second;
 
-            std::unique_lock <std::mutex> lock(link_list_locks_[curNodeNum]);
+            std::unique_lock <std::mutex> lock(link_list_locks_[curNodeNum], std::defer_lock);
+            if (lock_lists) {
+                lock.lock();
+            }
 
             int *data;// = (int *)(linkList0_ + curNodeNum * size_links_per_element0_);
             if (layer == 0) {
@@ -230,10 +268,19 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         return top_candidates;
     }
 
-    template <bool has_deletions>
+    // two_hop: the nodes filtered out by the bitset are not measured, the walk goes on to their neighbors
+    // directly, so that with most nodes filtered out it still moves by the nodes it can return
+    template <bool has_deletions, bool two_hop = false>
     std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst>
-    searchBaseLayerST(tableint ep_id, const void *data_point, size_t ef, const faiss::BitsetView bitset, StatisticsInfo &stats) const {
-        VisitedList *vl = visited_list_pool_->getFreeVisitedList();
+    searchBaseLayerST(tableint ep_id, const void *data_point, size_t ef, const faiss::BitsetView bitset, StatisticsInfo &stats,
+                      VisitedList *vl_in = nullptr) const {
+        // a caller-owned visited list (reused across a batch of queries) skips the pool lock
+        VisitedList *vl = vl_in;
+        if (vl == nullptr) {
+            vl = visited_list_pool_->getFreeVisitedList();
+        } else {
+            vl->reset();
+        }
         vl_type *visited_array = vl->mass;
         vl_type visited_array_tag = vl->curV;
 
@@ -242,7 +289,7 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 
         dist_t lowerBound;
 //        if (!has_deletions || !isMarkedDeleted(ep_id)) {
-          if (!has_deletions || !bitset.test((int64_t)ep_id)) {
+          if (!has_deletions || !bitset.test((int64_t)getExternalLabel(ep_id))) {
             dist_t dist = fstdistfunc_(data_point, getDataByInternalId(ep_id), dist_func_param_);
             lowerBound = dist;
             top_candidates.emplace(dist, ep_id);
@@ -271,7 +318,7 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 #ifdef USE_SSE
             _mm_prefetch((char *) (visited_array + *(data + 1)), _MM_HINT_T0);
             _mm_prefetch((char *) (visited_array + *(data + 1) + 64), _MM_HINT_T0);
-            _mm_prefetch(data_level0_memory_ + (*(data + 1)) * size_data_per_element_ + offsetData_, _MM_HINT_T0);
+            _mm_prefetch(getDataByInternalId(*(data + 1)), _MM_HINT_T0);
             _mm_prefetch((char *) (data + 2), _MM_HINT_T0);
 #endif
 
@@ -280,13 +327,34 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
                 // if (candidate_id == 0) continue;
 #ifdef USE_SSE
                 _mm_prefetch((char *) (visited_array + *(data + j + 1)), _MM_HINT_T0);
-                _mm_prefetch(data_level0_memory_ + (*(data + j + 1)) * size_data_per_element_ + offsetData_,
-                             _MM_HINT_T0);////////////
+                _mm_prefetch(getDataByInternalId(*(data + j + 1)), _MM_HINT_T0);
 #endif
                 if (!(visited_array[candidate_id] == visited_array_tag)) {
 
                     visited_array[candidate_id] = visited_array_tag;
 
+                    if (two_hop && bitset.test((int64_t)getExternalLabel(candidate_id))) {
+                        linklistsizeint *ll_hop = get_linklist0(candidate_id);
+                        size_t size_hop = getListCount(ll_hop);
+                        tableint *data_hop = (tableint *) (ll_hop + 1);
+                        for (size_t h = 0; h < size_hop; h++) {
+                            tableint hop_id = data_hop[h];
+                            if (visited_array[hop_id] == visited_array_tag ||
+                                bitset.test((int64_t)getExternalLabel(hop_id)))
+                                continue;
+                            visited_array[hop_id] = visited_array_tag;
+                            dist_t dist = fstdistfunc_(data_point, getDataByInternalId(hop_id), dist_func_param_);
+                            if (top_candidates.size() < ef || lowerBound > dist) {
+                                candidate_set.emplace(-dist, hop_id);
+                                top_candidates.emplace(dist, hop_id);
+                                if (top_candidates.size() > ef)
+                                    top_candidates.pop();
+                                lowerBound = top_candidates.top().first;
+                            }
+                        }
+                        continue;
+                    }
+
                     char *currObj1 = (getDataByInternalId(candidate_id));
                     dist_t dist = fstdistfunc_(data_point, currObj1, dist_func_param_);
 
@@ -299,7 +367,7 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 #endif
 
 //                        if (!has_deletions || !isMarkedDeleted(candidate_id))
-                        if (!has_deletions || (!bitset.test((int64_t)candidate_id))) {
+                        if (!has_deletions || (!bitset.test((int64_t)getExternalLabel(candidate_id)))) {
                             top_candidates.emplace(dist, candidate_id);
                         }
 
@@ -313,6 +381,100 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
             }
         }
 
+        if (vl_in == nullptr) {
+            visited_list_pool_->releaseVisitedList(vl);
+        }
+        return top_candidates;
+    }
+
+    // Intra-query parallel variant of searchBaseLayerST: each round pops up to `width` closest candidates,
+    // collects their unvisited neighbors against one shared visited list, computes the distances in
+    // parallel and merges them serially, so the result does not depend on the thread count.
+    template <bool has_deletions>
+    std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst>
+    searchBaseLayerParallel(tableint ep_id, const void *data_point, size_t ef, const faiss::BitsetView bitset,
+                            size_t width) const {
+        VisitedList *vl = visited_list_pool_->getFreeVisitedList();
+        vl_type *visited_array = vl->mass;
+        vl_type visited_array_tag = vl->curV;
+
+        std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst> top_candidates;
+        std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst> candidate_set;
+
+        dist_t lowerBound;
+        if (!has_deletions || !bitset.test((int64_t)getExternalLabel(ep_id))) {
+            dist_t dist = fstdistfunc_(data_point, getDataByInternalId(ep_id), dist_func_param_);
+            lowerBound = dist;
+            top_candidates.emplace(dist, ep_id);
+            candidate_set.emplace(-dist, ep_id);
+        } else {
+            lowerBound = std::numeric_limits<dist_t>::max();
+            candidate_set.emplace(-lowerBound, ep_id);
+        }
+        visited_array[ep_id] = visited_array_tag;
+
+        // one parallel region for the whole search: each round, a thread collects the frontier, the team
+        // computes its distances and a thread merges them
+        std::vector<tableint> frontier;
+        std::vector<dist_t> frontier_dist;
+        bool done = false;
+#pragma omp parallel
+        while (true) {
+#pragma omp single
+            {
+                frontier.clear();
+                while (true) {
+                    for (size_t w = 0; w < width && !candidate_set.empty(); w++) {
+                        std::pair<dist_t, tableint> current_node_pair = candidate_set.top();
+                        if ((-current_node_pair.first) > lowerBound) {
+                            break;
+                        }
+                        candidate_set.pop();
+
+                        int *data = (int *) get_linklist0(current_node_pair.second);
+                        size_t size = getListCount((linklistsizeint*)data);
+                        for (size_t j = 1; j <= size; j++) {
+                            tableint candidate_id = *(data + j);
+                            if (visited_array[candidate_id] != visited_array_tag) {
+                                visited_array[candidate_id] = visited_array_tag;
+                                frontier.push_back(candidate_id);
+                            }
+                        }
+                    }
+                    if (!frontier.empty() || candidate_set.empty() || (-candidate_set.top().first) > lowerBound) {
+                        break;
+                    }
+                }
+                done = frontier.empty();
+                frontier_dist.resize(frontier.size());
+            }
+            if (done) {
+                break;
+            }
+
+            int64_t frontier_size = frontier.size();
+#pragma omp for
+            for (int64_t i = 0; i < frontier_size; i++) {
+                frontier_dist[i] = fstdistfunc_(data_point, getDataByInternalId(frontier[i]), dist_func_param_);
+            }
+
+#pragma omp single
+            for (size_t i = 0; i < frontier.size(); i++) {
+                dist_t dist = frontier_dist[i];
+                tableint candidate_id = frontier[i];
+                if (top_candidates.size() < ef || lowerBound > dist) {
+                    candidate_set.emplace(-dist, candidate_id);
+                    if (!has_deletions || (!bitset.test((int64_t)getExternalLabel(candidate_id)))) {
+                        top_candidates.emplace(dist, candidate_id);
+                    }
+                    if (top_candidates.size() > ef)
+                        top_candidates.pop();
+                    if (!top_candidates.empty())
+                        lowerBound = top_candidates.top().first;
+                }
+            }
+        }
+
         visited_list_pool_->releaseVisitedList(vl);
         return top_candidates;
     }
@@ -341,7 +503,13 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
                 top_candidates.pop();
             }
 
-            for (std::pair<dist_t, tableint> &current_pair: queue_closest) {
+            for (size_t i = 0; i < queue_closest.size(); i++) {
+                std::pair<dist_t, tableint> &current_pair = queue_closest[i];
+#ifdef USE_SSE
+                if (i + 1 < queue_closest.size()) {
+                    _mm_prefetch(getDataByInternalId(queue_closest[i + 1].second), _MM_HINT_T0);
+                }
+#endif
                 bool good = true;
                 for (tableint id : return_list) {
                     dist_t curdist =
@@ -475,6 +643,159 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         return next_closest_entry_point;
     }
 
+    // batch sizes of addPointsBatched
+    size_t batch_min_graph_size_ = 4096;
+    size_t batch_graph_ratio_ = 8;
+    size_t batch_max_size_ = 65536;
+
+    // one batch of addPointsBatched, the graph must not be empty
+    void addBatch(const char *data, labeltype first_label, size_t n) {
+        // slots and levels, drawn in order as addPoint would
+        std::vector<tableint> slots(n);
+        std::vector<int> levels(n);
+        for (size_t j = 0; j < n; j++) {
+            slots[j] = internal_labels_.empty() ? (tableint)(first_label + j) : (tableint)(cur_element_count + j);
+            if (!internal_labels_.empty()) {
+                internal_labels_[slots[j]] = first_label + j;
+            }
+            levels[j] = getRandomLevel(mult_);
+            if (stats_enable) {
+                if (levels[j] >= level_stats_.size()) {
+                    level_stats_.resize(levels[j] + 1, 0);
+                }
+                level_stats_[levels[j]]++;
+            }
+        }
+        cur_element_count += n;
+        int maxlevelcopy = maxlevel_;
+        tableint enterpoint_copy = enterpoint_node_;
+
+        // (level, neighbor, new point) of each link to add to an existing list
+        std::vector<std::tuple<int, tableint, tableint>> reverse_links;
+
+        // an exception can't leave the omp region, the first one is thrown after it
+        std::exception_ptr error = nullptr;
+#pragma omp parallel
+        {
+            std::vector<std::tuple<int, tableint, tableint>> local_links;
+#pragma omp for schedule(dynamic, 64)
+            for (size_t j = 0; j < n; j++) {
+                try {
+                    const char *data_point = data + j * data_size_;
+                    tableint cur_c = slots[j];
+                    int curlevel = levels[j];
+                    element_levels_[cur_c] = curlevel;
+                    memset(data_level0_memory_ + cur_c * size_data_per_element_ + offsetLevel0_, 0, size_data_per_element_);
+                    memcpy(getDataByInternalId(cur_c), data_point, data_size_);
+                    if (curlevel) {
+                        linkLists_[cur_c] = (char *) malloc(size_links_per_element_ * curlevel + 1);
+                        if (linkLists_[cur_c] == nullptr)
+                            throw std::runtime_error("Not enough memory: addPoint failed to allocate linklist");
+                        memset(linkLists_[cur_c], 0, size_links_per_element_ * curlevel + 1);
+                    }
+
+                    tableint currObj = enterpoint_copy;
+                    dist_t curdist = fstdistfunc_(data_point, getDataByInternalId(currObj), dist_func_param_);
+                    for (int level = maxlevelcopy; level > curlevel; level--) {
+                        bool changed = true;
+                        while (changed) {
+                            changed = false;
+                            linklistsizeint *ll = get_linklist(currObj, level);
+                            int size = getListCount(ll);
+                            tableint *datal = (tableint *) (ll + 1);
+                            for (int k = 0; k < size; k++) {
+                                dist_t d = fstdistfunc_(data_point, getDataByInternalId(datal[k]), dist_func_param_);
+                                if (d < curdist) {
+                                    curdist = d;
+                                    currObj = datal[k];
+                                    changed = true;
+                                }
+                            }
+                        }
+                    }
+
+                    for (int level = std::min(curlevel, maxlevelcopy); level >= 0; level--) {
+                        auto top_candidates = searchBaseLayer(currObj, data_point, level, false);
+                        std::vector<tableint> selected(getNeighborsByHeuristic2(top_candidates, M_));
+                        linklistsizeint *ll_cur = level == 0 ? get_linklist0(cur_c) : get_linklist(cur_c, level);
+                        setListCount(ll_cur, selected.size());
+                        tableint *datal = (tableint *) (ll_cur + 1);
+                        for (size_t k = 0; k < selected.size(); k++) {
+                            datal[k] = selected[k];
+                            local_links.emplace_back(level, selected[k], cur_c);
+                        }
+                        currObj = selected.front();
+                    }
+                } catch (...) {
+#pragma omp critical
+                    if (error == nullptr) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+#pragma omp critical
+            reverse_links.insert(reverse_links.end(), local_links.begin(), local_links.end());
+        }
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+
+        // the links to each (level, neighbor) together, committed by one thread
+        std::sort(reverse_links.begin(), reverse_links.end());
+        std::vector<size_t> groups;
+        for (size_t j = 0; j < reverse_links.size(); j++) {
+            if (j == 0 || std::get<0>(reverse_links[j]) != std::get<0>(reverse_links[j - 1]) ||
+                std::get<1>(reverse_links[j]) != std::get<1>(reverse_links[j - 1])) {
+                groups.push_back(j);
+            }
+        }
+        size_t ngroups = groups.size();
+        groups.push_back(reverse_links.size());
+
+#pragma omp parallel for schedule(dynamic, 64)
+        for (size_t g = 0; g < ngroups; g++) {
+            int level = std::get<0>(reverse_links[groups[g]]);
+            tableint other = std::get<1>(reverse_links[groups[g]]);
+            size_t Mcurmax = level ? maxM_ : maxM0_;
+            linklistsizeint *ll_other = level == 0 ? get_linklist0(other) : get_linklist(other, level);
+            size_t sz = getListCount(ll_other);
+            tableint *datal = (tableint *) (ll_other + 1);
+            size_t nnew = groups[g + 1] - groups[g];
+
+            if (sz + nnew <= Mcurmax) {
+                for (size_t j = groups[g]; j < groups[g + 1]; j++) {
+                    datal[sz++] = std::get<2>(reverse_links[j]);
+                }
+                setListCount(ll_other, sz);
+                continue;
+            }
+
+            // prune the old and new neighbors together
+            std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst> candidates;
+            const char *other_data = getDataByInternalId(other);
+            for (size_t k = 0; k < sz; k++) {
+                candidates.emplace(fstdistfunc_(other_data, getDataByInternalId(datal[k]), dist_func_param_), datal[k]);
+            }
+            for (size_t j = groups[g]; j < groups[g + 1]; j++) {
+                tableint cur_c = std::get<2>(reverse_links[j]);
+                candidates.emplace(fstdistfunc_(other_data, getDataByInternalId(cur_c), dist_func_param_), cur_c);
+            }
+            std::vector<tableint> selected(getNeighborsByHeuristic2(candidates, Mcurmax));
+            setListCount(ll_other, static_cast<unsigned short int>(selected.size()));
+            for (size_t k = 0; k < selected.size(); k++) {
+                datal[k] = selected[k];
+            }
+        }
+
+        // the highest new point above the top level becomes the entry point
+        for (size_t j = 0; j < n; j++) {
+            if (levels[j] > maxlevel_) {
+                maxlevel_ = levels[j];
+                enterpoint_node_ = slots[j];
+            }
+        }
+    }
+
     std::mutex global;
     size_t ef_;
 
@@ -485,6 +806,10 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
     void resizeIndex(size_t new_max_elements){
         if (new_max_elements<cur_element_count)
             throw std::runtime_error("Cannot resize, max element is less than the current number of elements");
+        if (!data_level0_owned_)
+            throw std::runtime_error("Cannot resize, level0 is referenced in place from the loaded buffer");
+        if (raw_data_ && !raw_data_owned_)
+            throw std::runtime_error("Cannot resize, raw vectors are referenced in place from the loaded buffer");
 
 
         delete visited_list_pool_;
@@ -493,15 +818,26 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 
 
         element_levels_.resize(new_max_elements);
+        if (!internal_labels_.empty())
+            internal_labels_.resize(new_max_elements);
 
         std::vector<std::mutex>(new_max_elements).swap(link_list_locks_);
 
 
-        char * data_level0_memory_new = (char *) realloc(data_level0_memory_, new_max_elements * size_data_per_element_);
+        char * data_level0_memory_new = (char *) faiss::payload_realloc(data_level0_memory_, max_elements_ * size_data_per_element_,
+                                                                           new_max_elements * size_data_per_element_);
         if (data_level0_memory_new == nullptr)
             throw std::runtime_error("Not enough memory: resizeIndex failed to allocate base layer");
         data_level0_memory_ = data_level0_memory_new;
 
+        if (raw_data_) {
+            char *raw_data_new = (char *) faiss::payload_realloc(raw_data_, max_elements_ * raw_size_,
+                                                                 new_max_elements * raw_size_);
+            if (raw_data_new == nullptr)
+                throw std::runtime_error("Not enough memory: resizeIndex failed to allocate raw vectors");
+            raw_data_ = raw_data_new;
+        }
+
         // Reallocate all other layers
         char ** linkLists_new = (char **) realloc(linkLists_, sizeof(void *) * new_max_elements);
         if (linkLists_new == nullptr)
@@ -512,7 +848,15 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 
     }
 
-    void saveIndex(milvus::knowhere::MemoryIOWriter& output) {
+    // graph_only: write the links of level0 without the vectors, loadIndex then expects them from setRawData()
+    void saveIndex(milvus::knowhere::MemoryIOWriter& output, bool graph_only = false) {
+        if (graph_only && (level0_codec_ == LEVEL0_SQ8 || level0_codec_ == LEVEL0_FP16))
+            throw std::runtime_error("Cannot save a quantized level0 without its codes");
+        if (graph_only && !internal_labels_.empty())
+            throw std::runtime_error("Cannot save a reordered index without its vectors, they are in label order");
+        bool strip_vectors = graph_only && level0_codec_ == LEVEL0_FLOAT;
+        size_t size_data_per_element = strip_vectors ? size_links_level0_ : size_data_per_element_;
+
         // write l2/ip calculator
         writeBinaryPOD(output, metric_type_);
         writeBinaryPOD(output, data_size_);
@@ -521,7 +865,7 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         writeBinaryPOD(output, offsetLevel0_);
         writeBinaryPOD(output, max_elements_);
         writeBinaryPOD(output, cur_element_count);
-        writeBinaryPOD(output, size_data_per_element_);
+        writeBinaryPOD(output, size_data_per_element);
         writeBinaryPOD(output, label_offset_);
         writeBinaryPOD(output, offsetData_);
         writeBinaryPOD(output, maxlevel_);
@@ -533,7 +877,12 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         writeBinaryPOD(output, mult_);
         writeBinaryPOD(output, ef_construction_);
 
-        output.write(data_level0_memory_, cur_element_count * size_data_per_element_);
+        if (strip_vectors) {
+            for (size_t i = 0; i < cur_element_count; i++)
+                output.write((char *) get_linklist0(i), size_links_level0_);
+        } else {
+            output.write(data_level0_memory_, cur_element_count * size_data_per_element_);
+        }
 
         for (size_t i = 0; i < cur_element_count; i++) {
             unsigned int linkListSize = element_levels_[i] > 0 ? size_links_per_element_ * element_levels_[i] : 0;
@@ -541,10 +890,18 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
             if (linkListSize)
                 output.write(linkLists_[i], linkListSize);
         }
+
+        // optional trailer, absent in indexes that were never reordered
+        if (!internal_labels_.empty()) {
+            writeBinaryPOD(output, cur_element_count);
+            output.write((char *) internal_labels_.data(), cur_element_count * sizeof(labeltype));
+        }
         // output.close();
     }
 
-    void loadIndex(milvus::knowhere::MemoryIOReader& input, size_t max_elements_i = 0) {
+    // in_place: reference level0 inside the reader buffer instead of copying it, the buffer must stay alive
+    // (and unmodified) as long as the index is used, and no point can be added
+    void loadIndex(milvus::knowhere::MemoryIOReader& input, size_t max_elements_i = 0, bool in_place = false) {
         // linxj: init with metrictype
         size_t dim = 100;
         readBinaryPOD(input, metric_type_);
@@ -567,6 +924,8 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         size_t max_elements=max_elements_i;
         if(max_elements < cur_element_count)
             max_elements = max_elements_;
+        if (in_place)
+            max_elements = cur_element_count;
         max_elements_ = max_elements;
         readBinaryPOD(input, size_data_per_element_);
         readBinaryPOD(input, label_offset_);
@@ -614,10 +973,17 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         // input.seekg(pos,input.beg);
 
 
-        data_level0_memory_ = (char *) malloc(max_elements * size_data_per_element_);
-        if (data_level0_memory_ == nullptr)
-            throw std::runtime_error("Not enough memory: loadIndex failed to allocate level0");
-        input.read(data_level0_memory_, cur_element_count * size_data_per_element_);
+        if (in_place) {
+            data_level0_memory_ = (char *) input.read_in_place(cur_element_count * size_data_per_element_);
+            if (data_level0_memory_ == nullptr)
+                throw std::runtime_error("Index seems to be corrupted: loadIndex failed to reference level0");
+            data_level0_owned_ = false;
+        } else {
+            data_level0_memory_ = (char *) faiss::payload_alloc(max_elements * size_data_per_element_);
+            if (data_level0_memory_ == nullptr)
+                throw std::runtime_error("Not enough memory: loadIndex failed to allocate level0");
+            input.read(data_level0_memory_, cur_element_count * size_data_per_element_);
+        }
 
 
 
@@ -628,6 +994,13 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         size_links_level0_ = maxM0_ * sizeof(tableint) + sizeof(linklistsizeint);
         std::vector<std::mutex>(max_elements).swap(link_list_locks_);
 
+        // written with graph_only: links only, the walk reads the vectors attached by setRawData()
+        if (size_data_per_element_ == size_links_level0_) {
+            level0_codec_ = LEVEL0_NONE;
+            raw_size_ = data_size_;
+            raw_data_ = nullptr;
+            raw_data_owned_ = false;
+        }
 
         visited_list_pool_ = new VisitedListPool(1, max_elements);
 
@@ -659,9 +1032,21 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
                 input.read(linkLists_[i], linkListSize);
             }
         }
+
+        internal_labels_.clear();
+        if (input.rp < input.total) {
+            size_t label_count;
+            readBinaryPOD(input, label_count);
+            if (label_count != cur_element_count)
+                throw std::runtime_error("Index seems to be corrupted: label count mismatch");
+            internal_labels_.resize(max_elements);
+            input.read((char *) internal_labels_.data(), label_count * sizeof(labeltype));
+        }
     }
 
     void saveIndex(const std::string &location) {
+        if (!internal_labels_.empty())
+            throw std::runtime_error("Cannot save a reordered index to a file, use the MemoryIOWriter overload");
         std::ofstream output(location, std::ios::binary);
         std::streampos position;
 
@@ -753,7 +1138,7 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 
         input.seekg(pos,input.beg);
 
-        data_level0_memory_ = (char *) malloc(max_elements * size_data_per_element_);
+        data_level0_memory_ = (char *) faiss::payload_alloc(max_elements * size_data_per_element_);
         if (data_level0_memory_ == nullptr)
             throw std::runtime_error("Not enough memory: loadIndex failed to allocate level0");
         input.read(data_level0_memory_, cur_element_count * size_data_per_element_);
@@ -802,6 +1187,8 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
     }
 
     tableint addPoint(const void *data_point, labeltype label, int level) {
+        if (level0_codec_ != LEVEL0_FLOAT)
+            throw std::runtime_error("Cannot add to an index whose level0 is quantized or holds no vectors");
         tableint cur_c = label;
         {
             std::unique_lock <std::mutex> lock(cur_element_count_guard_);
@@ -809,6 +1196,11 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
                 throw std::runtime_error("The number of elements exceeds the specified limit");
             };
 
+            // once reordered, internal ids no longer follow labels: append and record the label
+            if (!internal_labels_.empty()) {
+                cur_c = cur_element_count;
+                internal_labels_[cur_c] = label;
+            }
             cur_element_count++;
         }
 
@@ -894,8 +1286,60 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         return cur_c;
     };
 
+    // Inserts n points of consecutive labels in batches. The points of a batch search the graph as it was before
+    // the batch, in parallel and without locks, and write their own link lists. The reverse links are then
+    // grouped by neighbor, so that each list is extended (and pruned) once, by a single thread and without locks.
+    // Points of a batch do not see each other, so a batch is kept to a fraction of the graph and the first points
+    // are inserted one at a time with addPoint.
+    void addPointsBatched(const void *data_points, labeltype first_label, size_t n) {
+        const char *data = (const char *) data_points;
+        if (level0_codec_ != LEVEL0_FLOAT)
+            throw std::runtime_error("Cannot add to an index whose level0 is quantized or holds no vectors");
+        if (cur_element_count + n > max_elements_) {
+            throw std::runtime_error("The number of elements exceeds the specified limit");
+        }
+
+        size_t i = 0;
+        if (cur_element_count == 0 && n > 0) {
+            addPoint(data, first_label);
+            i = 1;
+        }
+        size_t nserial = std::min(n, std::max(i, batch_min_graph_size_ - std::min(batch_min_graph_size_, cur_element_count)));
+        // an exception can't leave the omp region, the first one is thrown after it
+        std::exception_ptr error = nullptr;
+#pragma omp parallel for
+        for (size_t j = i; j < nserial; j++) {
+            try {
+                addPoint(data + j * data_size_, first_label + j);
+            } catch (...) {
+#pragma omp critical
+                if (error == nullptr) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+
+        for (i = nserial; i < n;) {
+            size_t batch = std::min(n - i, std::max((size_t)1, std::min(cur_element_count / batch_graph_ratio_, batch_max_size_)));
+            addBatch(data + i * data_size_, first_label + i, batch);
+            i += batch;
+        }
+    }
+
     std::priority_queue<std::pair<dist_t, labeltype >>
     searchKnn(const void *query_data, size_t k, const faiss::BitsetView bitset, StatisticsInfo &stats) const {
+        return searchKnn(query_data, k, bitset, stats, nullptr, 1);
+    }
+
+    // vl: optional caller-owned visited list, reused by a thread across a batch of queries;
+    // search_width > 1 expands that many base-layer candidates per round in parallel;
+    // two_hop: walk the base layer past the nodes filtered out by the bitset, see searchBaseLayerST
+    std::priority_queue<std::pair<dist_t, labeltype >>
+    searchKnn(const void *query_data, size_t k, const faiss::BitsetView bitset, StatisticsInfo &stats,
+              VisitedList *vl, size_t search_width, bool two_hop = false) const {
         std::priority_queue<std::pair<dist_t, labeltype >> result;
         if (cur_element_count == 0) return result;
 
@@ -916,7 +1360,7 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
                     if (cand < 0 || cand > max_elements_)
                         throw std::runtime_error("cand error");
                     if (stats_enable && level == stats.target_level) {
-                        stats.accessed_points.push_back(cand);
+                        stats.accessed_points.push_back(getExternalLabel(cand));
                     }
                     dist_t d = fstdistfunc_(query_data, getDataByInternalId(cand), dist_func_param_);
 
@@ -930,27 +1374,480 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         }
 
         std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst> top_candidates;
-        if (!bitset.empty()) {
+        if (two_hop && !bitset.empty()) {
+            top_candidates = searchBaseLayerST<true, true>(currObj, query_data, std::max(ef_, k), bitset, stats, vl);
+        } else if (search_width > 1) {
+            if (!bitset.empty()) {
+                top_candidates = searchBaseLayerParallel<true>(currObj, query_data, std::max(ef_, k), bitset, search_width);
+            } else {
+                top_candidates = searchBaseLayerParallel<false>(currObj, query_data, std::max(ef_, k), bitset, search_width);
+            }
+        } else if (!bitset.empty()) {
             std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst>
-                top_candidates1 = searchBaseLayerST<true>(currObj, query_data, std::max(ef_, k), bitset, stats);
+                top_candidates1 = searchBaseLayerST<true>(currObj, query_data, std::max(ef_, k), bitset, stats, vl);
             top_candidates.swap(top_candidates1);
         }
         else{
             std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst>
-                top_candidates1 = searchBaseLayerST<false>(currObj, query_data, std::max(ef_, k), bitset, stats);
+                top_candidates1 = searchBaseLayerST<false>(currObj, query_data, std::max(ef_, k), bitset, stats, vl);
             top_candidates.swap(top_candidates1);
         }
+        if (level0_codec_ == LEVEL0_SQ8 || level0_codec_ == LEVEL0_FP16) {
+            // the candidates were ranked on the codes, re-rank them on the full vectors
+            std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst> exact;
+            while (!top_candidates.empty()) {
+                tableint id = top_candidates.top().second;
+                top_candidates.pop();
+                exact.emplace(rawdistfunc_(query_data, getRawDataByInternalId(id), raw_dist_func_param_), id);
+                if (exact.size() > k)
+                    exact.pop();
+            }
+            top_candidates.swap(exact);
+        }
         while (top_candidates.size() > k) {
             top_candidates.pop();
         }
         while (top_candidates.size() > 0) {
             std::pair<dist_t, tableint> rez = top_candidates.top();
-            result.push(std::pair<dist_t, labeltype>(rez.first, rez.second));
+            result.push(std::pair<dist_t, labeltype>(rez.first, getExternalLabel(rez.second)));
             top_candidates.pop();
         }
         return result;
     };
 
+    // Exact top-k over the points the bitset keeps, for filters that leave too few of them to walk the graph
+    std::priority_queue<std::pair<dist_t, labeltype>>
+    searchKnnBruteForce(const void *query_data, size_t k, const faiss::BitsetView bitset) const {
+        std::priority_queue<std::pair<dist_t, labeltype>> result;
+        bool quantized = level0_codec_ == LEVEL0_SQ8 || level0_codec_ == LEVEL0_FP16;
+        for (tableint i = 0; i < cur_element_count; i++) {
+            labeltype label = getExternalLabel(i);
+            if (!bitset.empty() && bitset.test((int64_t)label))
+                continue;
+            dist_t dist = quantized ? rawdistfunc_(query_data, getRawDataByInternalId(i), raw_dist_func_param_)
+                                    : fstdistfunc_(query_data, getDataByInternalId(i), dist_func_param_);
+            if (result.size() < k || dist < result.top().first) {
+                result.emplace(dist, label);
+                if (result.size() > k)
+                    result.pop();
+            }
+        }
+        return result;
+    }
+
+    // Renumber internal ids in BFS order of the level-0 graph, starting from the entry point, so that
+    // neighbors mostly sit in nearby level0 blocks and the base-layer walk touches fewer cache lines and
+    // pages. Labels are kept in internal_labels_, results and bitsets keep working on labels.
+    void reorderLevel0() {
+        if (level0_codec_ == LEVEL0_NONE)
+            throw std::runtime_error("Cannot reorder a graph-only index, its vectors are in label order");
+        size_t n = cur_element_count;
+        if (n == 0)
+            return;
+
+        const tableint unset = (tableint) -1;
+        std::vector<tableint> order;
+        std::vector<tableint> new_id(n, unset);
+        order.reserve(n);
+        auto bfs = [&](tableint root) {
+            size_t head = order.size();
+            new_id[root] = order.size();
+            order.push_back(root);
+            while (head < order.size()) {
+                linklistsizeint *ll = get_linklist0(order[head++]);
+                size_t size = getListCount(ll);
+                tableint *datal = (tableint *) (ll + 1);
+                for (size_t j = 0; j < size; j++) {
+                    if (new_id[datal[j]] == unset) {
+                        new_id[datal[j]] = order.size();
+                        order.push_back(datal[j]);
+                    }
+                }
+            }
+        };
+        bfs(enterpoint_node_);
+        for (tableint i = 0; i < n; i++) {
+            if (new_id[i] == unset)
+                bfs(i);
+        }
+        renumber(order, new_id);
+    }
+
+    // Moves the nodes of order to internal ids 0..order.size()-1 and maps the links through new_id.
+    // Nodes not in order are dropped, no link may point to them; their upper layers must be freed already.
+    // Labels are kept in internal_labels_.
+    void renumber(const std::vector<tableint> &order, const std::vector<tableint> &new_id) {
+        size_t n = order.size();
+        char *level0_new = (char *) faiss::payload_alloc(max_elements_ * size_data_per_element_);
+        if (level0_new == nullptr)
+            throw std::runtime_error("Not enough memory: renumber failed to allocate level0");
+        char **linkLists_new = (char **) malloc(sizeof(void *) * max_elements_);
+        if (linkLists_new == nullptr) {
+            faiss::payload_free(level0_new);
+            throw std::runtime_error("Not enough memory: renumber failed to allocate linklists");
+        }
+        char *raw_data_new = nullptr;
+        if (raw_data_) {
+            raw_data_new = (char *) faiss::payload_alloc(max_elements_ * raw_size_);
+            if (raw_data_new == nullptr) {
+                faiss::payload_free(level0_new);
+                free(linkLists_new);
+                throw std::runtime_error("Not enough memory: renumber failed to allocate raw vectors");
+            }
+        }
+        std::vector<int> element_levels_new(max_elements_);
+        std::vector<labeltype> labels_new(max_elements_);
+
+        auto remap = [&](linklistsizeint *ll) {
+            size_t size = getListCount(ll);
+            tableint *datal = (tableint *) (ll + 1);
+            for (size_t j = 0; j < size; j++)
+                datal[j] = new_id[datal[j]];
+        };
+#pragma omp parallel for
+        for (int64_t i = 0; i < (int64_t) n; i++) {
+            tableint old_id = order[i];
+            memcpy(level0_new + i * size_data_per_element_, data_level0_memory_ + old_id * size_data_per_element_,
+                   size_data_per_element_);
+            remap((linklistsizeint *) (level0_new + i * size_data_per_element_ + offsetLevel0_));
+            if (raw_data_new)
+                memcpy(raw_data_new + i * raw_size_, getRawDataByInternalId(old_id), raw_size_);
+            linkLists_new[i] = linkLists_[old_id];
+            element_levels_new[i] = element_levels_[old_id];
+            for (int level = 1; level <= element_levels_new[i]; level++)
+                remap((linklistsizeint *) (linkLists_new[i] + (level - 1) * size_links_per_element_));
+            labels_new[i] = getExternalLabel(old_id);
+        }
+
+        if (data_level0_owned_)
+            faiss::payload_free(data_level0_memory_);
+        data_level0_memory_ = level0_new;
+        data_level0_owned_ = true;
+        if (raw_data_new) {
+            if (raw_data_owned_)
+                faiss::payload_free(raw_data_);
+            raw_data_ = raw_data_new;
+            raw_data_owned_ = true;
+        }
+        free(linkLists_);
+        linkLists_ = linkLists_new;
+        element_levels_.swap(element_levels_new);
+        internal_labels_.swap(labels_new);
+        cur_element_count = n;
+        if ((signed)enterpoint_node_ != -1)
+            enterpoint_node_ = new_id[enterpoint_node_];
+    }
+
+    // In-place renumber for an increasing order (order[i] >= i), as left by removePoints: each node moves down
+    // inside the buffers it already has, so that repeated removals neither allocate nor copy the whole graph.
+    // Raw vectors referenced from a read-only buffer are copied out once.
+    void compact(const std::vector<tableint> &order, const std::vector<tableint> &new_id) {
+        size_t n = order.size();
+        char *raw_data_new = raw_data_;
+        if (raw_data_ && !raw_data_owned_) {
+            raw_data_new = (char *) faiss::payload_alloc(max_elements_ * raw_size_);
+            if (raw_data_new == nullptr)
+                throw std::runtime_error("Not enough memory: compact failed to allocate raw vectors");
+        }
+        if (internal_labels_.empty()) {
+            internal_labels_.resize(max_elements_);
+            for (tableint i = 0; i < cur_element_count; i++)
+                internal_labels_[i] = i;
+        }
+
+        // a slot is only written once every node it held has moved, the moves are done in order
+        for (size_t i = 0; i < n; i++) {
+            tableint old_id = order[i];
+            if (raw_data_ && (raw_data_new != raw_data_ || old_id != i))
+                memcpy(raw_data_new + i * raw_size_, raw_data_ + old_id * raw_size_, raw_size_);
+            if (old_id == i)
+                continue;
+            memcpy(data_level0_memory_ + i * size_data_per_element_,
+                   data_level0_memory_ + old_id * size_data_per_element_, size_data_per_element_);
+            linkLists_[i] = linkLists_[old_id];
+            element_levels_[i] = element_levels_[old_id];
+            internal_labels_[i] = internal_labels_[old_id];
+        }
+        for (size_t i = n; i < cur_element_count; i++) {
+            linkLists_[i] = nullptr;
+            element_levels_[i] = 0;
+        }
+
+        auto remap = [&](linklistsizeint *ll) {
+            size_t size = getListCount(ll);
+            tableint *datal = (tableint *) (ll + 1);
+            for (size_t j = 0; j < size; j++)
+                datal[j] = new_id[datal[j]];
+        };
+#pragma omp parallel for
+        for (int64_t i = 0; i < (int64_t) n; i++) {
+            remap(get_linklist0(i));
+            for (int level = 1; level <= element_levels_[i]; level++)
+                remap(get_linklist(i, level));
+        }
+
+        if (raw_data_new != raw_data_) {
+            raw_data_ = raw_data_new;
+            raw_data_owned_ = true;
+        }
+        cur_element_count = n;
+        if ((signed)enterpoint_node_ != -1)
+            enterpoint_node_ = new_id[enterpoint_node_];
+    }
+
+    // Removes the points whose new_labels[label] is negative and relabels the others to new_labels[label].
+    // Each list that links to a removed point is rebuilt by the heuristic over its remaining neighbors and
+    // the neighbors of the removed points, so that what was reached through them stays reachable. The points
+    // left are then compacted in order, the freed slots are taken again by the next addPoint.
+    size_t removePoints(const int64_t *new_labels) {
+        if (level0_codec_ != LEVEL0_FLOAT)
+            throw std::runtime_error("Cannot remove from an index whose level0 is quantized or holds no vectors");
+        size_t n = cur_element_count;
+        std::vector<bool> removed(n);
+        size_t nremoved = 0;
+        for (tableint i = 0; i < n; i++) {
+            removed[i] = new_labels[getExternalLabel(i)] < 0;
+            nremoved += removed[i];
+        }
+        if (nremoved == 0)
+            return 0;
+
+        // the repair writes level0, which may be referenced in place from a read-only buffer
+        if (!data_level0_owned_) {
+            char *level0_copy = (char *) faiss::payload_alloc(max_elements_ * size_data_per_element_);
+            if (level0_copy == nullptr)
+                throw std::runtime_error("Not enough memory: removePoints failed to allocate level0");
+            memcpy(level0_copy, data_level0_memory_, n * size_data_per_element_);
+            data_level0_memory_ = level0_copy;
+            data_level0_owned_ = true;
+        }
+
+        // removed points keep their lists until the end, the repair reads them
+#pragma omp parallel for schedule(dynamic, 64)
+        for (int64_t i = 0; i < (int64_t) n; i++) {
+            if (removed[i])
+                continue;
+            const char *data_i = getDataByInternalId(i);
+            for (int level = 0; level <= element_levels_[i]; level++) {
+                linklistsizeint *ll = level == 0 ? get_linklist0(i) : get_linklist(i, level);
+                size_t sz = getListCount(ll);
+                tableint *datal = (tableint *) (ll + 1);
+                bool hit = false;
+                for (size_t j = 0; j < sz && !hit; j++)
+                    hit = removed[datal[j]];
+                if (!hit)
+                    continue;
+
+                std::vector<tableint> cands;
+                for (size_t j = 0; j < sz; j++) {
+                    if (!removed[datal[j]]) {
+                        cands.push_back(datal[j]);
+                        continue;
+                    }
+                    linklistsizeint *ll_del = level == 0 ? get_linklist0(datal[j]) : get_linklist(datal[j], level);
+                    size_t sz_del = getListCount(ll_del);
+                    tableint *datal_del = (tableint *) (ll_del + 1);
+                    for (size_t k = 0; k < sz_del; k++) {
+                        if (!removed[datal_del[k]] && datal_del[k] != (tableint) i)
+                            cands.push_back(datal_del[k]);
+                    }
+                }
+                std::sort(cands.begin(), cands.end());
+                cands.erase(std::unique(cands.begin(), cands.end()), cands.end());
+
+                std::priority_queue<std::pair<dist_t, tableint>, std::vector<std::pair<dist_t, tableint>>, CompareByFirst> candidates;
+                for (tableint c : cands)
+                    candidates.emplace(fstdistfunc_(data_i, getDataByInternalId(c), dist_func_param_), c);
+                size_t Mcurmax = level ? maxM_ : maxM0_;
+                std::vector<tableint> selected;
+                if (!candidates.empty())
+                    selected = getNeighborsByHeuristic2(candidates, Mcurmax);
+                setListCount(ll, static_cast<unsigned short int>(selected.size()));
+                for (size_t k = 0; k < selected.size(); k++)
+                    datal[k] = selected[k];
+            }
+        }
+
+        if (removed[enterpoint_node_]) {
+            enterpoint_node_ = -1;
+            maxlevel_ = -1;
+            for (tableint i = 0; i < n; i++) {
+                if (!removed[i] && element_levels_[i] > maxlevel_) {
+                    maxlevel_ = element_levels_[i];
+                    enterpoint_node_ = i;
+                }
+            }
+        }
+
+        const tableint unset = (tableint) -1;
+        std::vector<tableint> order;
+        std::vector<tableint> new_id(n, unset);
+        order.reserve(n - nremoved);
+        for (tableint i = 0; i < n; i++) {
+            if (removed[i]) {
+                if (element_levels_[i] > 0)
+                    free(linkLists_[i]);
+                if (stats_enable && element_levels_[i] < (int) level_stats_.size())
+                    level_stats_[element_levels_[i]]--;
+            } else {
+                new_id[i] = order.size();
+                order.push_back(i);
+            }
+        }
+        compact(order, new_id);
+
+        // back to labels as internal ids when they line up again
+        bool identity = true;
+        for (tableint i = 0; i < cur_element_count; i++) {
+            internal_labels_[i] = new_labels[internal_labels_[i]];
+            identity = identity && internal_labels_[i] == i;
+        }
+        if (identity)
+            internal_labels_.clear();
+        return nremoved;
+    }
+
+    // Replace the vectors in level0 by SQ8 or FP16 codes, so that the walk reads 4x or 2x less vector
+    // data per node. The full vectors move to raw_data_ and searchKnn re-ranks its candidates on them.
+    // The graph is left as built on the full vectors, and no point can be added afterwards.
+    void quantizeLevel0(Level0Codec codec) {
+        if (level0_codec_ != LEVEL0_FLOAT)
+            throw std::runtime_error("Level0 is already quantized");
+        if (codec != LEVEL0_SQ8 && codec != LEVEL0_FP16)
+            throw std::runtime_error("Unsupported level0 codec");
+        if (metric_type_ > 1)
+            throw std::runtime_error("Level0 quantization supports L2 and IP only");
+
+        size_t dim = *((size_t *) dist_func_param_);
+        size_t n = cur_element_count;
+        size_t code_size = codec == LEVEL0_SQ8 ? dim : dim * sizeof(uint16_t);
+
+        code_trained_.clear();
+        if (codec == LEVEL0_SQ8) {
+            code_trained_.assign(2 * dim, 0);
+            std::vector<float> vmax(dim, 0);
+            for (size_t i = 0; i < n; i++) {
+                const float *x = (const float *) getDataByInternalId(i);
+                for (size_t d = 0; d < dim; d++) {
+                    code_trained_[d] = i == 0 ? x[d] : std::min(code_trained_[d], x[d]);
+                    vmax[d] = i == 0 ? x[d] : std::max(vmax[d], x[d]);
+                }
+            }
+            for (size_t d = 0; d < dim; d++)
+                code_trained_[dim + d] = (vmax[d] - code_trained_[d]) / 255.0f;
+        }
+
+        size_t size_data_per_element_new = size_links_level0_ + code_size;
+        char *level0_new = (char *) faiss::payload_alloc(max_elements_ * size_data_per_element_new);
+        if (level0_new == nullptr)
+            throw std::runtime_error("Not enough memory: quantizeLevel0 failed to allocate level0");
+        char *raw_data_new = (char *) faiss::payload_alloc(max_elements_ * data_size_);
+        if (raw_data_new == nullptr) {
+            faiss::payload_free(level0_new);
+            throw std::runtime_error("Not enough memory: quantizeLevel0 failed to allocate raw vectors");
+        }
+
+        const float *vmin = code_trained_.data();
+        const float *step = code_trained_.data() + dim;
+#pragma omp parallel for
+        for (int64_t i = 0; i < (int64_t) n; i++) {
+            const float *x = (const float *) getDataByInternalId(i);
+            char *element = level0_new + i * size_data_per_element_new;
+            memcpy(element + offsetLevel0_, get_linklist0(i), size_links_level0_);
+            memcpy(raw_data_new + i * data_size_, x, data_size_);
+            if (codec == LEVEL0_SQ8) {
+                uint8_t *code = (uint8_t *) (element + offsetData_);
+                for (size_t d = 0; d < dim; d++) {
+                    float c = step[d] > 0 ? std::nearbyint((x[d] - vmin[d]) / step[d]) : 0;
+                    code[d] = (uint8_t) std::min(255.0f, std::max(0.0f, c));
+                }
+            } else {
+                uint16_t *code = (uint16_t *) (element + offsetData_);
+                for (size_t d = 0; d < dim; d++)
+                    code[d] = float_to_fp16(x[d]);
+            }
+        }
+
+        if (data_level0_owned_)
+            faiss::payload_free(data_level0_memory_);
+        data_level0_memory_ = level0_new;
+        data_level0_owned_ = true;
+        size_data_per_element_ = size_data_per_element_new;
+        raw_data_ = raw_data_new;
+        raw_data_owned_ = true;
+        raw_size_ = data_size_;
+        data_size_ = code_size;
+        setLevel0Codec(codec, dim);
+    }
+
+    // Optional companion of saveIndex for a quantized level0: the codec and the full vectors
+    void saveCodec(milvus::knowhere::MemoryIOWriter& output) {
+        size_t trained_size = code_trained_.size();
+        writeBinaryPOD(output, level0_codec_);
+        writeBinaryPOD(output, raw_size_);
+        writeBinaryPOD(output, trained_size);
+        if (trained_size)
+            output.write((char *) code_trained_.data(), trained_size * sizeof(float));
+        writeBinaryPOD(output, cur_element_count);
+        output.write(raw_data_, cur_element_count * raw_size_);
+    }
+
+    // After loadIndex, with the output of saveCodec. in_place: as for loadIndex, reference the full
+    // vectors inside the reader buffer
+    void loadCodec(milvus::knowhere::MemoryIOReader& input, bool in_place = false) {
+        size_t codec, trained_size, count;
+        readBinaryPOD(input, codec);
+        if (codec != LEVEL0_SQ8 && codec != LEVEL0_FP16)
+            throw std::runtime_error("Index seems to be corrupted: unknown level0 codec");
+        readBinaryPOD(input, raw_size_);
+        readBinaryPOD(input, trained_size);
+        code_trained_.resize(trained_size);
+        if (trained_size)
+            input.read((char *) code_trained_.data(), trained_size * sizeof(float));
+        readBinaryPOD(input, count);
+        if (count != cur_element_count || raw_size_ != *((size_t *) dist_func_param_) * sizeof(float))
+            throw std::runtime_error("Index seems to be corrupted: raw vectors don't match level0");
+
+        if (in_place) {
+            raw_data_ = (char *) input.read_in_place(count * raw_size_);
+            if (raw_data_ == nullptr)
+                throw std::runtime_error("Index seems to be corrupted: loadCodec failed to reference raw vectors");
+            raw_data_owned_ = false;
+        } else {
+            raw_data_ = (char *) faiss::payload_alloc(max_elements_ * raw_size_);
+            if (raw_data_ == nullptr)
+                throw std::runtime_error("Not enough memory: loadCodec failed to allocate raw vectors");
+            raw_data_owned_ = true;
+            input.read(raw_data_, count * raw_size_);
+        }
+        setLevel0Codec((Level0Codec) codec, *((size_t *) dist_func_param_));
+    }
+
+    // Attach the vectors of a graph-only index, in label order. They are owned by the caller and must
+    // stay alive (and unmodified) as long as the index is used.
+    void setRawData(const void *data) {
+        if (level0_codec_ != LEVEL0_NONE)
+            throw std::runtime_error("The index holds its own vectors");
+        raw_data_ = (char *) data;
+        raw_data_owned_ = false;
+    }
+
+    void setLevel0Codec(Level0Codec codec, size_t dim) {
+        level0_codec_ = codec;
+        rawdistfunc_ = space->get_dist_func();
+        raw_dist_func_param_ = space->get_dist_func_param();
+        code_param_.dim = dim;
+        code_param_.vmin = code_trained_.data();
+        code_param_.step = code_trained_.data() + code_trained_.size() / 2;
+        bool ip = (metric_type_ == 1);
+        if (codec == LEVEL0_SQ8) {
+            fstdistfunc_ = ip ? DistanceSQ8<true> : DistanceSQ8<false>;
+        } else {
+            fstdistfunc_ = ip ? DistanceFP16<true> : DistanceFP16<false>;
+        }
+        dist_func_param_ = &code_param_;
+    }
+
     int64_t cal_size() {
         int64_t ret = 0;
         ret += sizeof(*this);
@@ -958,7 +1855,10 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         ret += visited_list_pool_->GetSize();
         ret += link_list_locks_.size() * sizeof(std::mutex);
         ret += element_levels_.size() * sizeof(int);
+        ret += internal_labels_.size() * sizeof(labeltype);
         ret += max_elements_ * size_data_per_element_;
+        if (raw_data_ && level0_codec_ != LEVEL0_NONE)
+            ret += max_elements_ * raw_size_;
         ret += max_elements_ * sizeof(void*);
         for (auto i = 0; i < max_elements_; ++ i) {
             if (element_levels_[i] > 0) {
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <faiss/FaissHook.h>
+
+namespace hnswlib {
+
+// Representation of the vectors kept in level0 for the graph walk, see HierarchicalNSW::quantizeLevel0
+enum Level0Codec {
+    LEVEL0_FLOAT = 0,  // full float vectors
+    LEVEL0_SQ8 = 1,    // one byte per component, min/max of each dimension over the data
+    LEVEL0_FP16 = 2,   // IEEE half precision
+    LEVEL0_NONE = 3,   // links only, the vectors are outside of the index
+};
+
+// dim first: read as the dimension, like the size_t param of L2Space/InnerProductSpace
+struct CodeDistParam {
+    size_t dim;
+    const float *vmin;  // SQ8: component i decodes to vmin[i] + code[i] * step[i]
+    const float *step;
+};
+
+// rounds to nearest even
+static inline uint16_t
+float_to_fp16(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    uint16_t sign = (x >> 16) & 0x8000;
+    uint32_t absx = x & 0x7fffffff;
+    if (absx > 0x7f800000)
+        return sign | 0x7e00;
+    if (absx >= 0x477ff000)  // 65520 and above round to infinity
+        return sign | 0x7c00;
+    if (absx < 0x38800000) {  // below 2^-14: subnormal
+        float a;
+        memcpy(&a, &absx, sizeof(a));
+        return sign | (uint16_t) std::nearbyint(a * 16777216.0f);
+    }
+    uint32_t mant = absx & 0x7fffff;
+    uint32_t h = (((absx >> 23) - 112) << 10) | (mant >> 13);
+    uint32_t rem = mant & 0x1fff;
+    if (rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+        h++;
+    return sign | (uint16_t) h;
+}
+
+// Distances from a float query (pVect1) to a code (pVect2), computed by the SIMD kernels hooked
+// in knowhere/utils like the float spaces.
+template <bool ip>
+static float
+DistanceSQ8(const void *pVect1, const void *pVect2, const void *param) {
+    auto p = (const CodeDistParam *) param;
+    auto x = (const float *) pVect1;
+    auto code = (const uint8_t *) pVect2;
+    return ip ? 1.0f - faiss::fvec_inner_product_sq8(x, code, p->vmin, p->step, p->dim)
+              : faiss::fvec_L2sqr_sq8(x, code, p->vmin, p->step, p->dim);
+}
+
+template <bool ip>
+static float
+DistanceFP16(const void *pVect1, const void *pVect2, const void *param) {
+    auto dim = ((const CodeDistParam *) param)->dim;
+    auto x = (const float *) pVect1;
+    auto code = (const uint16_t *) pVect2;
+    return ip ? 1.0f - faiss::fvec_inner_product_fp16(x, code, dim) : faiss::fvec_L2sqr_fp16(x, code, dim);
+}
+
+}  // namespace hnswlib
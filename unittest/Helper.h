@@ -10,16 +10,21 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "knowhere/index/IndexType.h"
 #include "knowhere/index/vector_index/IndexIVF.h"
 #include "knowhere/index/vector_index/IndexIVFHNSW.h"
 #include "knowhere/index/vector_index/IndexIVFPQ.h"
+#include "knowhere/index/vector_index/IndexIVFPQFastScan.h"
 #include "knowhere/index/vector_index/IndexIVFSQ.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
 #include "knowhere/index/vector_offset_index/IndexIVF_NM.h"
+#include "knowhere/utils/BitsetView.h"
 
 #ifdef KNOWHERE_GPU_VERSION
 #include "knowhere/index/vector_index/gpu/IndexGPUIVF.h"
@@ -45,6 +50,8 @@ IndexFactory(const milvus::knowhere::IndexType& type, const milvus::knowhere::In
             return std::make_shared<milvus::knowhere::IVF>();
         } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQ) {
             return std::make_shared<milvus::knowhere::IVFPQ>();
+        } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQFASTSCAN) {
+            return std::make_shared<milvus::knowhere::IVFPQFastScan>();
         } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8) {
             return std::make_shared<milvus::knowhere::IVFSQ>();
         } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFHNSW) {
@@ -84,6 +91,34 @@ IndexFactoryNM(const milvus::knowhere::IndexType& type, const milvus::knowhere::
     return nullptr;
 }
 
+// recall@k of ids, the results of querying the first nq base vectors under bitset, against the exact L2
+// top-k among the entries the bitset keeps. Filtered-out and missing results count as misses.
+inline float
+FilteredBaseRecall(const float* xb, int64_t nb, int64_t dim, const int64_t* ids, int64_t nq, int64_t k,
+                   const faiss::BitsetView bitset) {
+    int64_t hits = 0;
+    for (int64_t i = 0; i < nq; ++i) {
+        std::vector<std::pair<float, int64_t>> dis;
+        for (int64_t j = 0; j < nb; ++j) {
+            if (bitset.test(j)) {
+                continue;
+            }
+            float d = 0;
+            for (int64_t c = 0; c < dim; ++c) {
+                d += (xb[i * dim + c] - xb[j * dim + c]) * (xb[i * dim + c] - xb[j * dim + c]);
+            }
+            dis.emplace_back(d, j);
+        }
+        std::partial_sort(dis.begin(), dis.begin() + k, dis.end());
+        for (int64_t r = 0; r < k; ++r) {
+            for (int64_t t = 0; t < k; ++t) {
+                hits += (ids[i * k + r] == dis[t].second);
+            }
+        }
+    }
+    return static_cast<float>(hits) / (nq * k);
+}
+
 class ParamGenerator {
  public:
     static ParamGenerator&
@@ -116,6 +151,19 @@ class ParamGenerator {
                 {milvus::knowhere::INDEX_FILE_SLICE_SIZE_IN_MEGABYTE, 4},
                 {milvus::knowhere::meta::DEVICEID, DEVICEID},
             };
+        } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQFASTSCAN) {
+            return milvus::knowhere::Config{
+                {milvus::knowhere::meta::DIM, DIM},
+                {milvus::knowhere::meta::TOPK, K},
+                {milvus::knowhere::IndexParams::nlist, 100},
+                {milvus::knowhere::IndexParams::nprobe, 4},
+                {milvus::knowhere::IndexParams::m, 32},
+                {milvus::knowhere::IndexParams::nbits, 4},
+                {milvus::knowhere::IndexParams::refine_k, 4},
+                {milvus::knowhere::Metric::TYPE, milvus::knowhere::Metric::L2},
+                {milvus::knowhere::INDEX_FILE_SLICE_SIZE_IN_MEGABYTE, 4},
+                {milvus::knowhere::meta::DEVICEID, DEVICEID},
+            };
         } else if (type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8 ||
                    type == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8H) {
             return milvus::knowhere::Config{
@@ -40,6 +40,11 @@ class AnnoyTest : public DataGen, public TestWithParam<std::string> {
         };
     }
 
+    void
+    TearDown() override {
+        RemoveTempFiles();
+    }
+
  protected:
     milvus::knowhere::Config conf;
     std::shared_ptr<milvus::knowhere::IndexAnnoy> index_ = nullptr;
@@ -204,6 +209,24 @@ TEST_P(AnnoyTest, annoy_serialize) {
     }
 }
 
+TEST_P(AnnoyTest, annoy_mmap) {
+    index_->BuildAll(base_dataset, conf);
+    auto binaryset = index_->Serialize(milvus::knowhere::Config());
+
+    std::string filename = TempFile("annoy_test_mmap");
+    milvus::knowhere::WriteBinarySet(filename, binaryset);
+    auto mapped_set = milvus::knowhere::MapBinarySet(filename);
+    ASSERT_TRUE(mapped_set.GetByName("annoy_index_data")->mapped);
+
+    auto new_index = std::make_shared<milvus::knowhere::IndexAnnoy>();
+    new_index->Load(mapped_set);
+    mapped_set.clear();
+    ASSERT_EQ(new_index->Count(), nb);
+    ASSERT_EQ(new_index->Dim(), dim);
+    auto result = new_index->Query(query_dataset, conf, nullptr);
+    AssertAnns(result, nq, conf[milvus::knowhere::meta::TOPK]);
+}
+
 TEST_P(AnnoyTest, annoy_slice) {
     {
         // serialize index
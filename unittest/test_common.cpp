@@ -13,6 +13,8 @@
 #include "knowhere/common/Dataset.h"
 #include "knowhere/common/Timer.h"
 #include "knowhere/common/Exception.h"
+#include "knowhere/common/Utils.h"
+#include "knowhere/index/vector_index/helpers/FaissIO.h"
 #include "knowhere/utils/BitsetView.h"
 #include "unittest/utils.h"
 #include <boost/dynamic_bitset.hpp>
@@ -67,3 +69,40 @@ TEST(COMMON_TEST, BitsetView) {
     }
     ASSERT_EQ(boo_bitset.count(), N / 3);
 }
+
+TEST(COMMON_TEST, slice_io_writer) {
+    std::vector<uint8_t> data(2500);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    milvus::knowhere::BinarySet binary_set;
+    milvus::json meta_info;
+    {
+        milvus::knowhere::SliceIOWriter writer("big", 1000, binary_set.AppendSink());
+        writer.write(data.data(), 300);
+        writer.write(data.data() + 300, 2200);
+        writer.Close(meta_info);
+    }
+    {
+        // exactly one full slice stays unsliced, like Disassemble() does
+        milvus::knowhere::SliceIOWriter writer("small", 1000, binary_set.AppendSink());
+        writer.write(data.data(), 1000);
+        writer.Close(meta_info);
+    }
+    milvus::knowhere::EmitSliceMeta(meta_info, binary_set.AppendSink());
+
+    ASSERT_TRUE(binary_set.Contains("big_0"));
+    ASSERT_TRUE(binary_set.Contains("big_2"));
+    ASSERT_FALSE(binary_set.Contains("big_3"));
+    ASSERT_EQ(binary_set.GetByName("big_2")->size, 500);
+    ASSERT_FALSE(binary_set.Contains("small_0"));
+
+    milvus::knowhere::Assemble(binary_set);
+    auto big = binary_set.GetByName("big");
+    ASSERT_EQ(big->size, 2500);
+    ASSERT_EQ(memcmp(big->data.get(), data.data(), data.size()), 0);
+    auto small = binary_set.GetByName("small");
+    ASSERT_EQ(small->size, 1000);
+    ASSERT_EQ(memcmp(small->data.get(), data.data(), small->size), 0);
+}
@@ -11,11 +11,22 @@
 
 #include <gtest/gtest.h>
 #include "knowhere/common/Config.h"
+#include "knowhere/index/vector_index/ConfAdapterMgr.h"
 #include "knowhere/index/vector_index/IndexHNSW.h"
+#include "knowhere/index/vector_index/IndexReplicated.h"
 #include "knowhere/index/vector_index/helpers/IndexParameter.h"
+#include "knowhere/index/vector_offset_index/IndexHNSW_NM.h"
+#include "knowhere/utils/distances_simd.h"
+#include "knowhere/utils/distances_simd_avx.h"
+#include "knowhere/utils/distances_simd_avx512.h"
+#include <algorithm>
 #include <iostream>
+#include <numeric>
+#include <omp.h>
 #include <random>
+#include "knowhere/archive/KnowhereConfig.h"
 #include "knowhere/common/Exception.h"
+#include "unittest/Helper.h"
 #include "unittest/utils.h"
 
 using ::testing::Combine;
@@ -37,7 +48,37 @@ class HNSWTest : public DataGen, public TestWithParam<std::string> {
         };
     }
 
+    void
+    TearDown() override {
+        RemoveTempFiles();
+    }
+
+    // recall@k of the result of querying the first n base vectors, against brute force
+    float
+    BaseRecall(const milvus::knowhere::DatasetPtr& result, int64_t n) {
+        auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        int64_t hits = 0;
+        for (int64_t i = 0; i < n; ++i) {
+            std::vector<std::pair<float, int64_t>> dis(nb);
+            for (int64_t j = 0; j < nb; ++j) {
+                float d = 0;
+                for (int64_t c = 0; c < dim; ++c) {
+                    d += (xb[i * dim + c] - xb[j * dim + c]) * (xb[i * dim + c] - xb[j * dim + c]);
+                }
+                dis[j] = {d, j};
+            }
+            std::partial_sort(dis.begin(), dis.begin() + k, dis.end());
+            for (int64_t r = 0; r < k; ++r) {
+                for (int64_t t = 0; t < k; ++t) {
+                    hits += (ids[i * k + r] == dis[t].second);
+                }
+            }
+        }
+        return static_cast<float>(hits) / (n * k);
+    }
+
  protected:
+    const int64_t nq_recall = 100;
     milvus::knowhere::Config conf;
     std::shared_ptr<milvus::knowhere::IndexHNSW> index_ = nullptr;
     std::string IndexType;
@@ -148,6 +189,587 @@ TEST_P(HNSWTest, HNSW_delete) {
     */
 }
 
+TEST_P(HNSWTest, HNSW_filtered) {
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+
+    // ef * 2M = 512 entries left or fewer are scanned
+    auto search_conf = conf;
+    search_conf[milvus::knowhere::IndexParams::ef] = 16;
+    auto queries = milvus::knowhere::GenDataset(nq_recall, dim, xb.data());
+    std::mt19937 rng(42);
+    for (double ratio : {0.3, 0.8, 0.92, 0.98}) {
+        auto bitset = std::make_shared<faiss::ConcurrentBitset>(nb);
+        for (int64_t i = 0; i < nb; ++i) {
+            if (std::uniform_real_distribution<double>(0, 1)(rng) < ratio) {
+                bitset->set(i);
+            }
+        }
+
+        auto result = index_->Query(queries, search_conf, bitset);
+        auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        for (int64_t i = 0; i < nq_recall * k; ++i) {
+            ASSERT_TRUE(ids[i] >= 0 && !bitset->test(ids[i]));
+        }
+        auto recall = FilteredBaseRecall(xb.data(), nb, dim, ids, nq_recall, k, bitset);
+        std::cout << "filtered " << ratio << " recall " << recall << std::endl;
+        ASSERT_GE(recall, ratio < 0.95 ? 0.9 : 1.0);
+    }
+}
+
+TEST_P(HNSWTest, HNSW_query_into) {
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+    auto result = index_->Query(query_dataset, conf, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto distances = result->Get<float*>(milvus::knowhere::meta::DISTANCE);
+
+    std::vector<int64_t> buf_ids(nq * k);
+    std::vector<float> buf_distances(nq * k);
+    index_->QueryInto(xq.data(), nq, k, buf_distances.data(), buf_ids.data(), conf, nullptr);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_EQ(buf_ids[i], ids[i]);
+        ASSERT_EQ(buf_distances[i], distances[i]);
+    }
+}
+
+TEST_P(HNSWTest, HNSW_intra_query) {
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+
+    // nq below intra_query_threads: each query's base-layer expansion runs in parallel rounds
+    auto intra_conf = conf;
+    intra_conf[milvus::knowhere::IndexParams::intra_query_threads] = 16;
+    auto result = index_->Query(query_dataset, intra_conf, nullptr);
+    AssertAnns(result, nq, k);
+
+    // the rounds are merged serially, the result does not depend on the team size
+    auto max_threads = omp_get_max_threads();
+    for (int threads : {1, 4}) {
+        omp_set_num_threads(threads);
+        auto team_result = index_->Query(query_dataset, intra_conf, nullptr);
+        for (int64_t i = 0; i < nq * k; ++i) {
+            ASSERT_EQ(team_result->Get<int64_t*>(milvus::knowhere::meta::IDS)[i],
+                      result->Get<int64_t*>(milvus::knowhere::meta::IDS)[i]);
+        }
+    }
+    omp_set_num_threads(max_threads);
+
+    auto bitset = std::make_shared<faiss::ConcurrentBitset>(nb);
+    for (int64_t i = 0; i < nq; ++i) {
+        bitset->set(i);
+    }
+    auto result_bs = index_->Query(query_dataset, intra_conf, bitset);
+    AssertAnns(result_bs, nq, k, CheckMode::CHECK_NOT_EQUAL);
+
+    auto adapter = milvus::knowhere::AdapterMgr::GetInstance().GetAdapter(index_->index_type());
+    ASSERT_TRUE(adapter->CheckSearch(intra_conf, index_->index_type(), index_->index_mode()));
+    intra_conf[milvus::knowhere::IndexParams::intra_query_threads] = 0;
+    ASSERT_FALSE(adapter->CheckSearch(intra_conf, index_->index_type(), index_->index_mode()));
+}
+
+TEST_P(HNSWTest, HNSW_reorder) {
+    auto reorder_conf = conf;
+    reorder_conf[milvus::knowhere::IndexParams::reorder] = true;
+    index_->Train(base_dataset, reorder_conf);
+    index_->AddWithoutIds(base_dataset, reorder_conf);
+
+    auto result = index_->Query(query_dataset, conf, nullptr);
+    AssertAnns(result, nq, k);
+
+    faiss::ConcurrentBitsetPtr bitset = std::make_shared<faiss::ConcurrentBitset>(nb);
+    for (auto i = 0; i < nq; ++i) {
+        bitset->set(i);
+    }
+    auto result_bs = index_->Query(query_dataset, conf, bitset);
+    AssertAnns(result_bs, nq, k, CheckMode::CHECK_NOT_EQUAL);
+
+    // the permutation is persisted
+    auto bs = index_->Serialize(conf);
+    auto new_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+    new_index->Load(bs);
+    auto new_result = new_index->Query(query_dataset, conf, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto new_ids = new_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_EQ(new_ids[i], ids[i]);
+    }
+
+    // reordering a loaded index again keeps the labels
+    new_index->Reorder();
+    AssertAnns(new_index->Query(query_dataset, conf, nullptr), nq, k);
+}
+
+TEST_P(HNSWTest, HNSW_batch_build) {
+    auto recall = [&](const milvus::knowhere::DatasetPtr& result) { return BaseRecall(result, nq_recall); };
+    auto queries = milvus::knowhere::GenDataset(nq_recall, dim, xb.data());
+    auto search_conf = conf;
+    search_conf[milvus::knowhere::IndexParams::ef] = 32;
+
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+    auto expect = recall(index_->Query(queries, search_conf, nullptr));
+
+    auto batch_conf = conf;
+    batch_conf[milvus::knowhere::IndexParams::batch_build] = true;
+    auto batch_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+    batch_index->Train(base_dataset, batch_conf);
+    batch_index->AddWithoutIds(base_dataset, batch_conf);
+    EXPECT_EQ(batch_index->Count(), nb);
+    AssertAnns(batch_index->Query(query_dataset, conf, nullptr), nq, k);
+    auto result = recall(batch_index->Query(queries, search_conf, nullptr));
+    std::cout << "recall " << expect << " batch build recall " << result << std::endl;
+    ASSERT_GE(result, expect - 0.02);
+}
+
+TEST_P(HNSWTest, HNSW_remove_and_add) {
+    auto self_hits = [&](const milvus::knowhere::DatasetPtr& result, int64_t n, int64_t first_id) {
+        auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        int64_t hits = 0;
+        for (int64_t i = 0; i < n; ++i) {
+            hits += (ids[i * k] == first_id + i);
+        }
+        return hits;
+    };
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+
+    // the queries are the first nq base vectors, they no longer find themselves
+    std::vector<int64_t> removed(nq);
+    std::iota(removed.begin(), removed.end(), 0);
+    ASSERT_EQ(index_->Remove(removed.data(), nq), nq);
+    ASSERT_EQ(index_->Remove(removed.data(), nq), 0);
+    ASSERT_EQ(index_->Count(), nb - nq);
+    AssertAnns(index_->Query(query_dataset, conf, nullptr), nq, k, CheckMode::CHECK_NOT_EQUAL);
+
+    // the remaining entries keep their ids and stay reachable
+    auto rest = milvus::knowhere::GenDataset(nq_recall, dim, xb.data() + nq * dim);
+    ASSERT_GE(self_hits(index_->Query(rest, conf, nullptr), nq_recall, nq), nq_recall - 1);
+
+    // added back to a loaded index under new ids, in the freed slots and then beyond its capacity
+    auto new_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+    new_index->Load(index_->Serialize(conf));
+    new_index->SetUids(index_->GetUids());
+    std::vector<int64_t> uids(2 * nq);
+    std::iota(uids.begin(), uids.end(), nb);
+    new_index->Add(query_dataset, uids.data(), conf);
+    ASSERT_EQ(new_index->Count(), nb);
+    ASSERT_EQ(self_hits(new_index->Query(query_dataset, conf, nullptr), nq, nb), nq);
+    std::vector<float> extra(nq * dim);
+    for (auto& x : extra) {
+        x = drand48();
+    }
+    auto extra_dataset = milvus::knowhere::GenDataset(nq, dim, extra.data());
+    new_index->Add(extra_dataset, uids.data() + nq, conf);
+    ASSERT_EQ(new_index->Count(), nb + nq);
+    ASSERT_EQ(self_hits(new_index->Query(extra_dataset, conf, nullptr), nq, nb + nq), nq);
+    ASSERT_GE(self_hits(new_index->Query(rest, conf, nullptr), nq_recall, nq), nq_recall - 1);
+
+    // emptied, then filled again
+    auto all_uids = *new_index->GetUids();
+    ASSERT_EQ(new_index->Remove(all_uids.data(), all_uids.size()), nb + nq);
+    ASSERT_EQ(new_index->Count(), 0);
+    new_index->Add(query_dataset, uids.data(), conf);
+    ASSERT_EQ(self_hits(new_index->Query(query_dataset, conf, nullptr), nq, nb), nq);
+
+    // level0 referenced in place can't grow, removing from it copies it out
+    std::string filename = TempFile("hnsw_test_remove");
+    milvus::knowhere::WriteBinarySet(filename, index_->Serialize(conf));
+    auto mapped_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+    mapped_index->Load(milvus::knowhere::MapBinarySet(filename));
+    mapped_index->SetUids(index_->GetUids());
+    ASSERT_ANY_THROW(mapped_index->AddWithoutIds(query_dataset, conf));
+    std::vector<int64_t> rest_uids(nq_recall / 2);
+    std::iota(rest_uids.begin(), rest_uids.end(), nq);
+    ASSERT_EQ(mapped_index->Remove(rest_uids.data(), rest_uids.size()), nq_recall / 2);
+    ASSERT_EQ(mapped_index->Count(), nb - nq - nq_recall / 2);
+    auto kept = milvus::knowhere::GenDataset(nq_recall / 2, dim, xb.data() + (nq + nq_recall / 2) * dim);
+    ASSERT_GE(self_hits(mapped_index->Query(kept, conf, nullptr), nq_recall / 2, nq + nq_recall / 2),
+              nq_recall / 2 - 1);
+
+    // later removals compact the copied level0 in place, and end up where an unmapped index does
+    auto loaded_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+    loaded_index->Load(index_->Serialize(conf));
+    loaded_index->SetUids(index_->GetUids());
+    ASSERT_EQ(loaded_index->Remove(rest_uids.data(), rest_uids.size()), nq_recall / 2);
+    int64_t count = mapped_index->Count();
+    for (int64_t round = 0; round < 4; ++round) {
+        std::vector<int64_t> round_uids;
+        for (int64_t id = nq + nq_recall + round; id < nb; id += 8) {
+            round_uids.push_back(id);
+        }
+        ASSERT_EQ(mapped_index->Remove(round_uids.data(), round_uids.size()), round_uids.size());
+        ASSERT_EQ(loaded_index->Remove(round_uids.data(), round_uids.size()), round_uids.size());
+        count -= round_uids.size();
+        ASSERT_EQ(mapped_index->Count(), count);
+
+        auto mapped_result = mapped_index->Query(query_dataset, conf, nullptr);
+        auto loaded_result = loaded_index->Query(query_dataset, conf, nullptr);
+        auto mapped_ids = mapped_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        auto loaded_ids = loaded_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        for (int64_t i = 0; i < nq * k; ++i) {
+            ASSERT_EQ(mapped_ids[i], loaded_ids[i]);
+        }
+        ASSERT_GE(self_hits(mapped_index->Query(kept, conf, nullptr), nq_recall / 2, nq + nq_recall / 2),
+                  nq_recall / 2 - 1);
+    }
+
+    // a level0 of codes takes no more points, whatever its capacity
+    auto sq_conf = conf;
+    sq_conf[milvus::knowhere::IndexParams::quantizer_type] = milvus::knowhere::SQType::QT_8BIT;
+    auto sq_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+    sq_index->Train(base_dataset, sq_conf);
+    sq_index->AddWithoutIds(milvus::knowhere::GenDataset(nb / 2, dim, xb.data()), sq_conf);
+    ASSERT_ANY_THROW(sq_index->AddWithoutIds(query_dataset, conf));
+    ASSERT_EQ(sq_index->Count(), nb / 2);
+}
+
+TEST_P(HNSWTest, HNSW_payload_placement) {
+    // level0 of this index is ~5MB, above the 2MB threshold
+    milvus::engine::KnowhereConfig::SetPayloadMemory(milvus::engine::KnowhereConfig::HugePageType::TRANSPARENT, 0);
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+    milvus::engine::KnowhereConfig::SetPayloadMemory(milvus::engine::KnowhereConfig::HugePageType::NONE);
+
+    auto result = index_->Query(query_dataset, conf, nullptr);
+    AssertAnns(result, nq, k);
+
+    auto placement = index_->GetPayloadPlacement();
+    std::cout << "payload placement: " << placement.to_string() << std::endl;
+    ASSERT_GT(placement.bytes, nb * dim * sizeof(float));
+    ASSERT_LE(placement.huge_page_bytes, placement.bytes);
+    ASSERT_FALSE(placement.node_pages.empty());
+
+    // the placed payload is released through the same allocator
+    index_ = nullptr;
+}
+
+TEST_P(HNSWTest, HNSW_replicated) {
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+    auto result = index_->Query(query_dataset, conf, nullptr);
+    auto bs = index_->Serialize(conf);
+
+    // two replicas of the same node, exercises the per-replica load and the dispatch
+    auto node = milvus::knowhere::ReplicatedIndex::CurrentNode();
+    auto replicated = std::make_shared<milvus::knowhere::ReplicatedIndex>(milvus::knowhere::IndexEnum::INDEX_HNSW,
+                                                                          std::vector<int64_t>{node, node});
+    ASSERT_ANY_THROW(replicated->Query(query_dataset, conf, nullptr));
+    replicated->Load(bs);
+    ASSERT_EQ(replicated->Count(), nb);
+    ASSERT_EQ(replicated->Dim(), dim);
+    ASSERT_NE(replicated->Replica(node), nullptr);
+
+    auto replicated_result = replicated->Query(query_dataset, conf, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto replicated_ids = replicated_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_EQ(replicated_ids[i], ids[i]);
+    }
+
+    auto placement = replicated->GetPayloadPlacement();
+    ASSERT_EQ(placement.bytes, 2 * index_->GetPayloadPlacement().bytes);
+    ASSERT_THROW(replicated->AddWithoutIds(base_dataset, conf), milvus::knowhere::KnowhereException);
+}
+
+TEST_P(HNSWTest, HNSW_query_with_context) {
+    milvus::knowhere::VecIndexPtr vec_index = index_;
+    vec_index->Train(base_dataset, conf);
+    vec_index->AddWithoutIds(base_dataset, conf);
+
+    std::vector<int64_t> ids(nq * k), ctx_ids(nq * k);
+    std::vector<float> distances(nq * k), ctx_distances(nq * k);
+    vec_index->QueryInto(xq.data(), nq, k, distances.data(), ids.data(), conf, nullptr);
+
+    // the second round runs on the buffers kept in the context by the first one
+    milvus::knowhere::SearchContext ctx;
+    for (int round = 0; round < 2; ++round) {
+        vec_index->QueryWithContext(xq.data(), nq, k, ctx_distances.data(), ctx_ids.data(), conf, nullptr, ctx);
+        for (int64_t i = 0; i < nq * k; ++i) {
+            ASSERT_EQ(ctx_ids[i], ids[i]);
+            ASSERT_EQ(ctx_distances[i], distances[i]);
+        }
+    }
+    ASSERT_EQ(ctx.Size(), 1);
+
+    // the slots of a destroyed index are dropped on the next use of the context
+    auto other = std::make_shared<milvus::knowhere::IndexHNSW>();
+    other->Train(base_dataset, conf);
+    other->AddWithoutIds(base_dataset, conf);
+    other->QueryWithContext(xq.data(), nq, k, ctx_distances.data(), ctx_ids.data(), conf, nullptr, ctx);
+    ASSERT_EQ(ctx.Size(), 2);
+    other.reset();
+    vec_index->QueryWithContext(xq.data(), nq, k, ctx_distances.data(), ctx_ids.data(), conf, nullptr, ctx);
+    ASSERT_EQ(ctx.Size(), 1);
+}
+
+TEST_P(HNSWTest, HNSW_query_async) {
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+    auto result = index_->Query(query_dataset, conf, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+
+    milvus::engine::KnowhereConfig::SetQueryThreadPoolSize(2);
+    ASSERT_EQ(milvus::knowhere::ThreadPool::GetGlobalThreadPool()->Size(), 2);
+
+    std::vector<std::future<milvus::knowhere::DatasetPtr>> futures;
+    for (int i = 0; i < 8; ++i) {
+        futures.push_back(index_->QueryAsync(query_dataset, conf, nullptr));
+    }
+    for (auto& future : futures) {
+        auto async_result = future.get();
+        auto async_ids = async_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        for (int64_t i = 0; i < nq * k; ++i) {
+            ASSERT_EQ(async_ids[i], ids[i]);
+        }
+    }
+
+    std::promise<bool> done;
+    index_->QueryAsync(query_dataset, conf, nullptr,
+                       [&](const milvus::knowhere::DatasetPtr& async_result, std::exception_ptr error) {
+                           done.set_value(error == nullptr && async_result != nullptr);
+                       });
+    ASSERT_TRUE(done.get_future().get());
+
+    // a throwing callback is logged, the pool goes on
+    std::promise<void> thrown;
+    index_->QueryAsync(query_dataset, conf, nullptr,
+                       [&](const milvus::knowhere::DatasetPtr&, std::exception_ptr) {
+                           thrown.set_value();
+                           throw std::runtime_error("callback failed");
+                       });
+    thrown.get_future().get();
+    ASSERT_NE(index_->QueryAsync(query_dataset, conf, nullptr).get(), nullptr);
+
+    // errors reach the future
+    auto empty_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+    auto failed = empty_index->QueryAsync(query_dataset, conf, nullptr);
+    ASSERT_ANY_THROW(failed.get());
+
+    // every task starts with OpenMP limited to its thread, and can't replace the pool it runs on
+    auto pool = milvus::knowhere::ThreadPool::GetGlobalThreadPool();
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(pool->Push([]() {
+                          auto max_threads = omp_get_max_threads();
+                          omp_set_num_threads(4);
+                          return max_threads;
+                      })
+                      .get(),
+                  1);
+    }
+    auto replace = pool->Push([]() { milvus::engine::KnowhereConfig::SetQueryThreadPoolSize(4); });
+    ASSERT_ANY_THROW(replace.get());
+    ASSERT_EQ(milvus::knowhere::ThreadPool::GetGlobalThreadPool(), pool);
+}
+
+TEST_P(HNSWTest, HNSW_dataset_view) {
+    milvus::knowhere::VecIndexPtr vec_index = index_;
+    vec_index->BuildAll(milvus::knowhere::DatasetView(nb, dim, xb.data()), conf);
+    EXPECT_EQ(vec_index->Count(), nb);
+
+    auto result = vec_index->Query(query_dataset, conf, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto distances = result->Get<float*>(milvus::knowhere::meta::DISTANCE);
+
+    milvus::knowhere::DatasetView query(nq, dim, xq.data());
+    auto view_result = vec_index->Query(query, conf, nullptr);
+    AssertAnns(view_result, nq, k);
+
+    std::vector<int64_t> buf_ids(nq * k);
+    std::vector<float> buf_distances(nq * k);
+    vec_index->Query(query, milvus::knowhere::DatasetView(nq, k, nullptr, buf_ids.data(), buf_distances.data()), conf,
+                     nullptr);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_EQ(buf_ids[i], ids[i]);
+        ASSERT_EQ(buf_distances[i], distances[i]);
+    }
+
+    // the overloads are reachable on the concrete index too, and reject views of another dim
+    auto direct_result = index_->Query(query, conf, nullptr);
+    AssertAnns(direct_result, nq, k);
+    milvus::knowhere::DatasetView narrow_query(nq, dim - 1, xq.data());
+    ASSERT_ANY_THROW(index_->Query(narrow_query, conf, nullptr));
+    ASSERT_ANY_THROW(index_->Query(narrow_query,
+                                   milvus::knowhere::DatasetView(nq, k, nullptr, buf_ids.data(), buf_distances.data()),
+                                   conf, nullptr));
+    ASSERT_ANY_THROW(index_->AddWithoutIds(milvus::knowhere::DatasetView(nb, dim - 1, xb.data()), conf));
+}
+
+TEST_P(HNSWTest, HNSW_mmap) {
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+    auto binaryset = index_->Serialize(milvus::knowhere::Config());
+
+    std::string filename = TempFile("hnsw_test_mmap");
+    milvus::knowhere::WriteBinarySet(filename, binaryset);
+    auto mapped_set = milvus::knowhere::MapBinarySet(filename);
+    ASSERT_TRUE(mapped_set.GetByName("HNSW")->mapped);
+
+    auto new_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+    new_index->Load(mapped_set);
+    mapped_set.clear();
+    EXPECT_EQ(new_index->Count(), nb);
+    EXPECT_EQ(new_index->Dim(), dim);
+    auto result = new_index->Query(query_dataset, conf, nullptr);
+    AssertAnns(result, nq, k);
+
+    // level0 is read-only once referenced in place
+    ASSERT_ANY_THROW(new_index->AddWithoutIds(base_dataset, conf));
+}
+
+TEST_P(HNSWTest, HNSW_quantized_level0) {
+    auto queries = milvus::knowhere::GenDataset(nq_recall, dim, xb.data());
+    auto search_conf = conf;
+    search_conf[milvus::knowhere::IndexParams::ef] = 32;
+
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+    auto expect = BaseRecall(index_->Query(queries, search_conf, nullptr), nq_recall);
+    auto float_size = index_->GetPayloadPlacement().bytes;
+
+    for (auto quantizer_type : {milvus::knowhere::SQType::QT_8BIT, milvus::knowhere::SQType::QT_FP16}) {
+        auto sq_conf = conf;
+        sq_conf[milvus::knowhere::IndexParams::quantizer_type] = quantizer_type;
+        auto sq_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+        sq_index->Train(base_dataset, sq_conf);
+        sq_index->AddWithoutIds(base_dataset, sq_conf);
+        EXPECT_EQ(sq_index->Count(), nb);
+        EXPECT_EQ(sq_index->Dim(), dim);
+        EXPECT_LT(sq_index->GetPayloadPlacement().bytes, float_size);
+        auto result = BaseRecall(sq_index->Query(queries, search_conf, nullptr), nq_recall);
+        std::cout << quantizer_type << " recall " << result << " float recall " << expect << std::endl;
+        ASSERT_GE(result, expect - 0.02);
+
+        // distances come from the re-rank on the full vectors
+        auto sq_result = sq_index->Query(query_dataset, conf, nullptr);
+        auto ref_result = index_->Query(query_dataset, conf, nullptr);
+        auto sq_dis = sq_result->Get<float*>(milvus::knowhere::meta::DISTANCE);
+        auto sq_ids = sq_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        auto ref_dis = ref_result->Get<float*>(milvus::knowhere::meta::DISTANCE);
+        auto ref_ids = ref_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        for (int64_t i = 0; i < nq * k; ++i) {
+            if (sq_ids[i] == ref_ids[i]) {
+                ASSERT_EQ(sq_dis[i], ref_dis[i]);
+            }
+        }
+        ASSERT_ANY_THROW(sq_index->AddWithoutIds(base_dataset, conf));
+
+        // the codec and full vectors travel in their own binary, referenced in place when mapped
+        auto binaryset = sq_index->Serialize(milvus::knowhere::Config());
+        ASSERT_TRUE(binaryset.Contains(HNSW_RAW_DATA));
+        std::string filename = TempFile("hnsw_test_quantized");
+        milvus::knowhere::WriteBinarySet(filename, binaryset);
+        auto mapped_set = milvus::knowhere::MapBinarySet(filename);
+        auto new_index = std::make_shared<milvus::knowhere::IndexHNSW>();
+        new_index->Load(mapped_set);
+        mapped_set.clear();
+        auto new_result = new_index->Query(query_dataset, conf, nullptr);
+        auto new_dis = new_result->Get<float*>(milvus::knowhere::meta::DISTANCE);
+        auto new_ids = new_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        for (int64_t i = 0; i < nq * k; ++i) {
+            ASSERT_EQ(new_ids[i], sq_ids[i]);
+            ASSERT_EQ(new_dis[i], sq_dis[i]);
+        }
+
+        // the raw vectors follow the renumbering
+        new_index->Reorder();
+        auto reordered = new_index->Query(query_dataset, conf, nullptr);
+        auto reordered_ids = reordered->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        for (int64_t i = 0; i < nq * k; ++i) {
+            ASSERT_EQ(reordered_ids[i], sq_ids[i]);
+        }
+
+        // level0 without its codec is refused
+        binaryset.Erase(HNSW_RAW_DATA);
+        ASSERT_ANY_THROW(new_index->Load(binaryset));
+    }
+}
+
+TEST(HNSWLevel0Test, code_distance_kernels) {
+    using Sq8Kernels = std::pair<faiss::fvec_sq8_func_ptr, faiss::fvec_sq8_func_ptr>;
+    using Fp16Kernels = std::pair<faiss::fvec_fp16_func_ptr, faiss::fvec_fp16_func_ptr>;
+    std::vector<std::pair<Sq8Kernels, Fp16Kernels>> kernels;
+    if (faiss::cpu_support_avx2()) {
+        kernels.push_back({{faiss::fvec_L2sqr_sq8_avx, faiss::fvec_inner_product_sq8_avx},
+                           {faiss::fvec_L2sqr_fp16_avx, faiss::fvec_inner_product_fp16_avx}});
+    }
+    if (faiss::cpu_support_avx512()) {
+        kernels.push_back({{faiss::fvec_L2sqr_sq8_avx512, faiss::fvec_inner_product_sq8_avx512},
+                           {faiss::fvec_L2sqr_fp16_avx512, faiss::fvec_inner_product_fp16_avx512}});
+    }
+    // multiples of 16 or 8 only, and dimensions with a tail
+    for (size_t d : {128, 24, 20, 7}) {
+        std::vector<float> x(d), vmin(d), step(d);
+        std::vector<uint8_t> sq8(d);
+        std::vector<uint16_t> fp16(d);
+        for (size_t i = 0; i < d; ++i) {
+            x[i] = drand48() * 2 - 1;
+            vmin[i] = drand48() - 1;
+            step[i] = drand48() / 128;
+            sq8[i] = lrand48() & 0xff;
+            fp16[i] = hnswlib::float_to_fp16(drand48() * 2 - 1);
+        }
+        auto sq8_l2 = faiss::fvec_L2sqr_sq8_ref(x.data(), sq8.data(), vmin.data(), step.data(), d);
+        auto sq8_ip = faiss::fvec_inner_product_sq8_ref(x.data(), sq8.data(), vmin.data(), step.data(), d);
+        auto fp16_l2 = faiss::fvec_L2sqr_fp16_ref(x.data(), fp16.data(), d);
+        auto fp16_ip = faiss::fvec_inner_product_fp16_ref(x.data(), fp16.data(), d);
+        for (auto& kernel : kernels) {
+            ASSERT_NEAR(kernel.first.first(x.data(), sq8.data(), vmin.data(), step.data(), d), sq8_l2, 1e-4 * d);
+            ASSERT_NEAR(kernel.first.second(x.data(), sq8.data(), vmin.data(), step.data(), d), sq8_ip, 1e-4 * d);
+            ASSERT_NEAR(kernel.second.first(x.data(), fp16.data(), d), fp16_l2, 1e-4 * d);
+            ASSERT_NEAR(kernel.second.second(x.data(), fp16.data(), d), fp16_ip, 1e-4 * d);
+        }
+    }
+}
+
+TEST_P(HNSWTest, HNSW_NM) {
+    auto nm_index = std::make_shared<milvus::knowhere::IndexHNSW_NM>();
+    nm_index->Train(base_dataset, conf);
+    nm_index->AddWithoutIds(base_dataset, conf);
+    auto expect = nm_index->Query(query_dataset, conf, nullptr);
+    auto expect_ids = expect->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto expect_dis = expect->Get<float*>(milvus::knowhere::meta::DISTANCE);
+    auto check = [&](const milvus::knowhere::DatasetPtr& result) {
+        auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        auto dis = result->Get<float*>(milvus::knowhere::meta::DISTANCE);
+        for (int64_t i = 0; i < nq * k; ++i) {
+            ASSERT_EQ(ids[i], expect_ids[i]);
+            ASSERT_EQ(dis[i], expect_dis[i]);
+        }
+    };
+
+    // the graph only, the vectors come from the caller's RAW_DATA
+    auto binaryset = nm_index->Serialize(conf);
+    ASSERT_LT(binaryset.GetByName("HNSW_NM")->size, nb * dim * sizeof(float));
+    auto new_index = std::make_shared<milvus::knowhere::IndexHNSW_NM>();
+    ASSERT_ANY_THROW(new_index->Load(binaryset));
+    milvus::knowhere::BinaryPtr bptr = std::make_shared<milvus::knowhere::Binary>();
+    bptr->data = std::shared_ptr<uint8_t[]>((uint8_t*)xb.data(), [&](uint8_t*) {});
+    bptr->size = nb * dim * sizeof(float);
+    binaryset.Append(RAW_DATA, bptr);
+    new_index->Load(binaryset);
+    EXPECT_EQ(new_index->Count(), nb);
+    EXPECT_EQ(new_index->Dim(), dim);
+    check(new_index->Query(query_dataset, conf, nullptr));
+    EXPECT_GT(new_index->GetPayloadPlacement().bytes, bptr->size);
+    ASSERT_ANY_THROW(new_index->AddWithoutIds(base_dataset, conf));
+
+    // graph and vectors referenced in place from a mapped file
+    std::string filename = TempFile("hnsw_test_nm");
+    milvus::knowhere::WriteBinarySet(filename, binaryset);
+    auto mapped_set = milvus::knowhere::MapBinarySet(filename);
+    auto mapped_index = std::make_shared<milvus::knowhere::IndexHNSW_NM>();
+    mapped_index->Load(mapped_set);
+    mapped_set.clear();
+    check(mapped_index->Query(query_dataset, conf, nullptr));
+
+    // an HNSW binary holds its vectors
+    auto hnsw_set = nm_index->IndexHNSW::Serialize(conf);
+    hnsw_set.Append("HNSW_NM", hnsw_set.GetByName("HNSW"));
+    hnsw_set.Append(RAW_DATA, bptr);
+    ASSERT_ANY_THROW(milvus::knowhere::IndexHNSW_NM().Load(hnsw_set));
+}
+
 /*
 TEST_P(HNSWTest, HNSW_serialize) {
     auto serialize = [](const std::string& filename, milvus::knowhere::BinaryPtr& bin, uint8_t* ret) {
@@ -15,6 +15,7 @@
 #include <thread>
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
 
+#include "knowhere/archive/KnowhereConfig.h"
 #include "knowhere/common/Exception.h"
 #include "knowhere/index/IndexType.h"
 #include "knowhere/index/vector_index/IndexIDMAP.h"
@@ -447,6 +448,28 @@ TEST_P(IDMAPTest, idmap_dynamic_result_set) {
     }
 }
 
+TEST_P(IDMAPTest, idmap_payload_placement) {
+    milvus::knowhere::Config conf{{milvus::knowhere::meta::DIM, dim},
+                                  {milvus::knowhere::meta::TOPK, k},
+                                  {milvus::knowhere::Metric::TYPE, milvus::knowhere::Metric::L2}};
+
+    // the vectors (~2.5MB) are above the 2MB threshold, so they are mapped 2MB aligned, on add and on load
+    milvus::engine::KnowhereConfig::SetPayloadMemory(milvus::engine::KnowhereConfig::HugePageType::TRANSPARENT);
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+    auto binaryset = index_->Serialize(conf);
+    auto loaded = std::make_shared<milvus::knowhere::IDMAP>();
+    loaded->Load(binaryset);
+    milvus::engine::KnowhereConfig::SetPayloadMemory(milvus::engine::KnowhereConfig::HugePageType::NONE);
+
+    for (auto& index : {index_, loaded}) {
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(index->GetRawVectors()) % (2 * 1024 * 1024), 0);
+        ASSERT_EQ(index->GetPayloadPlacement().bytes, nb * dim * sizeof(float));
+        auto result = index->Query(query_dataset, conf, nullptr);
+        AssertAnns(result, nq, k);
+    }
+}
+
 #ifdef KNOWHERE_GPU_VERSION
 TEST_P(IDMAPTest, idmap_copy) {
     ASSERT_TRUE(!xb.empty());
@@ -11,8 +11,17 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <numeric>
 #include <thread>
 
+#include <faiss/FaissHook.h>
+#include <faiss/IndexHNSW.h>
+#include <faiss/impl/AuxIndexStructures.h>
+#include <faiss/impl/ScalarQuantizerDC.h>
+#include <faiss/impl/ScalarQuantizerDC_avx.h>
+#include <faiss/impl/ScalarQuantizerDC_avx512.h>
+#include <faiss/utils/Heap.h>
+#include <faiss/utils/distances.h>
 #ifdef KNOWHERE_GPU_VERSION
 #include <faiss/gpu/GpuIndexIVFFlat.h>
 #endif
@@ -20,10 +29,13 @@
 #include "knowhere/common/Exception.h"
 #include "knowhere/common/Timer.h"
 #include "knowhere/index/IndexType.h"
+#include "knowhere/index/vector_index/ConfAdapterMgr.h"
 #include "knowhere/index/vector_index/IndexIVF.h"
 #include "knowhere/index/vector_index/IndexIVFPQ.h"
 #include "knowhere/index/vector_index/IndexIVFSQ.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
+#include "knowhere/utils/distances_simd_avx.h"
+#include "knowhere/utils/distances_simd_avx512.h"
 
 #ifdef KNOWHERE_GPU_VERSION
 #include "knowhere/index/vector_index/gpu/IndexGPUIVF.h"
@@ -62,6 +74,7 @@ class IVFTest : public DataGen,
 
     void
     TearDown() override {
+        RemoveTempFiles();
 #ifdef KNOWHERE_GPU_VERSION
         milvus::knowhere::FaissGpuResourceMgr::GetInstance().Free();
 #endif
@@ -84,6 +97,7 @@ INSTANTIATE_TEST_CASE_P(
         std::make_tuple(milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8H, milvus::knowhere::IndexMode::MODE_GPU),
 #endif
         std::make_tuple(milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQ, milvus::knowhere::IndexMode::MODE_CPU),
+        std::make_tuple(milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQFASTSCAN, milvus::knowhere::IndexMode::MODE_CPU),
         std::make_tuple(milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8, milvus::knowhere::IndexMode::MODE_CPU)));
 
 TEST_P(IVFTest, ivf_basic_cpu) {
@@ -223,6 +237,565 @@ TEST_P(IVFTest, ivf_slice) {
     }
 }
 
+TEST_P(IVFTest, ivf_query_into) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+    auto result = index_->Query(query_dataset, conf_, nullptr);
+
+    auto k = conf_[milvus::knowhere::meta::TOPK].get<int64_t>();
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto distances = result->Get<float*>(milvus::knowhere::meta::DISTANCE);
+    std::vector<int64_t> buf_ids(nq * k);
+    std::vector<float> buf_distances(nq * k);
+    // the same buffers are reused by every call
+    for (int i = 0; i < 2; ++i) {
+        index_->QueryInto(xq.data(), nq, k, buf_distances.data(), buf_ids.data(), conf_, nullptr);
+        for (int64_t j = 0; j < nq * k; ++j) {
+            ASSERT_EQ(buf_ids[j], ids[j]);
+            ASSERT_EQ(buf_distances[j], distances[j]);
+        }
+    }
+}
+
+TEST_P(IVFTest, ivf_mmap) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+    auto binaryset = index_->Serialize(milvus::knowhere::Config());
+
+    std::string filename = TempFile("ivf_test_mmap");
+    milvus::knowhere::WriteBinarySet(filename, binaryset);
+    auto mapped_set = milvus::knowhere::MapBinarySet(filename);
+    ASSERT_TRUE(mapped_set.GetByName("IVF")->mapped);
+
+    auto new_index = IndexFactory(index_type_, index_mode_);
+    new_index->Load(mapped_set);
+    mapped_set.clear();
+    EXPECT_EQ(new_index->Count(), nb);
+    EXPECT_EQ(new_index->Dim(), dim);
+
+    // an index referencing the mapping serializes the same bytes back
+    auto bin = binaryset.GetByName("IVF");
+    auto new_bin = new_index->Serialize(milvus::knowhere::Config()).GetByName("IVF");
+    ASSERT_EQ(new_bin->size, bin->size);
+    ASSERT_EQ(memcmp(new_bin->data.get(), bin->data.get(), bin->size), 0);
+
+    auto result = new_index->Query(query_dataset, conf_, nullptr);
+    AssertAnns(result, nq, conf_[milvus::knowhere::meta::TOPK]);
+
+    // the lists are read-only in place
+    std::vector<int64_t> removed{0};
+    ASSERT_ANY_THROW(new_index->Remove(removed.data(), 1));
+    ASSERT_ANY_THROW(new_index->AddWithoutIds(query_dataset, conf_));
+    EXPECT_EQ(new_index->Count(), nb);
+    AssertAnns(new_index->Query(query_dataset, conf_, nullptr), nq, conf_[milvus::knowhere::meta::TOPK]);
+}
+
+TEST_P(IVFTest, ivf_refine) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+    auto binaryset = index_->Serialize(milvus::knowhere::Config());
+    std::shared_ptr<uint8_t[]> raw_data(new uint8_t[nb * dim * sizeof(float)]);
+    memcpy(raw_data.get(), xb.data(), nb * dim * sizeof(float));
+    binaryset.Append(RAW_DATA, raw_data, nb * dim * sizeof(float));
+
+    auto new_index = IndexFactory(index_type_, index_mode_);
+    new_index->Load(binaryset);
+    EXPECT_EQ(new_index->Count(), nb);
+
+    // candidates re-scored against the raw vectors give exact distances
+    auto refine_conf = conf_;
+    refine_conf[milvus::knowhere::IndexParams::refine_k] = 4;
+    auto result = new_index->Query(query_dataset, refine_conf, nullptr);
+    AssertAnns(result, nq, k);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto distances = result->Get<float*>(milvus::knowhere::meta::DISTANCE);
+    for (int64_t i = 0; i < nq; ++i) {
+        for (int64_t j = 0; j < k; ++j) {
+            auto id = ids[i * k + j];
+            ASSERT_GE(id, 0);
+            auto expect = faiss::fvec_L2sqr(xq.data() + i * dim, xb.data() + id * dim, dim);
+            ASSERT_FLOAT_EQ(distances[i * k + j], expect);
+            if (j > 0) {
+                ASSERT_LE(distances[i * k + j - 1], distances[i * k + j]);
+            }
+        }
+    }
+
+    auto adapter = milvus::knowhere::AdapterMgr::GetInstance().GetAdapter(index_type_);
+    ASSERT_TRUE(adapter->CheckSearch(refine_conf, index_type_, index_mode_));
+    auto invalid_conf = refine_conf;
+    invalid_conf[milvus::knowhere::IndexParams::refine_k] = 0;
+    ASSERT_FALSE(adapter->CheckSearch(invalid_conf, index_type_, index_mode_));
+}
+
+TEST_P(IVFTest, ivf_refine_built) {
+    // the fast scan re-scores against its PQ reconstruction without raw vectors
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU ||
+        index_type_ == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQFASTSCAN) {
+        return;
+    }
+
+    // a build configured with refine_k keeps the raw vectors, no RAW_DATA round trip needed
+    auto refine_conf = conf_;
+    refine_conf[milvus::knowhere::IndexParams::refine_k] = 4;
+    index_->Train(base_dataset, refine_conf);
+    index_->AddWithoutIds(base_dataset, refine_conf);
+
+    auto recall = [&](const milvus::knowhere::DatasetPtr& result) {
+        auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        int64_t hits = 0;
+        for (int64_t i = 0; i < nq; ++i) {
+            std::vector<std::pair<float, int64_t>> dis(nb);
+            for (int64_t j = 0; j < nb; ++j) {
+                dis[j] = {faiss::fvec_L2sqr(xq.data() + i * dim, xb.data() + j * dim, dim), j};
+            }
+            std::partial_sort(dis.begin(), dis.begin() + k, dis.end());
+            for (int64_t r = 0; r < k; ++r) {
+                for (int64_t t = 0; t < k; ++t) {
+                    hits += (ids[i * k + r] == dis[t].second);
+                }
+            }
+        }
+        return static_cast<float>(hits) / (nq * k);
+    };
+    // all lists probed, so that only the codes limit the recall
+    auto search_conf = conf_;
+    search_conf[milvus::knowhere::IndexParams::nprobe] = conf_[milvus::knowhere::IndexParams::nlist];
+    refine_conf[milvus::knowhere::IndexParams::nprobe] = conf_[milvus::knowhere::IndexParams::nlist];
+    auto unrefined = recall(index_->Query(query_dataset, search_conf, nullptr));
+    auto result = index_->Query(query_dataset, refine_conf, nullptr);
+    auto refined = recall(result);
+    std::cout << index_type_ << " recall " << unrefined << " refined " << refined << std::endl;
+    if (unrefined < 1.0f) {
+        ASSERT_GT(refined, unrefined);
+    } else {
+        ASSERT_GE(refined, unrefined);
+    }
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto distances = result->Get<float*>(milvus::knowhere::meta::DISTANCE);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_FLOAT_EQ(distances[i], faiss::fvec_L2sqr(xq.data() + i / k * dim, xb.data() + ids[i] * dim, dim));
+    }
+
+    // without raw vectors, refine_k is refused rather than ignored
+    auto plain_index = IndexFactory(index_type_, index_mode_);
+    plain_index->Train(base_dataset, conf_);
+    plain_index->AddWithoutIds(base_dataset, conf_);
+    ASSERT_ANY_THROW(plain_index->Query(query_dataset, refine_conf, nullptr));
+}
+
+TEST_P(IVFTest, ivf_prune) {
+    // the fast scan has its own list loop
+    if (index_type_ == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQFASTSCAN ||
+        index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+    auto expect = index_->Query(query_dataset, conf_, nullptr);
+
+    // with the exact list radius, only lists that cannot improve the results are skipped
+    auto prune_conf = conf_;
+    prune_conf[milvus::knowhere::IndexParams::prune_ratio] = 1.0;
+    auto result = index_->Query(query_dataset, prune_conf, nullptr);
+    auto expect_ids = expect->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto result_ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_EQ(result_ids[i], expect_ids[i]);
+    }
+
+    prune_conf[milvus::knowhere::IndexParams::prune_ratio] = 0.0;
+    result = index_->Query(query_dataset, prune_conf, nullptr);
+    AssertAnns(result, nq, k);
+
+    auto adapter = milvus::knowhere::AdapterMgr::GetInstance().GetAdapter(index_type_);
+    ASSERT_TRUE(adapter->CheckSearch(prune_conf, index_type_, index_mode_));
+    prune_conf[milvus::knowhere::IndexParams::prune_ratio] = 1.5;
+    ASSERT_FALSE(adapter->CheckSearch(prune_conf, index_type_, index_mode_));
+
+    // entries removed and added back under new ids at the same count, the radii follow both
+    std::vector<int64_t> removed(nq);
+    std::iota(removed.begin(), removed.end(), 0);
+    ASSERT_EQ(index_->Remove(removed.data(), nq), nq);
+    std::vector<int64_t> uids(nq);
+    std::iota(uids.begin(), uids.end(), nb);
+    index_->Add(query_dataset, uids.data(), conf_);
+    ASSERT_EQ(index_->Count(), nb);
+    expect = index_->Query(query_dataset, conf_, nullptr);
+    prune_conf[milvus::knowhere::IndexParams::prune_ratio] = 1.0;
+    result = index_->Query(query_dataset, prune_conf, nullptr);
+    expect_ids = expect->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    result_ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_EQ(result_ids[i], expect_ids[i]);
+    }
+    for (int64_t i = 0; i < nq; ++i) {
+        ASSERT_EQ(result_ids[i * k], nb + i);
+    }
+
+    // a loaded index computes the radii on its first pruned query
+    auto loaded = IndexFactory(index_type_, index_mode_);
+    loaded->Load(index_->Serialize(conf_));
+    expect = loaded->Query(query_dataset, conf_, nullptr);
+    result = loaded->Query(query_dataset, prune_conf, nullptr);
+    expect_ids = expect->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    result_ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_EQ(result_ids[i], expect_ids[i]);
+    }
+}
+
+TEST_P(IVFTest, ivf_list_major) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+    auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index_->index_.get());
+    ivf_index->nprobe = conf_[milvus::knowhere::IndexParams::nprobe].get<int64_t>();
+
+    // a batch large enough for every list to be probed by several queries
+    int64_t batch = 2000;
+    std::vector<float> expect_dis(batch * k), result_dis(batch * k);
+    std::vector<int64_t> expect_ids(batch * k), result_ids(batch * k);
+    ivf_index->parallel_mode = 0;
+    ivf_index->search(batch, xb.data(), k, expect_dis.data(), expect_ids.data(), nullptr);
+    ivf_index->parallel_mode = 2;
+    ivf_index->search(batch, xb.data(), k, result_dis.data(), result_ids.data(), nullptr);
+    for (int64_t i = 0; i < batch * k; ++i) {
+        // ids of equal distances may come in another order
+        ASSERT_FLOAT_EQ(result_dis[i], expect_dis[i]);
+    }
+
+    auto dataset = milvus::knowhere::GenDataset(batch, dim, xb.data());
+    auto result = index_->Query(dataset, conf_, nullptr);
+    AssertAnns(result, batch, k);
+
+    // the fast scan has its own list loop
+    if (index_type_ == milvus::knowhere::IndexEnum::INDEX_FAISS_IVFPQFASTSCAN) {
+        return;
+    }
+
+    // heaps initialized and finalized by the caller
+    using HeapForL2 = faiss::CMax<float, int64_t>;
+    for (int64_t i = 0; i < batch; ++i) {
+        faiss::heap_heapify<HeapForL2>(k, result_dis.data() + i * k, result_ids.data() + i * k);
+    }
+    ivf_index->parallel_mode = 2 | ivf_index->PARALLEL_MODE_NO_HEAP_INIT;
+    ivf_index->search(batch, xb.data(), k, result_dis.data(), result_ids.data(), nullptr);
+    for (int64_t i = 0; i < batch; ++i) {
+        faiss::heap_reorder<HeapForL2>(k, result_dis.data() + i * k, result_ids.data() + i * k);
+    }
+    for (int64_t i = 0; i < batch * k; ++i) {
+        ASSERT_FLOAT_EQ(result_dis[i], expect_dis[i]);
+    }
+
+    // range search finds the same entries in list-major order
+    float radius = expect_dis[k / 2];
+    faiss::RangeSearchResult expect_range(batch), result_range(batch);
+    ivf_index->parallel_mode = 0;
+    ivf_index->range_search(batch, xb.data(), radius, &expect_range, nullptr);
+    ivf_index->parallel_mode = 2;
+    ivf_index->range_search(batch, xb.data(), radius, &result_range, nullptr);
+    ASSERT_GT(expect_range.lims[batch], batch);
+    for (int64_t i = 0; i <= batch; ++i) {
+        ASSERT_EQ(result_range.lims[i], expect_range.lims[i]);
+    }
+    for (int64_t i = 0; i < batch; ++i) {
+        std::vector<int64_t> expect_labels(expect_range.labels + expect_range.lims[i],
+                                           expect_range.labels + expect_range.lims[i + 1]);
+        std::vector<int64_t> result_labels(result_range.labels + result_range.lims[i],
+                                           result_range.labels + result_range.lims[i + 1]);
+        std::sort(expect_labels.begin(), expect_labels.end());
+        std::sort(result_labels.begin(), result_labels.end());
+        ASSERT_EQ(result_labels, expect_labels);
+    }
+
+    // lists skipped by their radius in list-major order keep the results
+    auto prune_conf = conf_;
+    prune_conf[milvus::knowhere::IndexParams::prune_ratio] = 1.0;
+    auto pruned = index_->Query(dataset, prune_conf, nullptr);
+    auto expect_result_ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto pruned_ids = pruned->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < batch * k; ++i) {
+        ASSERT_EQ(pruned_ids[i], expect_result_ids[i]);
+    }
+}
+
+TEST_P(IVFTest, ivf_remove_and_add) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+
+    // the queries are the first nq base vectors, they no longer find themselves
+    std::vector<int64_t> removed(nq);
+    std::iota(removed.begin(), removed.end(), 0);
+    ASSERT_EQ(index_->Remove(removed.data(), nq), nq);
+    ASSERT_EQ(index_->Remove(removed.data(), nq), 0);
+    ASSERT_EQ(index_->Count(), nb - nq);
+    auto result = index_->Query(query_dataset, conf_, nullptr);
+    AssertAnns(result, nq, k, CheckMode::CHECK_NOT_EQUAL);
+
+    // the remaining entries keep their ids
+    result = index_->Query(milvus::knowhere::GenDataset(nq, dim, xb.data() + nq * dim), conf_, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq; ++i) {
+        ASSERT_EQ(ids[i * k], nq + i);
+    }
+
+    // added back to a loaded index under new ids
+    auto new_index = IndexFactory(index_type_, index_mode_);
+    new_index->Load(index_->Serialize(milvus::knowhere::Config()));
+    new_index->SetUids(index_->GetUids());
+    ASSERT_ANY_THROW(new_index->Add(query_dataset, nullptr, conf_));
+    std::vector<int64_t> uids(nq);
+    std::iota(uids.begin(), uids.end(), nb);
+    new_index->Add(query_dataset, uids.data(), conf_);
+    ASSERT_EQ(new_index->Count(), nb);
+    result = new_index->Query(query_dataset, conf_, nullptr);
+    ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq; ++i) {
+        ASSERT_EQ(ids[i * k], nb + i);
+    }
+}
+
+TEST_P(IVFTest, ivf_rebalance) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    // half as many vectors again crowd around one base vector, its list is far above the average
+    int64_t extra = nb / 2;
+    std::vector<float> skewed(xb);
+    for (int64_t i = 0; i < extra; ++i) {
+        for (int64_t j = 0; j < dim; ++j) {
+            skewed.push_back(xb[nq * dim + j] + 0.01 * drand48());
+        }
+    }
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(milvus::knowhere::GenDataset(nb + extra, dim, skewed.data()), conf_);
+
+    // the crowd shares a few PQ codes, only the raw vectors tell its members apart
+    auto index = index_;
+    if (index_type_ != milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8) {
+        auto binaryset = index_->Serialize(milvus::knowhere::Config());
+        auto raw_size = skewed.size() * sizeof(float);
+        std::shared_ptr<uint8_t[]> raw_data(new uint8_t[raw_size]);
+        memcpy(raw_data.get(), skewed.data(), raw_size);
+        binaryset.Append(RAW_DATA, raw_data, raw_size);
+        index = IndexFactory(index_type_, index_mode_);
+        index->Load(binaryset);
+    }
+
+    auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index->index_.get());
+    auto max_list_size = [&]() {
+        size_t max_size = 0;
+        for (size_t i = 0; i < ivf_index->nlist; ++i) {
+            max_size = std::max(max_size, ivf_index->invlists->list_size(i));
+        }
+        return max_size;
+    };
+    auto nlist = ivf_index->nlist;
+    auto old_max_size = max_list_size();
+    ASSERT_GT(old_max_size, static_cast<size_t>(extra));
+
+    auto ivf = std::dynamic_pointer_cast<milvus::knowhere::IVF>(index);
+    auto config = milvus::knowhere::Config();
+    config[milvus::knowhere::IndexParams::max_list_size_ratio] = 0.5;
+    ASSERT_ANY_THROW(ivf->Rebalance(config));
+    config[milvus::knowhere::IndexParams::max_list_size_ratio] = 4.0;
+    ivf->Rebalance(config);
+
+    ASSERT_GT(ivf_index->nlist, nlist);
+    ASSERT_LT(max_list_size(), old_max_size / 4);
+    ASSERT_EQ(ivf_index->invlists->compute_ntotal(), static_cast<size_t>(nb + extra));
+    ASSERT_EQ(index->Count(), nb + extra);
+    auto result = index->Query(query_dataset, conf_, nullptr);
+    AssertAnns(result, nq, k);
+}
+
+TEST_P(IVFTest, ivf_coarse_quantizer) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    auto adapter = milvus::knowhere::AdapterMgr::GetInstance().GetAdapter(index_type_);
+    for (auto type : {milvus::knowhere::CoarseQuantizerType::HNSW, milvus::knowhere::CoarseQuantizerType::IVF}) {
+        auto conf = conf_;
+        conf[milvus::knowhere::meta::ROWS] = nb;
+        conf[milvus::knowhere::IndexParams::coarse_quantizer] = type;
+        conf[milvus::knowhere::IndexParams::ef] = 64;
+        conf[milvus::knowhere::IndexParams::coarse_nprobe] = 4;
+        ASSERT_TRUE(adapter->CheckTrain(conf, index_mode_));
+        ASSERT_TRUE(adapter->CheckSearch(conf, index_type_, index_mode_));
+
+        auto index = IndexFactory(index_type_, index_mode_);
+        index->Train(base_dataset, conf);
+        index->AddWithoutIds(base_dataset, conf);
+        EXPECT_EQ(index->Count(), nb);
+        auto result = index->Query(query_dataset, conf, nullptr);
+        AssertAnns(result, nq, k);
+
+        // the quantizer is serialized with the index
+        auto binaryset = index->Serialize(milvus::knowhere::Config());
+        auto new_index = IndexFactory(index_type_, index_mode_);
+        new_index->Load(binaryset);
+        auto quantizer = dynamic_cast<faiss::IndexIVF*>(new_index->index_.get())->quantizer;
+        if (type == milvus::knowhere::CoarseQuantizerType::HNSW) {
+            ASSERT_NE(dynamic_cast<faiss::IndexHNSW*>(quantizer), nullptr);
+        } else {
+            ASSERT_NE(dynamic_cast<faiss::IndexIVF*>(quantizer), nullptr);
+        }
+        result = new_index->Query(query_dataset, conf, nullptr);
+        AssertAnns(result, nq, k);
+    }
+
+    auto conf = conf_;
+    conf[milvus::knowhere::meta::ROWS] = nb;
+    conf[milvus::knowhere::IndexParams::coarse_quantizer] = "KDTREE";
+    ASSERT_FALSE(adapter->CheckTrain(conf, index_mode_));
+}
+
+TEST_P(IVFTest, ivf_sq_quantizer_types) {
+    if (index_type_ != milvus::knowhere::IndexEnum::INDEX_FAISS_IVFSQ8 ||
+        index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    // bytes per vector of each quantizer type
+    std::vector<std::pair<std::string, int64_t>> types{
+        {milvus::knowhere::SQType::QT_8BIT_UNIFORM, dim},  {milvus::knowhere::SQType::QT_6BIT, dim * 6 / 8},
+        {milvus::knowhere::SQType::QT_4BIT, dim / 2},      {milvus::knowhere::SQType::QT_FP16, dim * 2},
+        {milvus::knowhere::SQType::QT_BF16, dim * 2},
+    };
+    auto adapter = milvus::knowhere::AdapterMgr::GetInstance().GetAdapter(index_type_);
+    for (auto& type : types) {
+        auto conf = conf_;
+        conf[milvus::knowhere::meta::ROWS] = nb;
+        conf[milvus::knowhere::IndexParams::quantizer_type] = type.first;
+        ASSERT_TRUE(adapter->CheckTrain(conf, index_mode_));
+
+        auto index = IndexFactory(index_type_, index_mode_);
+        index->Train(base_dataset, conf);
+        index->AddWithoutIds(base_dataset, conf);
+        auto ivf_index = dynamic_cast<faiss::IndexIVF*>(index->index_.get());
+        ASSERT_EQ(ivf_index->code_size, type.second);
+
+        auto binaryset = index->Serialize(milvus::knowhere::Config());
+        auto new_index = IndexFactory(index_type_, index_mode_);
+        new_index->Load(binaryset);
+        auto result = new_index->Query(query_dataset, conf, nullptr);
+        AssertAnns(result, nq, k);
+    }
+
+    auto conf = conf_;
+    conf[milvus::knowhere::meta::ROWS] = nb;
+    conf[milvus::knowhere::IndexParams::quantizer_type] = "QT_3bit";
+    ASSERT_FALSE(adapter->CheckTrain(conf, index_mode_));
+}
+
+TEST(IVFSQTest, simd_distance_kernels) {
+    std::vector<faiss::QuantizerType> qtypes{
+        faiss::QuantizerType::QT_8bit, faiss::QuantizerType::QT_8bit_uniform, faiss::QuantizerType::QT_6bit,
+        faiss::QuantizerType::QT_4bit, faiss::QuantizerType::QT_fp16,         faiss::QuantizerType::QT_bf16,
+    };
+    const int64_t n = 200;
+    // multiples of 16, of 8 only, and of neither select different kernel widths
+    for (int64_t d : {64, 40, 20}) {
+        std::vector<float> x(n * d);
+        for (auto& v : x) {
+            v = drand48() * 2 - 1;
+        }
+        for (auto qtype : qtypes) {
+            faiss::ScalarQuantizer sq(d, qtype);
+            sq.train(n, x.data());
+            std::vector<uint8_t> codes(n * sq.code_size);
+            std::unique_ptr<faiss::Quantizer> quant(faiss::sq_select_quantizer_ref(qtype, d, sq.trained));
+            for (int64_t i = 0; i < n; ++i) {
+                quant->encode_vector(x.data() + i * d, codes.data() + i * sq.code_size);
+            }
+
+            for (auto metric : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+                std::vector<std::unique_ptr<faiss::SQDistanceComputer>> dcs;
+                dcs.emplace_back(faiss::sq_get_distance_computer_ref(metric, qtype, d, sq.trained));
+                if (faiss::cpu_support_avx2()) {
+                    dcs.emplace_back(faiss::sq_get_distance_computer_avx(metric, qtype, d, sq.trained));
+                }
+                if (faiss::cpu_support_avx512()) {
+                    dcs.emplace_back(faiss::sq_get_distance_computer_avx512(metric, qtype, d, sq.trained));
+                }
+                for (auto& dc : dcs) {
+                    dc->codes = codes.data();
+                    dc->code_size = sq.code_size;
+                    dc->set_query(x.data());
+                }
+                for (int64_t i = 0; i < n; ++i) {
+                    float expect = (*dcs[0])(i);
+                    for (size_t j = 1; j < dcs.size(); ++j) {
+                        ASSERT_NEAR((*dcs[j])(i), expect, 1e-4 * std::max(1.0f, std::abs(expect)))
+                            << "qtype " << static_cast<int>(qtype) << " dim " << d << " kernel " << j;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(IVFFlatTest, batch_distance_kernels) {
+    std::vector<std::pair<faiss::fvec_batch_func_ptr, faiss::fvec_batch_func_ptr>> kernels{
+        {faiss::fvec_L2sqr_batch_ref, faiss::fvec_inner_product_batch_ref},
+        {faiss::fvec_L2sqr_batch_sse, faiss::fvec_inner_product_batch_sse},
+    };
+    if (faiss::cpu_support_avx2()) {
+        kernels.emplace_back(faiss::fvec_L2sqr_batch_avx, faiss::fvec_inner_product_batch_avx);
+    }
+    if (faiss::cpu_support_avx512()) {
+        kernels.emplace_back(faiss::fvec_L2sqr_batch_avx512, faiss::fvec_inner_product_batch_avx512);
+    }
+    // specialized dimensions, multiples of 16 or 8 only, and others; block sizes with and without a tail
+    const int64_t ny = 67;
+    for (int64_t d : {64, 128, 768, 1024, 80, 40, 20}) {
+        std::vector<float> x(d), y(ny * d), dis(ny);
+        for (auto& v : x) {
+            v = drand48() * 2 - 1;
+        }
+        for (auto& v : y) {
+            v = drand48() * 2 - 1;
+        }
+        for (int64_t n : {ny, ny - 3, int64_t(2)}) {
+            for (auto& kernel : kernels) {
+                kernel.first(dis.data(), x.data(), y.data(), d, n);
+                for (int64_t j = 0; j < n; ++j) {
+                    auto expect = faiss::fvec_L2sqr_ref(x.data(), y.data() + j * d, d);
+                    ASSERT_NEAR(dis[j], expect, 1e-4 * std::max(1.0f, expect)) << "dim " << d;
+                }
+                kernel.second(dis.data(), x.data(), y.data(), d, n);
+                for (int64_t j = 0; j < n; ++j) {
+                    auto expect = faiss::fvec_inner_product_ref(x.data(), y.data() + j * d, d);
+                    ASSERT_NEAR(dis[j], expect, 1e-4 * std::max(1.0f, std::abs(expect))) << "dim " << d;
+                }
+            }
+        }
+    }
+}
+
 // TODO(linxj): deprecated
 #ifdef KNOWHERE_GPU_VERSION
 TEST_P(IVFTest, clone_test) {
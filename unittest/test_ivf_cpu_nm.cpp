@@ -10,7 +10,9 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include <gtest/gtest.h>
+#include <numeric>
 
+#include <cstdio>
 #include <iostream>
 #include <thread>
 
@@ -18,8 +20,10 @@
 #include <faiss/gpu/GpuIndexIVFFlat.h>
 #endif
 
+#include "knowhere/archive/KnowhereConfig.h"
 #include "knowhere/common/Exception.h"
 #include "knowhere/common/Timer.h"
+#include "knowhere/common/Utils.h"
 #include "knowhere/index/IndexType.h"
 #include "knowhere/index/vector_index/adapter/VectorAdapter.h"
 #include "knowhere/index/vector_offset_index/IndexIVF_NM.h"
@@ -53,6 +57,7 @@ class IVFNMCPUTest : public DataGen,
 
     void
     TearDown() override {
+        RemoveTempFiles();
 #ifdef KNOWHERE_GPU_VERSION
         milvus::knowhere::FaissGpuResourceMgr::GetInstance().Free();
 #endif
@@ -158,3 +163,134 @@ TEST_P(IVFNMCPUTest, ivf_slice) {
     auto result = index_->Query(query_dataset, conf_, nullptr);
     AssertAnns(result, nq, k);
 }
+
+TEST_P(IVFNMCPUTest, ivf_arranged_data) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    // added in two batches, the second one extends the arranged data of the first
+    conf_[milvus::knowhere::IndexParams::save_arranged_data] = true;
+    index_->Train(base_dataset, conf_);
+    auto half = nb / 2;
+    index_->AddWithoutIds(milvus::knowhere::GenDataset(half, dim, xb.data()), conf_);
+    index_->AddWithoutIds(milvus::knowhere::GenDataset(nb - half, dim, xb.data() + half * dim), conf_);
+    auto result = index_->Query(query_dataset, conf_, nullptr);
+    AssertAnns(result, nq, k);
+
+    // loads without RAW_DATA, straight from a file mapping
+    conf_.erase(milvus::knowhere::INDEX_FILE_SLICE_SIZE_IN_MEGABYTE);
+    auto bs = index_->Serialize(conf_);
+    ASSERT_TRUE(bs.Contains(ARRANGED_DATA));
+    std::string path = TempFile("knowhere_ivf_nm_arranged");
+    milvus::knowhere::WriteBinarySet(path, bs);
+    auto mapped_bs = milvus::knowhere::MapBinarySet(path);
+    auto loaded = std::make_shared<milvus::knowhere::IVF_NM>();
+    loaded->Load(mapped_bs);
+    std::remove(path.c_str());
+
+    auto loaded_result = loaded->Query(query_dataset, conf_, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    auto loaded_ids = loaded_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_EQ(loaded_ids[i], ids[i]);
+    }
+
+    auto raw_data = loaded->GetRawData();
+    ASSERT_EQ(raw_data->size, nb * dim * sizeof(float));
+    ASSERT_EQ(memcmp(raw_data->data.get(), xb.data(), raw_data->size), 0);
+
+    // under a payload policy the arranged data is copied out of the binary, which can go away
+    milvus::engine::KnowhereConfig::SetPayloadMemory(milvus::engine::KnowhereConfig::HugePageType::TRANSPARENT);
+    auto placed = std::make_shared<milvus::knowhere::IVF_NM>();
+    placed->Load(bs);
+    milvus::engine::KnowhereConfig::SetPayloadMemory(milvus::engine::KnowhereConfig::HugePageType::NONE);
+    bs.binary_map_.clear();
+    auto placed_result = placed->Query(query_dataset, conf_, nullptr);
+    auto placed_ids = placed_result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq * k; ++i) {
+        ASSERT_EQ(placed_ids[i], ids[i]);
+    }
+    ASSERT_EQ(placed->GetPayloadPlacement().bytes, nb * dim * sizeof(float));
+
+    // not requested, nothing extra is written
+    conf_.erase(milvus::knowhere::IndexParams::save_arranged_data);
+    ASSERT_FALSE(loaded->Serialize(conf_).Contains(ARRANGED_DATA));
+}
+
+TEST_P(IVFNMCPUTest, ivf_remove_and_add) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    conf_[milvus::knowhere::IndexParams::save_arranged_data] = true;
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+
+    // the queries are the first nq base vectors, they no longer find themselves
+    std::vector<int64_t> removed(nq);
+    std::iota(removed.begin(), removed.end(), 0);
+    ASSERT_EQ(index_->Remove(removed.data(), nq), nq);
+    ASSERT_EQ(index_->Count(), nb - nq);
+    auto result = index_->Query(query_dataset, conf_, nullptr);
+    AssertAnns(result, nq, k, CheckMode::CHECK_NOT_EQUAL);
+
+    // the arranged data follows, vectors are restored in their new offset order
+    auto raw_data = index_->GetRawData();
+    ASSERT_EQ(raw_data->size, (nb - nq) * dim * sizeof(float));
+    ASSERT_EQ(memcmp(raw_data->data.get(), xb.data() + nq * dim, raw_data->size), 0);
+
+    // added back to a loaded index under new ids
+    conf_.erase(milvus::knowhere::INDEX_FILE_SLICE_SIZE_IN_MEGABYTE);
+    auto loaded = std::make_shared<milvus::knowhere::IVF_NM>();
+    loaded->Load(index_->Serialize(conf_));
+    loaded->SetUids(index_->GetUids());
+    std::vector<int64_t> uids(nq);
+    std::iota(uids.begin(), uids.end(), nb);
+    loaded->Add(query_dataset, uids.data(), conf_);
+    ASSERT_EQ(loaded->Count(), nb);
+    result = loaded->Query(query_dataset, conf_, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq; ++i) {
+        ASSERT_EQ(ids[i * k], nb + i);
+    }
+}
+
+TEST_P(IVFNMCPUTest, ivf_remove_with_raw_data) {
+    if (index_mode_ != milvus::knowhere::IndexMode::MODE_CPU) {
+        return;
+    }
+
+    // built without the arranged data, nothing could read the entries left back
+    index_->Train(base_dataset, conf_);
+    index_->AddWithoutIds(base_dataset, conf_);
+    std::vector<int64_t> removed(nq);
+    std::iota(removed.begin(), removed.end(), 0);
+    ASSERT_ANY_THROW(index_->Remove(removed.data(), nq));
+
+    // loaded from the host's RAW_DATA, which no longer follows the offsets once entries are removed
+    conf_.erase(milvus::knowhere::INDEX_FILE_SLICE_SIZE_IN_MEGABYTE);
+    auto binaryset = index_->Serialize(conf_);
+    auto raw = std::make_shared<milvus::knowhere::Binary>();
+    raw->data = std::shared_ptr<uint8_t[]>(reinterpret_cast<uint8_t*>(xb.data()), [](uint8_t*) {});
+    raw->size = nb * dim * sizeof(float);
+    binaryset.Append(RAW_DATA, raw);
+    auto loaded = std::make_shared<milvus::knowhere::IVF_NM>();
+    loaded->Load(binaryset);
+    ASSERT_EQ(loaded->Remove(removed.data(), nq), nq);
+
+    // so the arranged data is written without being asked for, and read instead of RAW_DATA
+    auto compacted_set = loaded->Serialize(conf_);
+    ASSERT_TRUE(compacted_set.Contains(ARRANGED_DATA));
+    auto reloaded = std::make_shared<milvus::knowhere::IVF_NM>();
+    reloaded->Load(compacted_set);
+    reloaded->SetUids(loaded->GetUids());
+    auto rest = milvus::knowhere::GenDataset(nq, dim, xb.data() + nq * dim);
+    auto result = reloaded->Query(rest, conf_, nullptr);
+    auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+    for (int64_t i = 0; i < nq; ++i) {
+        ASSERT_EQ(ids[i * k], nq + i);
+    }
+    auto raw_data = reloaded->GetRawData();
+    ASSERT_EQ(memcmp(raw_data->data.get(), xb.data() + nq * dim, raw_data->size), 0);
+}
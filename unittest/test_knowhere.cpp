@@ -39,6 +39,9 @@ TEST_F(KnowhereTest, KNOWHERE_RESOURCE_TEST) {
 
     KnowhereConfig::SetStatisticsLevel(0);
 
+    KnowhereConfig::SetPayloadMemory(KnowhereConfig::HugePageType::TRANSPARENT, 0);
+    KnowhereConfig::SetPayloadMemory(KnowhereConfig::HugePageType::NONE);
+
     KnowhereConfig::SetLogHandler();
 
 #ifdef KNOWHERE_GPU_VERSION
@@ -126,6 +126,32 @@ TEST_F(NSGInterfaceTest, basic_test) {
     ASSERT_EQ(index_->Dim(), dim);
 }
 
+TEST_F(NSGInterfaceTest, query_with_context_test) {
+    train_conf[milvus::knowhere::meta::DEVICEID] = -1;
+    index_->BuildAll(base_dataset, train_conf);
+    milvus::knowhere::BinarySet bs = index_->Serialize(search_conf);
+
+    auto raw_data = base_dataset->Get<const void*>(milvus::knowhere::meta::TENSOR);
+    milvus::knowhere::BinaryPtr bptr = std::make_shared<milvus::knowhere::Binary>();
+    bptr->data = std::shared_ptr<uint8_t[]>((uint8_t*)raw_data, [&](uint8_t*) {});
+    bptr->size = dim * nb * sizeof(float);
+    bs.Append(RAW_DATA, bptr);
+    index_->Load(bs);
+
+    std::vector<int64_t> ids(nq * k), ctx_ids(nq * k);
+    std::vector<float> distances(nq * k), ctx_distances(nq * k);
+    index_->QueryInto(xq.data(), nq, k, distances.data(), ids.data(), search_conf, nullptr);
+
+    // the entry candidates are drawn at random, so only the nearest neighbor is compared
+    milvus::knowhere::SearchContext ctx;
+    for (int round = 0; round < 2; ++round) {
+        index_->QueryWithContext(xq.data(), nq, k, ctx_distances.data(), ctx_ids.data(), search_conf, nullptr, ctx);
+        for (int64_t i = 0; i < nq; ++i) {
+            ASSERT_EQ(ctx_ids[i * k], ids[i * k]);
+        }
+    }
+}
+
 TEST_F(NSGInterfaceTest, compare_test) {
     milvus::knowhere::impl::DistanceL2 distanceL2;
     milvus::knowhere::impl::DistanceIP distanceIP;
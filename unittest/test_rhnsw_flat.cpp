@@ -15,6 +15,7 @@
 #include <iostream>
 #include <random>
 #include "knowhere/common/Exception.h"
+#include "unittest/Helper.h"
 #include "unittest/utils.h"
 
 using ::testing::Combine;
@@ -118,6 +119,35 @@ TEST_P(RHNSWFlatTest, HNSW_delete) {
     */
 }
 
+TEST_P(RHNSWFlatTest, HNSW_filtered) {
+    index_->Train(base_dataset, conf);
+    index_->AddWithoutIds(base_dataset, conf);
+
+    // walked two hops at a time with 2000 entries left, scanned with 200
+    auto search_conf = conf;
+    search_conf[milvus::knowhere::IndexParams::ef] = 16;
+    int64_t nq_recall = 100;
+    auto queries = milvus::knowhere::GenDataset(nq_recall, dim, xb.data());
+    std::mt19937 rng(42);
+    for (double ratio : {0.8, 0.98}) {
+        auto bitset = std::make_shared<faiss::ConcurrentBitset>(nb);
+        for (int64_t i = 0; i < nb; ++i) {
+            if (std::uniform_real_distribution<double>(0, 1)(rng) < ratio) {
+                bitset->set(i);
+            }
+        }
+
+        auto result = index_->Query(queries, search_conf, bitset);
+        auto ids = result->Get<int64_t*>(milvus::knowhere::meta::IDS);
+        for (int64_t i = 0; i < nq_recall * k; ++i) {
+            ASSERT_TRUE(ids[i] >= 0 && !bitset->test(ids[i]));
+        }
+        auto recall = FilteredBaseRecall(xb.data(), nb, dim, ids, nq_recall, k, bitset);
+        std::cout << "filtered " << ratio << " recall " << recall << std::endl;
+        ASSERT_GE(recall, ratio < 0.95 ? 0.9 : 1.0);
+    }
+}
+
 TEST_P(RHNSWFlatTest, HNSW_serialize) {
     auto serialize = [](const std::string& filename, milvus::knowhere::BinaryPtr& bin, uint8_t* ret) {
         {
@@ -14,7 +14,9 @@
 
 #include <gtest/gtest.h>
 #include <math.h>
+#include <unistd.h>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -33,6 +35,26 @@ DataGen::Init_with_default(const bool is_binary) {
     Generate(dim, nb, nq, is_binary);
 }
 
+std::string
+DataGen::TempFile(const std::string& prefix) {
+    std::string path = "/tmp/" + prefix + "_XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        throw std::runtime_error("mkstemp failed for " + path);
+    }
+    close(fd);
+    temp_files.push_back(path);
+    return path;
+}
+
+void
+DataGen::RemoveTempFiles() {
+    for (auto& path : temp_files) {
+        std::remove(path.c_str());
+    }
+    temp_files.clear();
+}
+
 void
 DataGen::Generate(const int dim, const int nb, const int nq, const bool is_binary) {
     this->dim = dim;
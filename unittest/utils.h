@@ -36,6 +36,13 @@ class DataGen {
     void
     Generate(const int dim, const int nb, const int nq, const bool is_binary = false);
 
+    // unique file under /tmp, created by mkstemp and deleted by RemoveTempFiles from the fixture's TearDown
+    std::string
+    TempFile(const std::string& prefix);
+
+    void
+    RemoveTempFiles();
+
  protected:
     int nb = 10000;
     int nq = 10;
@@ -53,6 +60,7 @@ class DataGen {
     milvus::knowhere::DatasetPtr query_dataset = nullptr;
     milvus::knowhere::DatasetPtr id_dataset = nullptr;
     milvus::knowhere::DatasetPtr xid_dataset = nullptr;
+    std::vector<std::string> temp_files;
 };
 
 extern void